@@ -28,10 +28,10 @@ operator<<(std::ostream& out, const Accessibility& acc)
 			out <<' ' << edPlaceholder << delimiter;
 		}
 		// print first (without delimiter)
-		out <<acc.getED(i, i);
+		out <<E_2_Ekcal(acc.getED(i, i));
 		// print remaining with delimiter
 		for (size_t j=i+1; j<std::min(acc.getMaxLength()+i,acc.getSequence().size());j++) {
-			out <<delimiter <<(acc.getED(i, j)>=0?" ":"") <<acc.getED(i, j);
+			out <<delimiter <<(acc.getED(i, j)>=0?" ":"") <<E_2_Ekcal(acc.getED(i, j));
 		}
 		out <<"\n";
 	}
@@ -48,7 +48,7 @@ operator<<(std::ostream& out, const Accessibility& acc)
 
 void
 Accessibility::
-writeRNAplfold_text( std::ostream& out, const E_type RT, const bool writeProbs ) const
+writeRNAplfold_text( std::ostream& out, const Ekcal_type RT, const bool writeProbs ) const
 {
 	// store current flags
 	std::ios_base::fmtflags oldFlags = out.flags();
@@ -85,7 +85,7 @@ writeRNAplfold_text( std::ostream& out, const E_type RT, const bool writeProbs )
 					out <<0 <<'\t';
 				} else {
 					// compute unpaired probability
-					double value = ( std::exp( - getED(j+1-l, j) / RT ) );
+					double value = ( std::exp( - E_2_Ekcal(getED(j+1-l, j)) / RT ) );
 					// check for nan result of conversion
 					if ( value != value ) {
 						out <<0 <<'\t';
@@ -96,7 +96,7 @@ writeRNAplfold_text( std::ostream& out, const E_type RT, const bool writeProbs )
 				}
 			} else {
 				// write ED value (ensure not printing infinity)
-				out <<std::min<E_type>( std::numeric_limits<E_type>::max(), getED(j+1-l, j) ) <<'\t';
+				out <<std::min<Ekcal_type>( std::numeric_limits<Ekcal_type>::max(), E_2_Ekcal(getED(j+1-l, j)) ) <<'\t';
 			}
 		}
 		// print NA for remaining entries
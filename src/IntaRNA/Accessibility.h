@@ -97,7 +97,7 @@ public:
 	 *        ED to Pu :  Pu = exp( -ED/RT )
 	 */
 	void
-	writeRNAplfold_Pu_text( std::ostream& out, const E_type RT ) const;
+	writeRNAplfold_Pu_text( std::ostream& out, const Ekcal_type RT ) const;
 
 	/**
 	 * Writes the ED values in RNAplfold style to stream.
@@ -149,7 +149,7 @@ protected:
 	 * @param writeProbs (true) write unpaired probabilities; (false) write ED
 	 */
 	void
-	writeRNAplfold_text( std::ostream& out, const E_type RT, const bool writeProbs ) const;
+	writeRNAplfold_text( std::ostream& out, const Ekcal_type RT, const bool writeProbs ) const;
 
 };
 
@@ -239,7 +239,7 @@ writeRNAplfold_ED_text( std::ostream& out ) const
 inline
 void
 Accessibility::
-writeRNAplfold_Pu_text( std::ostream& out, const E_type RT ) const
+writeRNAplfold_Pu_text( std::ostream& out, const Ekcal_type RT ) const
 {
 	writeRNAplfold_text( out, RT, true );
 }
@@ -10,15 +10,15 @@ namespace IntaRNA {
 
 AccessibilityBasePair::AccessibilityBasePair(const RnaSequence& seq,
     const size_t maxLength, const AccessibilityConstraint * const accConstr_,
-    const E_type bpEnergy, const E_type _RT) :
+    const Ekcal_type bpEnergy, const Ekcal_type _RT) :
       Accessibility(seq, maxLength, accConstr_),
       N(seq.size()),
       logPu(seq.size(), seq.size()),
       basePairEnergy(bpEnergy),
       RT(_RT)
 {
-  E2dMatrix Q(N, N);
-  E2dMatrix Qb(N, N);
+  Z2dMatrix Q(N, N);
+  Z2dMatrix Qb(N, N);
   P2dMatrix Ppb(N, N);
   P2dMatrix Pu(N, N);
 
@@ -34,7 +34,7 @@ AccessibilityBasePair::AccessibilityBasePair(const RnaSequence& seq,
   }
   for (size_t i = 0u; i < N; ++i) {
     for (size_t j = i; j < N; ++j) {
-      logPu(i, j) = -RT * std::log(getPu(i, j, Q, Qb, Ppb, Pu));
+      logPu(i, j) = Ekcal_2_E( -RT * std::log(getPu(i, j, Q, Qb, Ppb, Pu)) );
     }
   }
 
@@ -62,14 +62,14 @@ AccessibilityBasePair::getED( const size_t from, const size_t to ) const
 /////////////////////////////////////////////////////////////////////////////
 
 
-E_type
+Z_type
 AccessibilityBasePair::getQ(const size_t i, const size_t j,
-    AccessibilityBasePair::E2dMatrix &Q, AccessibilityBasePair::E2dMatrix &Qb)
+    AccessibilityBasePair::Z2dMatrix &Q, AccessibilityBasePair::Z2dMatrix &Qb)
 {
   if (i > j || i < 0 || j >= N || i + minLoopLength >= j) {
     return 1.0;
   }
-  E_type &ret = Q(i, j);
+  Z_type &ret = Q(i, j);
   if (ret > -0.5) {
     return ret;
   }
@@ -83,14 +83,14 @@ AccessibilityBasePair::getQ(const size_t i, const size_t j,
 /////////////////////////////////////////////////////////////////////////////
 
 
-E_type
+Z_type
 AccessibilityBasePair::getQb(const size_t i, const size_t j,
-    AccessibilityBasePair::E2dMatrix &Q, AccessibilityBasePair::E2dMatrix &Qb)
+    AccessibilityBasePair::Z2dMatrix &Q, AccessibilityBasePair::Z2dMatrix &Qb)
 {
   if (i > j || i < 0 || j >= N || i + minLoopLength >= j) {
     return 0.0;
   }
-  E_type &ret = Qb(i, j);
+  Z_type &ret = Qb(i, j);
   if (ret > -0.5) {
     return ret;
   }
@@ -107,7 +107,7 @@ AccessibilityBasePair::getQb(const size_t i, const size_t j,
 
 AccessibilityBasePair::P_type
 AccessibilityBasePair::getPbp(const size_t i, const size_t j,
-    AccessibilityBasePair::E2dMatrix &Q, AccessibilityBasePair::E2dMatrix &Qb,
+    AccessibilityBasePair::Z2dMatrix &Q, AccessibilityBasePair::Z2dMatrix &Qb,
     AccessibilityBasePair::P2dMatrix &Ppb)
 {
   if (i > j || i < 0 || j >= N || i + minLoopLength >= j) {
@@ -140,7 +140,7 @@ AccessibilityBasePair::getPbp(const size_t i, const size_t j,
 
 AccessibilityBasePair::P_type
 AccessibilityBasePair::getPu(const size_t i, const size_t j,
-    AccessibilityBasePair::E2dMatrix &Q, AccessibilityBasePair::E2dMatrix &Qb,
+    AccessibilityBasePair::Z2dMatrix &Q, AccessibilityBasePair::Z2dMatrix &Qb,
     AccessibilityBasePair::P2dMatrix &Pbp, AccessibilityBasePair::P2dMatrix &Pu)
 {
   if (i > j || i < 0 || j >= N || i + minLoopLength >= j) {
@@ -19,7 +19,7 @@ class AccessibilityBasePair: public Accessibility {
 protected:
 
 	//! Probability type
-	typedef E_type P_type;
+	typedef Z_type P_type;
 
 	//! Probability matrix
 	typedef boost::numeric::ublas::matrix<P_type> P2dMatrix;
@@ -27,6 +27,9 @@ protected:
 	//! Energy matrix
 	typedef boost::numeric::ublas::matrix<E_type> E2dMatrix;
 
+	//! Partition function matrix
+	typedef boost::numeric::ublas::matrix<Z_type> Z2dMatrix;
+
 public:
 
 	/***
@@ -36,15 +39,15 @@ public:
 	 *          considered. 0 defaults to the full sequence's length, otherwise
 	 *          is is internally set to min(maxLength,seq.length).
 	 * @param accConstr optional accessibility constraint
-	 * @param basePairEnergy The energy value of the base pairs
-	 * @param RT The temperature energy constant
+	 * @param basePairEnergy The energy value of the base pairs (kcal/mol)
+	 * @param RT The temperature energy constant (kcal/mol)
 	 */
 	AccessibilityBasePair(
 			  const RnaSequence& seq
 			, const size_t maxLength
 			, const AccessibilityConstraint * const accConstr
-			, const E_type basePairEnergy = -1
-			, const E_type RT = 1
+			, const Ekcal_type basePairEnergy = -1
+			, const Ekcal_type RT = 1
 			);
 
 	/***
@@ -67,11 +70,11 @@ public:
 protected:
 
 	//! energy of an individual base pair
-	const E_type basePairEnergy;
+	const Ekcal_type basePairEnergy;
 	//! temperature constant for normalization
-	const E_type RT;
+	const Ekcal_type RT;
 
-	const E_type weightPerBP = std::exp(-basePairEnergy / RT);
+	const Z_type weightPerBP = std::exp(-basePairEnergy / RT);
 	//! minimal number of unpaired bases enclosed by a base pair
 	const size_t minLoopLength = 3;
 	//! length of the sequence
@@ -90,8 +93,8 @@ protected:
    * @param Qb Lookup table for Qb
    * @returns the partition function value
    */
-  E_type getQ(const size_t from, const size_t to,
-      E2dMatrix &Q, E2dMatrix &Qb);
+  Z_type getQ(const size_t from, const size_t to,
+      Z2dMatrix &Q, Z2dMatrix &Qb);
 
   /***
    * Get the base partition function Qb between the indices (from, to)
@@ -101,8 +104,8 @@ protected:
    * @param Qb Lookup table for Qb
    * @returns the partition function value
    */
-  E_type getQb(const size_t from, const size_t to,
-      E2dMatrix &Q, E2dMatrix &Qb);
+  Z_type getQb(const size_t from, const size_t to,
+      Z2dMatrix &Q, Z2dMatrix &Qb);
 
   /***
    * Get the base-pair probbility between the indices (from, to)
@@ -114,7 +117,7 @@ protected:
    * @returns the probability value
    */
   P_type getPbp(const size_t from, const size_t to,
-      E2dMatrix &Q, E2dMatrix &Qb, P2dMatrix &Ppb);
+      Z2dMatrix &Q, Z2dMatrix &Qb, P2dMatrix &Ppb);
 
   /***
    * Get the unpaired probbility between the indices (from, to)
@@ -126,7 +129,7 @@ protected:
    * @param Pu Lookup table for unpaired probabilities
    * @returns the probability value
    */
-  P_type getPu(const size_t from, const size_t to, E2dMatrix &Q, E2dMatrix &Qb,
+  P_type getPu(const size_t from, const size_t to, Z2dMatrix &Q, Z2dMatrix &Qb,
       P2dMatrix &Ppb, P2dMatrix &Pu);
 
 };
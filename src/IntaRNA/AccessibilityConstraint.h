@@ -237,6 +237,10 @@ AccessibilityConstraint( const std::string& dotBracket, const size_t maxBpSpan_
 	screenDotBracket( dotBracket, dotBracket_blocked, blocked );
 	// screen for accessible regions
 	screenDotBracket( dotBracket, dotBracket_accessible, accessible );
+
+	// positions are checked individually during accessibility computation
+	blocked.enableDenseLookup();
+	accessible.enableDenseLookup();
 }
 
 ////////////////////////////////////////////////////////////////////////
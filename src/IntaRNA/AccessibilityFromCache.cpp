@@ -0,0 +1,188 @@
+
+#include "IntaRNA/AccessibilityFromCache.h"
+
+#include <cstring>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include <boost/filesystem.hpp>
+
+namespace IntaRNA {
+
+/////////////////////////////////////////////////////////////////////////
+
+// "IntaRNA" + format version 1
+const boost::uint64_t AccessibilityFromCache::magicNumber = 0x31414E5261746E49ull;
+
+#if INTARNA_INTEGER_ENERGY
+const boost::uint64_t AccessibilityFromCache::energyEncoding = 0x100 + sizeof(E_type);
+#else
+const boost::uint64_t AccessibilityFromCache::energyEncoding = sizeof(E_type);
+#endif
+
+/////////////////////////////////////////////////////////////////////////
+
+AccessibilityFromCache::
+AccessibilityFromCache(
+		const RnaSequence& sequence
+		, const size_t maxLength
+		, const AccessibilityConstraint * const accConstraint
+		, const std::string & cacheFile
+		, const std::string & key
+		)
+ :	Accessibility( sequence, maxLength, accConstraint )
+	, cacheMapping()
+	, cacheRegion()
+	, edValues(NULL)
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"mapping accessibility values from cache file '"<<cacheFile<<"'..."; }
+
+	if (!isValidCache( cacheFile, key, getSequence().size(), getMaxLength() )) {
+		throw std::runtime_error("AccessibilityFromCache() : cache file '"+cacheFile+"' does not fit the sequence '"+getSequence().getId()+"'");
+	}
+
+	// map the whole file read-only
+	cacheMapping = boost::interprocess::file_mapping( cacheFile.c_str(), boost::interprocess::read_only );
+	cacheRegion = boost::interprocess::mapped_region( cacheMapping, boost::interprocess::read_only );
+
+	// check file size
+	const size_t dataOffset = getDataOffset( key.size() );
+	if (cacheRegion.get_size() < dataOffset + getSequence().size()*getMaxLength()*sizeof(E_type)) {
+		throw std::runtime_error("AccessibilityFromCache() : cache file '"+cacheFile+"' is truncated");
+	}
+
+	// set data pointer
+	edValues = reinterpret_cast<const E_type*>( static_cast<const char*>(cacheRegion.get_address()) + dataOffset );
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+AccessibilityFromCache::
+~AccessibilityFromCache()
+{
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+size_t
+AccessibilityFromCache::
+getDataOffset( const size_t keyLength )
+{
+	// header fields + key padded to 8 byte alignment
+	return 5*sizeof(boost::uint64_t) + ((keyLength+7)/8)*8;
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+std::string
+AccessibilityFromCache::
+getCacheFileName( const std::string & cacheDir, const std::string & key )
+{
+	// FNV-1a hash of the key (platform independent in contrast to std::hash)
+	boost::uint64_t hash = 0xcbf29ce484222325ull;
+	for (std::string::const_iterator c = key.begin(); c != key.end(); c++) {
+		hash ^= (boost::uint64_t)(unsigned char)(*c);
+		hash *= 0x100000001b3ull;
+	}
+	std::stringstream fileName;
+	fileName <<std::hex <<std::setw(16) <<std::setfill('0') <<hash <<".ed";
+	return (boost::filesystem::path(cacheDir) / fileName.str()).string();
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+bool
+AccessibilityFromCache::
+isValidCache( const std::string & cacheFile
+			, const std::string & key
+			, const size_t seqLength
+			, const size_t maxLength )
+{
+	std::ifstream in( cacheFile.c_str(), std::ios::in | std::ios::binary );
+	if (!in.good()) {
+		return false;
+	}
+	// read header
+	boost::uint64_t header[5];
+	if (!in.read( reinterpret_cast<char*>(header), sizeof(header) )) {
+		return false;
+	}
+	if ( header[0] != magicNumber
+		|| header[1] != energyEncoding
+		|| header[2] != key.size()
+		|| header[3] != seqLength
+		|| header[4] != maxLength )
+	{
+		return false;
+	}
+	// compare key
+	std::vector<char> fileKey( key.size() );
+	if (!key.empty() && !in.read( &(fileKey[0]), fileKey.size() )) {
+		return false;
+	}
+	return key.empty() || std::memcmp( &(fileKey[0]), key.c_str(), key.size() ) == 0;
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+void
+AccessibilityFromCache::
+writeCache( const Accessibility & acc
+			, const std::string & cacheFile
+			, const std::string & key )
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"writing accessibility values to cache file '"<<cacheFile<<"'..."; }
+
+	// write to unique temporary file first
+	const std::string tmpFile = cacheFile + boost::filesystem::unique_path(".%%%%-%%%%-%%%%").string();
+	std::ofstream out( tmpFile.c_str(), std::ios::out | std::ios::binary | std::ios::trunc );
+	if (!out.good()) {
+		throw std::runtime_error("AccessibilityFromCache::writeCache() : could not open file '"+tmpFile+"'");
+	}
+
+	const size_t seqLength = acc.getSequence().size();
+	const size_t maxLength = acc.getMaxLength();
+
+	// write header
+	const boost::uint64_t header[5] = { magicNumber, energyEncoding, key.size(), seqLength, maxLength };
+	out.write( reinterpret_cast<const char*>(header), sizeof(header) );
+	// write key and padding
+	out.write( key.c_str(), key.size() );
+	const char padding[8] = {0,0,0,0,0,0,0,0};
+	out.write( padding, getDataOffset(key.size()) - sizeof(header) - key.size() );
+
+	// write ED values row-wise
+	std::vector<E_type> row( maxLength, ED_UPPER_BOUND );
+	for (size_t i=0; i<seqLength; i++) {
+		for (size_t l=0; l<maxLength; l++) {
+			row[l] = (i+l < seqLength) ? acc.getED( i, i+l ) : ED_UPPER_BOUND;
+		}
+		out.write( reinterpret_cast<const char*>(&(row[0])), maxLength*sizeof(E_type) );
+	}
+	out.close();
+	if (out.fail()) {
+		std::remove( tmpFile.c_str() );
+		throw std::runtime_error("AccessibilityFromCache::writeCache() : could not write file '"+tmpFile+"'");
+	}
+
+	// move to final destination
+	boost::system::error_code ec;
+	boost::filesystem::rename( tmpFile, cacheFile, ec );
+	if (ec) {
+		std::remove( tmpFile.c_str() );
+		throw std::runtime_error("AccessibilityFromCache::writeCache() : could not create file '"+cacheFile+"' : "+ec.message());
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,185 @@
+
+#ifndef INTARNA_ACCESSIBILITYFROMCACHE_H_
+#define INTARNA_ACCESSIBILITYFROMCACHE_H_
+
+#include "IntaRNA/Accessibility.h"
+
+#include <string>
+
+#include <boost/cstdint.hpp>
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+namespace IntaRNA {
+
+/**
+ * Provides accessibility data from a binary cache file that is memory mapped
+ * such that no ED value has to be parsed or copied.
+ *
+ * A cache file is identified by a key string that has to encode all data the
+ * ED values depend on (sequence, energy model, folding parameters, ..).
+ * The file name is derived from a hash of the key while the key itself is
+ * stored within the file for verification.
+ *
+ * Cache file layout (native byte order and E_type encoding) :
+ *  - magic number
+ *  - energy encoding (size of E_type in bytes, +256 for integer energies)
+ *  - length of the key string
+ *  - sequence length n
+ *  - maximal length of accessible regions m
+ *  - key string (padded to 8 bytes)
+ *  - n*m E_type ED values, where ED(i,i+l) is stored at position i*m+l
+ *
+ */
+class AccessibilityFromCache: public Accessibility
+{
+public:
+
+	/**
+	 * construction by memory mapping the given cache file
+	 *
+	 * @param sequence the sequence the accessibility data is about
+	 * @param maxLength the maximal length of accessible regions (>0) to be
+	 *          considered. 0 defaults to the full sequence's length, otherwise
+	 *          is is internally set to min(maxLength,seq.length).
+	 * @param accConstraint if not NULL, accessibility constraint that enforces some regions
+	 *        to be unstructured both in sequence and interaction
+	 * @param cacheFile the name of the cache file to map
+	 * @param key the key string the cache file has to be generated for
+	 *
+	 * @throw std::runtime_error if the cache file could not be mapped or
+	 *        does not fit the key or the sequence
+	 */
+	AccessibilityFromCache(
+			const RnaSequence& sequence
+			, const size_t maxLength
+			, const AccessibilityConstraint * const accConstraint
+			, const std::string & cacheFile
+			, const std::string & key
+			);
+
+	/**
+	 * destruction
+	 */
+	virtual ~AccessibilityFromCache();
+
+	/**
+	 * Returns the accessibility energy value for the given range in the
+	 * sequence, i.e. the energy difference (ED) to make the region accessible.
+	 *
+	 * @param from the start index of the regions (from <= to)
+	 * @param to the end index of the regions (to < seq.length)
+	 *
+	 * @return the ED value if (j-1+1) <= maxLength or ED_UPPER_BOUND otherwise
+	 *
+	 * @throw std::runtime_error in case it does not hold 0 <= from <= to < seq.length
+	 */
+	virtual
+	E_type
+	getED( const size_t from, const size_t to ) const;
+
+	/**
+	 * Provides the name of the cache file for the given key within the
+	 * given cache directory.
+	 *
+	 * @param cacheDir the cache directory
+	 * @param key the key string identifying the accessibility data
+	 * @return the cache file name for the key
+	 */
+	static
+	std::string
+	getCacheFileName( const std::string & cacheDir, const std::string & key );
+
+	/**
+	 * Checks whether or not the given cache file exists and was generated
+	 * for the given key and sequence length.
+	 *
+	 * @param cacheFile the name of the cache file to check
+	 * @param key the key string the cache file has to be generated for
+	 * @param seqLength the length of the sequence
+	 * @param maxLength the maximal length of accessible regions
+	 * @return true if the cache file can be used; false otherwise
+	 */
+	static
+	bool
+	isValidCache( const std::string & cacheFile
+				, const std::string & key
+				, const size_t seqLength
+				, const size_t maxLength );
+
+	/**
+	 * Writes the ED values of the given accessibility object to a cache file.
+	 * The file is first written to a temporary file that is renamed afterwards
+	 * to avoid concurrent readers of incomplete files.
+	 *
+	 * @param acc the accessibility data to store
+	 * @param cacheFile the name of the cache file to write
+	 * @param key the key string identifying the accessibility data
+	 *
+	 * @throw std::runtime_error if the cache file could not be written
+	 */
+	static
+	void
+	writeCache( const Accessibility & acc
+				, const std::string & cacheFile
+				, const std::string & key );
+
+protected:
+
+	//! magic number identifying cache files
+	static const boost::uint64_t magicNumber;
+
+	//! encoding of the stored E_type values (size and integer/floating point)
+	static const boost::uint64_t energyEncoding;
+
+	//! the memory mapped cache file
+	boost::interprocess::file_mapping cacheMapping;
+
+	//! the mapped region of the cache file
+	boost::interprocess::mapped_region cacheRegion;
+
+	//! pointer to the first ED value within the mapped region
+	const E_type * edValues;
+
+	/**
+	 * Provides the offset of the ED values within a cache file.
+	 * @param keyLength the length of the key string stored in the file
+	 * @return the byte offset of the first ED value
+	 */
+	static
+	size_t
+	getDataOffset( const size_t keyLength );
+
+};
+
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+AccessibilityFromCache::
+getED( const size_t from, const size_t to ) const
+{
+	// input range check
+	checkIndices(from,to);
+
+	if ((to-from+1) <= getMaxLength()) {
+		// check for constrained positions within region
+		if (!getAccConstraint().isAccessible(from,to)) {
+			// position covers a blocked position --> omit accessibility
+			return ED_UPPER_BOUND;
+		}
+		// return according ED value from the mapped cache file
+		return edValues[ from*getMaxLength() + (to-from) ];
+	} else {
+		// region length exceeds maximally allowed length -> no value
+		return ED_UPPER_BOUND;
+	}
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_ACCESSIBILITYFROMCACHE_H_ */
@@ -12,6 +12,7 @@ extern "C" {
 	#include <ViennaRNA/part_func.h>
 	#include <ViennaRNA/fold.h>
 	#include <ViennaRNA/model.h>
+	#include <ViennaRNA/constraints.h>
 }
 
 // RNAup-like ED filling
@@ -56,6 +57,7 @@ AccessibilityVrna::AccessibilityVrna(
 		if (plFoldW > 0 && plFoldW < getSequence().size() ) {
 			throw std::runtime_error("sequence '"+seq.getId()+"': accuracy constraints provided but sliding window enabled (>0), which is currently not supported");
 		}
+		// RNAup routines use global VRNA data structures
 #if INTARNA_MULITHREADING
 		#pragma omp critical(intarna_omp_callingVRNA)
 #endif
@@ -68,16 +70,11 @@ AccessibilityVrna::AccessibilityVrna(
 //			fillByConstraints(vrnaHandler, (plFoldW==0? getSequence().size() : std::min(plFoldW,getSequence().size())), plFoldL);
 		} // omp critical(intarna_omp_callingVRNA)
 	} else {
-		// VRNA computation not completely threadsafe
-#if INTARNA_MULITHREADING
-		#pragma omp critical(intarna_omp_callingVRNA)
-#endif
-		{
-			fillByRNAplfold(vrnaHandler
-					, (plFoldW==0? getSequence().size() : std::min(plFoldW,getSequence().size()))
-					, getAccConstraint().getMaxBpSpan()
-					);
-		} // omp critical(intarna_omp_callingVRNA)
+		// threadsafe since based on a local fold compound only
+		fillByRNAplfold(vrnaHandler
+				, (plFoldW==0? getSequence().size() : std::min(plFoldW,getSequence().size()))
+				, getAccConstraint().getMaxBpSpan()
+				);
 	}
 
 
@@ -138,18 +135,21 @@ calc_ensemble_free_energy( const int start_unfold, const int end_unfold, vrna_ex
 
 	// Vienna RNA : get free energy of structure ensemble via partition function
 	// while applying the structure constraint for the unstructured region
-	const double energy = pf_fold_par(	getSequence().asString().c_str()
-										, c_structure
-										, partFoldParams
-										, 0
-										, (start_unfold==-1?0:1)
-										, 0
-									);
+	// (local fold compound to be threadsafe)
+	vrna_fold_compound_t * foldData = vrna_fold_compound( getSequence().asString().c_str()
+										, &(partFoldParams->model_details)
+										, VRNA_OPTION_PF );
+	vrna_exp_params_subst( foldData, partFoldParams );
+	if (start_unfold != -1) {
+		vrna_constraints_add( foldData, (const char *)c_structure
+				, VRNA_CONSTRAINT_DB | VRNA_CONSTRAINT_DB_DOT | VRNA_CONSTRAINT_DB_X );
+	}
+	const double energy = vrna_pf( foldData, NULL );
 
 	// memory cleanup
-	free_pf_arrays();
+	vrna_fold_compound_free( foldData );
 
-	return (E_type)energy;
+	return Ekcal_2_E( energy );
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -175,23 +175,16 @@ getPfScale( const RnaSequence & seq, const VrnaHandler & vrnaHandler
 	// add maximal BP span
 	vrna_md_t curModel = vrnaHandler.getModel( plFoldL, seq.size() );
 
-	// Vienna RNA : get final folding parameters
-	paramT * foldParams = get_scaled_parameters( curModel.temperature, curModel );
-
-	// Vienna RNA : get mfe value
-	char structure[len+1];
-	strncpy(structure, c_structure, len+1);
-	const double min_en = fold_par(	getSequence().asString().c_str()
-									, structure
-									, foldParams
-									, 0
-									, 0
-								);
-	// memory cleanup
-	free_arrays();
+	// Vienna RNA : get mfe value (local fold compound to be threadsafe)
+	vrna_fold_compound_t * foldData = vrna_fold_compound( getSequence().asString().c_str()
+										, &curModel
+										, VRNA_OPTION_MFE );
+	vrna_constraints_add( foldData, (const char *)c_structure
+			, VRNA_CONSTRAINT_DB | VRNA_CONSTRAINT_DB_DOT | VRNA_CONSTRAINT_DB_X );
+	const double min_en = vrna_mfe( foldData, NULL );
 
-	// garbage collection
-	free(foldParams);
+	// memory cleanup
+	vrna_fold_compound_free( foldData );
 
 	// compute a scaling factor to avoid overflow in partition function
 	return std::exp(-(curModel.sfact*min_en)/ vrnaHandler.getRT() /(double)len);
@@ -282,67 +275,69 @@ fillByRNAplfold( const VrnaHandler &vrnaHandler
 
 	// add maximal BP span
 	vrna_md_t curModel = vrnaHandler.getModel( plFoldL, plFoldW );
-
-	const int length = getSequence().size();
-
-	// copy sequence into C data structure
-	char * sequence = (char *) vrna_alloc(sizeof(char) * (length + 1));
-	for (int i=0; i<length; i++) {
-		sequence[i] = getSequence().asString().at(i);
+	curModel.max_bp_span = (plFoldL==0? plFoldW : std::min(plFoldW,plFoldL));
+	curModel.window_size = plFoldW;
+
+	// setup local folding data (threadsafe in contrast to pfl_fold_par())
+	vrna_fold_compound_t * foldData = vrna_fold_compound( getSequence().asString().c_str()
+										, &curModel
+										, VRNA_OPTION_PF | VRNA_OPTION_WINDOW );
+
+	// init all ED values with upper bound (overwritten by the callback)
+	for (size_t i=0; i<getSequence().size(); i++) {
+		for (size_t j=i; j<std::min(getSequence().size(),i+getMaxLength()); j++) {
+			edValues(i,j) = ED_UPPER_BOUND;
+		}
 	}
-	sequence[length] = '\0';
 
-	double ** pup = NULL;
-    pup       =(double **)  vrna_alloc((length+1)*sizeof(double *));
-    pup[0]    =(double *)   vrna_alloc(sizeof(double)); /*I only need entry 0*/
-    pup[0][0] = (int)getMaxLength(); // length of unpaired stretch in window
+	// call folding and unpaired prob calculation
+	// where the ED values are directly stored via the callback function
+	std::pair< AccessibilityVrna*, const double > storageRT( this, vrnaHandler.getRT() );
+	vrna_probs_window( foldData
+			, (int)getMaxLength() // length of unpaired stretch in window
+			, VRNA_PROBS_WINDOW_UP
+			, &callbackForStorage
+			, (void*)&storageRT );
 
-    vrna_plist_t * dpp = NULL; // ?? whatever..
+	// garbage collection
+	vrna_fold_compound_free( foldData );
 
-    vrna_exp_param_t * pf_parameters = vrna_exp_params(& curModel);
+}
 
+///////////////////////////////////////////////////////////////////////////////
 
-	// call folding and unpaired prob calculation
-    vrna_plist_t * pl = pfl_fold_par(sequence
-    		, plFoldW // winsize
-    		, (plFoldL==0? plFoldW : std::min(plFoldW,plFoldL)) // base pair distance
-    		, 0.0 // printing probability cut-off
-    		, pup // the unpaired probabilities to be filled
-    		, &dpp
-    		, NULL // pUfp
-    		, NULL // spup
-    		, pf_parameters
-    );
-
-    const double RT = vrnaHandler.getRT();
-
-    // copy data
-    for (int j=1; j<=length; j++) {
-    	for (int i=std::max(1,j-(int)(pup[0][0]+0.49));i<=j; i++) {
-			// get unpaired probability
-			double prob_unpaired = pup[j][j-i+1];
-			// check if zero before computing its log-value
-			if (prob_unpaired == 0.0) {
-				// ED value = ED_UPPER_BOUND
-				edValues(i-1,j-1) = ED_UPPER_BOUND;
-			} else {
-				// compute ED value = E(unstructured in [i,j]) - E_all
-				edValues(i-1,j-1) = std::max<E_type>( 0., -RT*std::log(prob_unpaired));
-			}
-    	}
-    }
-
-    // garbage collection
-    free(pf_parameters);
-    if (pl) free(pl);
-    if (dpp) free(dpp);
-	for (int i=0; i<=length; i++) {
-		// delete allocated rows
-		if (pup[i]) free(pup[i]);
+void
+AccessibilityVrna::
+callbackForStorage( FLT_OR_DBL * pU
+		, int size
+		, int j
+		, int maxLength
+		, unsigned int type
+		, void * data )
+{
+	// ensure we only process unpaired probabilities
+	if ( ! (type & VRNA_PROBS_WINDOW_UP) ) {
+		return;
 	}
-    free(pup);
-    free(sequence);
 
+	// get storage and RT constant
+	std::pair< AccessibilityVrna*, const double > * storageRT = (std::pair< AccessibilityVrna*, const double > *)data;
+	AccessibilityVrna * storage = storageRT->first;
+	const double RT = storageRT->second;
+
+	// copy data for all unpaired stretch lengths l, i.e. region [j-l+1,j]
+	for (int l=1; l<=std::min(j,std::min(size,maxLength)); l++) {
+		// get unpaired probability
+		const double prob_unpaired = pU[l];
+		// check if zero before computing its log-value
+		if (prob_unpaired == 0.0) {
+			// ED value = ED_UPPER_BOUND
+			storage->edValues(j-l,j-1) = ED_UPPER_BOUND;
+		} else {
+			// compute ED value = E(unstructured in [j-l+1,j]) - E_all
+			storage->edValues(j-l,j-1) = std::max<E_type>( 0., Ekcal_2_E( -RT*std::log(prob_unpaired) ));
+		}
+	}
 }
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -433,7 +428,7 @@ fillByRNAup( const VrnaHandler &vrnaHandler
 					edValues(i-1,j-1) = ED_UPPER_BOUND;
 				} else {
 					// compute ED value = E(unstructured in [i,j]) - E_all
-					edValues(i-1,j-1) = std::max<E_type>( 0., -RT*std::log(prob_unpaired));
+					edValues(i-1,j-1) = std::max<E_type>( 0., Ekcal_2_E( -RT*std::log(prob_unpaired) ));
 				}
 
 			} else {
@@ -142,6 +142,28 @@ protected:
 						, const size_t plFoldW
 						, const size_t plFoldL );
 
+	/**
+	 * Callback function for vrna_probs_window() that stores the ED values
+	 * of all unpaired regions ending at a given position.
+	 *
+	 * @param pU the unpaired probabilities of the regions [j-l+1,j] for
+	 *        l in [1,size] (1-based indexing)
+	 * @param size the number of available probabilities in pU
+	 * @param j the end position of the regions (1-based indexing)
+	 * @param maxLength the maximal length of unpaired regions computed
+	 * @param type the type of the data provided in pU
+	 * @param data pointer to a pair of the AccessibilityVrna object to fill
+	 *        and the RT constant to be used
+	 */
+	static
+	void
+	callbackForStorage( FLT_OR_DBL * pU
+						, int size
+						, int j
+						, int maxLength
+						, unsigned int type
+						, void * data );
+
 
 };
 
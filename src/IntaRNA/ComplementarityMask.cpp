@@ -0,0 +1,77 @@
+#include "IntaRNA/ComplementarityMask.h"
+
+#include <algorithm>
+
+namespace IntaRNA {
+
+//////////////////////////////////////////////////////////////////////////
+
+ComplementarityMask::
+ComplementarityMask( const RnaSequence & seq1, const RnaSequence & seq2 )
+ :	length1( seq1.size() )
+	, length2( seq2.size() )
+	, blocks( getBlockNumber( seq2.size() ) )
+	, row1( seq1.size(), 0 )
+	, masks()
+{
+	const RnaSequence::CodeSeq_type & codes1 = seq1.asCodes();
+
+	// offset of the bit mask for each nucleotide code of seq1
+	std::vector< size_t > code2offset;
+	for (size_t i1=0; i1<length1; i1++) {
+		const size_t code = (size_t)codes1.at(i1);
+		if (code >= code2offset.size()) {
+			code2offset.resize( code+1, std::string::npos );
+		}
+		// compute bit mask for unknown code using i1 as representative
+		if (code2offset.at(code) == std::string::npos) {
+			code2offset[code] = masks.size();
+			masks.resize( masks.size()+blocks, 0 );
+			for (size_t i2=0; i2<length2; i2++) {
+				if (RnaSequence::areComplementary( seq1, seq2, i1, i2 )) {
+					masks[ code2offset[code] + i2/BLOCK_BITS ] |= ((Block)1) << (i2 % BLOCK_BITS);
+				}
+			}
+		}
+		row1[i1] = code2offset.at(code);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+ComplementarityMask::
+~ComplementarityMask()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+ComplementarityMask::
+getRow( const size_t i1, const size_t i2min, const size_t i2max, Block * row ) const
+{
+#if INTARNA_IN_DEBUG_MODE
+	if (i1 >= length1) throw std::runtime_error("ComplementarityMask::getRow() : i1 "+toString(i1)+" out of bounds (<"+toString(length1)+")");
+	if (i2min > i2max) throw std::runtime_error("ComplementarityMask::getRow() : i2min "+toString(i2min)+" > i2max "+toString(i2max));
+	if (i2max >= length2) throw std::runtime_error("ComplementarityMask::getRow() : i2max "+toString(i2max)+" out of bounds (<"+toString(length2)+")");
+#endif
+	const Block * mask = &(masks[row1[i1]]);
+	const size_t rowBlocks = getBlockNumber( i2max-i2min+1 );
+	const size_t shift = i2min % BLOCK_BITS;
+	// copy shifted blocks
+	for (size_t b=0, m=i2min/BLOCK_BITS; b<rowBlocks; b++, m++) {
+		row[b] = mask[m] >> shift;
+		if (shift > 0 && m+1 < blocks) {
+			row[b] |= mask[m+1] << (BLOCK_BITS-shift);
+		}
+	}
+	// unset bits behind i2max
+	const size_t lastBits = (i2max-i2min+1) % BLOCK_BITS;
+	if (lastBits > 0) {
+		row[rowBlocks-1] &= (((Block)1) << lastBits) - 1;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
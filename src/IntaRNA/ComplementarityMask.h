@@ -0,0 +1,172 @@
+
+#ifndef INTARNA_COMPLEMENTARITYMASK_H_
+#define INTARNA_COMPLEMENTARITYMASK_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/RnaSequence.h"
+
+#include <boost/cstdint.hpp>
+
+#include <vector>
+#include <stdexcept>
+
+namespace IntaRNA {
+
+/**
+ * Bit-parallel representation of the complementarity of two sequences.
+ *
+ * For each nucleotide code present in seq1, a bit vector over all positions
+ * of seq2 is precomputed that marks the positions complementary to this
+ * nucleotide. Thus, single complementarity checks are reduced to a bit test
+ * and the complementarity of a whole row (i1, i2..i2+63) is available as one
+ * Block to be processed via bitwise operations.
+ *
+ * The memory consumption is O(#codes * |seq2| / 64).
+ *
+ * @author Martin Mann
+ *
+ */
+class ComplementarityMask
+{
+public:
+
+	//! the type of a block of bits
+	typedef boost::uint64_t Block;
+
+	//! the number of bits per block
+	static const size_t BLOCK_BITS = 64;
+
+	/**
+	 * Number of blocks needed to store the given number of bits
+	 * @param bits the number of bits to store
+	 * @return the number of blocks needed
+	 */
+	static
+	size_t
+	getBlockNumber( const size_t bits );
+
+public:
+
+	/**
+	 * Construction : precomputes the bit masks for all nucleotides of seq1
+	 * @param seq1 the first sequence
+	 * @param seq2 the second sequence
+	 */
+	ComplementarityMask( const RnaSequence & seq1, const RnaSequence & seq2 );
+
+	/**
+	 * destruction
+	 */
+	virtual ~ComplementarityMask();
+
+	/**
+	 * Length of sequence 1
+	 * @return length of sequence 1
+	 */
+	size_t
+	size1() const;
+
+	/**
+	 * Length of sequence 2
+	 * @return length of sequence 2
+	 */
+	size_t
+	size2() const;
+
+	/**
+	 * Checks whether or not two positions can form a base pair
+	 * @param i1 index in first sequence
+	 * @param i2 index in second sequence
+	 * @return true if seq1(i1) can form a base pair with seq2(i2)
+	 */
+	bool
+	areComplementary( const size_t i1, const size_t i2 ) const;
+
+	/**
+	 * Writes the complementarity of the row i1 for the positions i2min..i2max
+	 * of seq2 to the given blocks, ie. bit (i2-i2min) is set if i1 and i2 are
+	 * complementary. All further bits of the
+	 * getBlockNumber(i2max-i2min+1) blocks are unset.
+	 *
+	 * @param i1 index in first sequence
+	 * @param i2min the first index of seq2 to be encoded
+	 * @param i2max the last index of seq2 to be encoded (>=i2min)
+	 * @param row the blocks to write to
+	 */
+	void
+	getRow( const size_t i1, const size_t i2min, const size_t i2max, Block * row ) const;
+
+protected:
+
+	//! the length of seq1
+	const size_t length1;
+
+	//! the length of seq2
+	const size_t length2;
+
+	//! the number of blocks per bit mask
+	const size_t blocks;
+
+	//! for each position of seq1 the offset of its nucleotide's bit mask
+	//! within masks
+	std::vector< size_t > row1;
+
+	//! the bit masks for all nucleotides of seq1 (consecutive blocks)
+	std::vector< Block > masks;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+ComplementarityMask::
+getBlockNumber( const size_t bits )
+{
+	return (bits + BLOCK_BITS - 1) / BLOCK_BITS;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+ComplementarityMask::
+size1() const
+{
+	return length1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+ComplementarityMask::
+size2() const
+{
+	return length2;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+ComplementarityMask::
+areComplementary( const size_t i1, const size_t i2 ) const
+{
+#if INTARNA_IN_DEBUG_MODE
+	if (i1 >= length1 || i2 >= length2)
+		throw std::runtime_error("ComplementarityMask::areComplementary : index positions i1/i2 ("
+				+ toString(i1)+"/"+toString(i2)
+				+ ") are out of bounds ("
+				+ toString(length1)+"/"+toString(length2)
+				+")"
+				);
+#endif
+	return (masks[ row1[i1] + i2/BLOCK_BITS ] >> (i2 % BLOCK_BITS)) & 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_COMPLEMENTARITYMASK_H_ */
@@ -0,0 +1,310 @@
+#include "IntaRNA/FastaFileMapped.h"
+
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+#if HAVE_SYS_MMAN_H
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+namespace IntaRNA {
+
+//////////////////////////////////////////////////////////////////////////
+
+/**
+ * Whether or not a character is a whitespace within FASTA data
+ * @param c the character to check
+ * @return true if c is a space, tab, or newline character
+ */
+inline
+bool
+isFastaWhitespace( const char c )
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r';
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FastaFileMapped::
+FastaFileMapped( const std::string & fileName, const bool useIndexFile )
+ :	fileName(fileName)
+	, data(NULL)
+	, dataSize(0)
+	, buffer()
+	, indexFromFile(false)
+	, entries()
+	, name2index()
+{
+#if HAVE_SYS_MMAN_H
+	// map file into memory
+	const int fd = open( fileName.c_str(), O_RDONLY );
+	if (fd < 0) {
+		throw std::runtime_error("FastaFileMapped : could not open file '"+fileName+"'");
+	}
+	struct stat fileStat;
+	if (fstat( fd, &fileStat ) != 0) {
+		close( fd );
+		throw std::runtime_error("FastaFileMapped : could not access file '"+fileName+"'");
+	}
+	dataSize = (size_t)fileStat.st_size;
+	if (dataSize > 0) {
+		void * mapped = mmap( NULL, dataSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if (mapped == MAP_FAILED) {
+			close( fd );
+			throw std::runtime_error("FastaFileMapped : could not map file '"+fileName+"'");
+		}
+		// sequences are typically accessed in file order
+		madvise( mapped, dataSize, MADV_SEQUENTIAL );
+		data = static_cast<const char*>(mapped);
+	}
+	// mapping stays valid without file descriptor
+	close( fd );
+#else
+	// read whole file content
+	std::ifstream file( fileName.c_str(), std::ios::in | std::ios::binary );
+	if (!file.good()) {
+		throw std::runtime_error("FastaFileMapped : could not open file '"+fileName+"'");
+	}
+	std::stringstream content;
+	content <<file.rdbuf();
+	buffer = content.str();
+	data = buffer.c_str();
+	dataSize = buffer.size();
+#endif
+
+	try {
+		// check for index file
+		std::ifstream indexFile( (fileName+".fai").c_str() );
+		if (useIndexFile && indexFile.good()) {
+			parseIndex( indexFile );
+			indexFromFile = true;
+		} else {
+			buildIndex();
+		}
+	} catch (...) {
+#if HAVE_SYS_MMAN_H
+		if (data != NULL) {
+			munmap( const_cast<char*>(data), dataSize );
+		}
+#endif
+		throw;
+	}
+
+	// setup name lookup (first occurrence only)
+	for (size_t i=0; i<entries.size(); i++) {
+		name2index.insert( std::make_pair( entries.at(i).name, i ) );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+FastaFileMapped::
+~FastaFileMapped()
+{
+#if HAVE_SYS_MMAN_H
+	if (data != NULL) {
+		munmap( const_cast<char*>(data), dataSize );
+	}
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+FastaFileMapped::
+parseIndex( std::istream & index )
+{
+	std::string line;
+	while( std::getline( index, line ) ) {
+		// ignore empty lines
+		if (line.empty()) {
+			continue;
+		}
+		// parse tab-separated columns : NAME LENGTH OFFSET LINEBASES LINEWIDTH
+		Entry entry;
+		const size_t nameEnd = line.find('\t');
+		if (nameEnd == std::string::npos || nameEnd == 0) {
+			throw std::runtime_error("FastaFileMapped : index of '"+fileName+"' : could not parse line '"+line+"'");
+		}
+		entry.name = line.substr(0,nameEnd);
+		std::istringstream columns( line.substr(nameEnd+1) );
+		if ( !(columns >>entry.length >>entry.offset >>entry.lineBases >>entry.lineWidth)
+			|| entry.lineBases == 0 || entry.lineWidth < entry.lineBases )
+		{
+			throw std::runtime_error("FastaFileMapped : index of '"+fileName+"' : could not parse line '"+line+"'");
+		}
+		// end of the sequence data (behind its last nucleotide)
+		entry.end = entry.offset;
+		if (entry.length > 0) {
+			entry.end += ((entry.length-1) / entry.lineBases) * entry.lineWidth
+					+ ((entry.length-1) % entry.lineBases) + 1;
+		}
+		// check consistency with file : sequence data within file preceded by an ID line
+		if ( entry.offset == 0 || entry.end > dataSize || data[entry.offset-1] != '\n' ) {
+			throw std::runtime_error("FastaFileMapped : index of '"+fileName+"' does not match the file for sequence '"+entry.name+"'");
+		}
+		entries.push_back( entry );
+		// check ID line
+		const std::string id = getId( entries.size()-1 );
+		if (id.compare( 0, entry.name.size(), entry.name ) != 0) {
+			throw std::runtime_error("FastaFileMapped : index of '"+fileName+"' does not match the file for sequence '"+entry.name+"'");
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+FastaFileMapped::
+buildIndex()
+{
+	// the sequence currently parsed
+	Entry * cur = NULL;
+	// length information of the last sequence line
+	size_t lastBases = 0, lastWidth = 0;
+	// whether or not an empty line followed the last sequence line
+	bool emptyLineSeen = false;
+
+	size_t pos = 0;
+	while (pos < dataSize) {
+		// get line end
+		const char * eol = static_cast<const char*>(memchr( data+pos, '\n', dataSize-pos ));
+		const size_t lineEnd = (eol == NULL) ? dataSize : (size_t)(eol - data);
+		const size_t next = (eol == NULL) ? dataSize : lineEnd+1;
+		// number of bytes without trailing whitespaces
+		size_t bases = lineEnd - pos;
+		while (bases > 0 && isFastaWhitespace(data[pos+bases-1])) {
+			bases--;
+		}
+
+		if (data[pos] == '>') {
+			// close last sequence
+			if (cur != NULL) {
+				cur->end = pos;
+			}
+			// start new sequence
+			entries.push_back( Entry() );
+			cur = &(entries.back());
+			// name = first word of ID line
+			size_t nameStart = pos+1;
+			while (nameStart < pos+bases && isFastaWhitespace(data[nameStart])) {
+				nameStart++;
+			}
+			size_t nameEnd = nameStart;
+			while (nameEnd < pos+bases && !isFastaWhitespace(data[nameEnd])) {
+				nameEnd++;
+			}
+			cur->name = std::string( data+nameStart, nameEnd-nameStart );
+			cur->length = 0;
+			cur->offset = next;
+			cur->lineBases = 0;
+			cur->lineWidth = 0;
+			cur->end = dataSize;
+			emptyLineSeen = false;
+		} else
+		if (bases == 0) {
+			// empty line
+			emptyLineSeen = true;
+		} else {
+			if (cur == NULL) {
+				throw std::runtime_error("FastaFileMapped : '"+fileName+"' contains sequence data without leading ID");
+			}
+			// trim leading whitespaces
+			size_t leading = 0;
+			while (isFastaWhitespace(data[pos+leading])) {
+				leading++;
+			}
+			// check for enclosed whitespaces
+			for (size_t i=leading; i<bases; i++) {
+				if (isFastaWhitespace(data[pos+i])) {
+					throw std::runtime_error("FastaFileMapped : sequence for ID '"+cur->name+"' in '"+fileName+"' contains spaces");
+				}
+			}
+			// count nucleotides
+			const size_t nucleotides = bases - leading;
+			if (cur->length == 0) {
+				// first line defines the layout
+				cur->lineBases = bases;
+				cur->lineWidth = next-pos;
+				// no leading whitespaces/empty lines allowed
+				if (emptyLineSeen || isFastaWhitespace(data[pos])) {
+					cur->lineBases = 0;
+				}
+			} else
+			// check if the previous line was a full line and this one is not longer
+			if ( emptyLineSeen
+				|| lastBases != cur->lineBases || lastWidth != cur->lineWidth
+				|| bases > cur->lineBases || isFastaWhitespace(data[pos]) )
+			{
+				cur->lineBases = 0;
+			}
+			lastBases = bases;
+			lastWidth = next-pos;
+			cur->length += nucleotides;
+		}
+		pos = next;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+std::string
+FastaFileMapped::
+getId( const size_t i ) const
+{
+	checkIndex(i);
+	const Entry & entry = entries.at(i);
+	// find start of the ID line preceding the sequence data
+	size_t idEnd = entry.offset;
+	while (idEnd > 0 && isFastaWhitespace(data[idEnd-1])) {
+		idEnd--;
+	}
+	size_t idStart = idEnd;
+	while (idStart > 0 && data[idStart-1] != '\n') {
+		idStart--;
+	}
+	if (idStart == idEnd || data[idStart] != '>') {
+		throw std::runtime_error("FastaFileMapped : no ID line found for sequence '"+entry.name+"' in '"+fileName+"'");
+	}
+	// trim leading '>' and whitespaces
+	idStart++;
+	while (idStart < idEnd && isFastaWhitespace(data[idStart])) {
+		idStart++;
+	}
+	return std::string( data+idStart, idEnd-idStart );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+RnaSequence
+FastaFileMapped::
+getSequence( const size_t i ) const
+{
+	checkIndex(i);
+	const Entry & entry = entries.at(i);
+	std::string sequence;
+	sequence.reserve( entry.length );
+	if (entry.lineBases > 0) {
+		// direct access via line layout
+		for (size_t pos = entry.offset; sequence.size() < entry.length; pos += entry.lineWidth) {
+			sequence.append( data+pos, std::min( entry.lineBases, entry.length-sequence.size() ) );
+		}
+	} else {
+		// irregular layout : collect all non-whitespace characters
+		// (only leading/trailing whitespaces of lines, see buildIndex())
+		for (size_t pos = entry.offset; pos < entry.end; pos++) {
+			if (!isFastaWhitespace(data[pos])) {
+				sequence.push_back( data[pos] );
+			}
+		}
+	}
+	return RnaSequence( getId(i), sequence );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
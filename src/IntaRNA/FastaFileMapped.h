@@ -0,0 +1,244 @@
+
+#ifndef INTARNA_FASTAFILEMAPPED_H_
+#define INTARNA_FASTAFILEMAPPED_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/RnaSequence.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Read-only access to the sequences of a FASTA file that is mapped into
+ * memory (if supported by the system, otherwise it is read at once).
+ *
+ * The position of each sequence within the file is taken from a
+ * samtools-style index file (FASTA file name + ".fai") if present or
+ * otherwise computed by a single scan of the mapped data. Thus, single
+ * sequences can be accessed by index or name without parsing the remaining
+ * file and RnaSequence objects are constructed directly from the mapped bytes.
+ *
+ * The name of a sequence (as used within the index) is the first word of its
+ * ID line while the id of the constructed RnaSequence is the full ID line
+ * (without leading '>' and surrounding whitespaces). Leading and trailing
+ * whitespaces of sequence lines are ignored, while enclosed whitespaces are
+ * not allowed.
+ *
+ * @author Martin Mann
+ *
+ */
+class FastaFileMapped
+{
+public:
+
+	/**
+	 * Construction : maps the FASTA file and sets up the sequence index.
+	 * Throws a std::runtime_error if the file cannot be read, a sequence line
+	 * contains enclosed whitespaces, or the index does not match the file.
+	 *
+	 * @param fileName the name of the FASTA file to read
+	 * @param useIndexFile whether or not the index file (fileName+".fai")
+	 *        is to be used if present
+	 */
+	FastaFileMapped( const std::string & fileName, const bool useIndexFile = true );
+
+	/**
+	 * Destruction : unmaps the file
+	 */
+	virtual ~FastaFileMapped();
+
+	/**
+	 * Number of sequences within the file
+	 * @return the number of sequences
+	 */
+	size_t
+	size() const;
+
+	/**
+	 * Whether or not the sequence index was read from the index file
+	 * @return true if the .fai file was used; false if the file was scanned
+	 */
+	bool
+	isIndexFromFile() const;
+
+	/**
+	 * Access to the name of a sequence (first word of its ID line)
+	 * @param i the index of the sequence (< size())
+	 * @return the name of the sequence
+	 */
+	const std::string &
+	getName( const size_t i ) const;
+
+	/**
+	 * Provides the index of the first sequence with the given name
+	 * @param name the name of the sequence to find
+	 * @return the index of the sequence or size() if not present
+	 */
+	size_t
+	getIndex( const std::string & name ) const;
+
+	/**
+	 * Access to the length of a sequence
+	 * @param i the index of the sequence (< size())
+	 * @return the number of nucleotides of the sequence
+	 */
+	size_t
+	getLength( const size_t i ) const;
+
+	/**
+	 * Constructs the sequence object from the mapped data.
+	 * @param i the index of the sequence (< size())
+	 * @return the according sequence
+	 */
+	RnaSequence
+	getSequence( const size_t i ) const;
+
+	/**
+	 * Provides the full ID line of a sequence without leading '>' and
+	 * surrounding whitespaces
+	 * @param i the index of the sequence (< size())
+	 * @return the id of the sequence
+	 */
+	std::string
+	getId( const size_t i ) const;
+
+protected:
+
+	/**
+	 * Position information of a sequence within the file
+	 * (compatible with the samtools .fai format)
+	 */
+	class Entry {
+	public:
+		//! the name of the sequence
+		std::string name;
+		//! the number of nucleotides
+		size_t length;
+		//! the offset of the first nucleotide within the file
+		size_t offset;
+		//! the number of nucleotides per line (0 if the line layout is irregular)
+		size_t lineBases;
+		//! the number of bytes per line (including newline characters)
+		size_t lineWidth;
+		//! the offset of the next ID line or of the end of the file
+		size_t end;
+	};
+
+	//! the name of the mapped file
+	const std::string fileName;
+
+	//! the file data
+	const char * data;
+
+	//! the number of bytes of data
+	size_t dataSize;
+
+	//! the file content if memory mapping is not supported
+	std::string buffer;
+
+	//! whether or not the index was read from file
+	bool indexFromFile;
+
+	//! the position information of all sequences in file order
+	std::vector< Entry > entries;
+
+	//! index of the first sequence for each name
+	std::unordered_map< std::string, size_t > name2index;
+
+	/**
+	 * Fills the sequence index from a samtools-style index
+	 * @param index the stream to read the index from
+	 */
+	void
+	parseIndex( std::istream & index );
+
+	/**
+	 * Fills the sequence index by a scan of the mapped data
+	 */
+	void
+	buildIndex();
+
+	/**
+	 * Checks the sequence index bounds
+	 * @param i the index to check
+	 */
+	void
+	checkIndex( const size_t i ) const;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+FastaFileMapped::
+size() const
+{
+	return entries.size();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+FastaFileMapped::
+isIndexFromFile() const
+{
+	return indexFromFile;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+const std::string &
+FastaFileMapped::
+getName( const size_t i ) const
+{
+	checkIndex(i);
+	return entries.at(i).name;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+FastaFileMapped::
+getIndex( const std::string & name ) const
+{
+	auto it = name2index.find( name );
+	return (it == name2index.end()) ? size() : it->second;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+FastaFileMapped::
+getLength( const size_t i ) const
+{
+	checkIndex(i);
+	return entries.at(i).length;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+void
+FastaFileMapped::
+checkIndex( const size_t i ) const
+{
+	if (i >= size()) {
+		throw std::runtime_error("FastaFileMapped : sequence index "+toString(i)+" out of range (<"+toString(size())+")");
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_FASTAFILEMAPPED_H_ */
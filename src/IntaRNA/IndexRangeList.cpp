@@ -11,12 +11,21 @@ const boost::regex IndexRangeList::regex("^(\\d|([123456789]\\d*)-(\\d|[12345678
 
 //////////////////////////////////////////////////////////////////////
 
+const size_t IndexRangeList::notCovered = std::numeric_limits<size_t>::max();
+
+//////////////////////////////////////////////////////////////////////
+
 bool
 IndexRangeList::
 covers( const size_t index ) const
 {
+	// direct lookup
+	if (useDenseLookup) {
+		return index < denseLookup.size() && denseLookup[index] != notCovered;
+	}
+
 	// quick check
-	if (list.empty()) {
+	if (list.empty() || index < list.begin()->from || list.rbegin()->to < index) {
 		return false;
 	}
 
@@ -36,6 +45,13 @@ bool
 IndexRangeList::
 covers( const IndexRange & range ) const
 {
+	// direct lookup
+	if (useDenseLookup) {
+		return range.from < denseLookup.size()
+				&& denseLookup[range.from] != notCovered
+				&& range.to <= denseLookup[range.from];
+	}
+
 	// quick check
 	if (list.empty()) {
 		return false;
@@ -117,6 +133,9 @@ push_back( const IndexRange& range )
 	}
 	// sorting should be OK (in debug mode.. ;) )
 	list.push_back( range );
+	if (useDenseLookup) {
+		updateDenseLookup( range, range.to );
+	}
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -133,6 +152,9 @@ insert( const IndexRange& range )
 	// add first member to list
 	if (list.empty()) {
 		list.push_back( range );
+		if (useDenseLookup) {
+			updateDenseLookup( range, range.to );
+		}
 		return begin();
 	} else
 	// insert accordingly
@@ -160,7 +182,11 @@ insert( const IndexRange& range )
 			++r;
 		}
 		// insert accordingly preserving sorting
-		return list.insert( r, range );
+		r = list.insert( r, range );
+		if (useDenseLookup) {
+			updateDenseLookup( range, range.to );
+		}
+		return r;
 	}
 }
 
@@ -171,6 +197,10 @@ IndexRangeList::
 shift( const int indexShift, const size_t indexMax ) const
 {
 	IndexRangeList l;
+	// keep lookup mode
+	if (useDenseLookup) {
+		l.enableDenseLookup();
+	}
 	IndexRange r2;
 	for (IndexRangeList::const_iterator r=begin(); r!=end(); r++) {
 		// skip ranges leaving the valid interval
@@ -207,7 +237,11 @@ reverse( const size_t seqLength )
 		r->to = seqLength -1 - tmpFrom;
 	}
 	// reverse order of list entries
-	list.reverse();
+	std::reverse( list.begin(), list.end() );
+	// update index lookup
+	if (useDenseLookup) {
+		rebuildDenseLookup();
+	}
 	// return access to altered element
 	return *this;
 }
@@ -240,6 +274,31 @@ fromString( const std::string & stringEncoding )
 
 //////////////////////////////////////////////////////////////////////
 
+void
+IndexRangeList::
+updateDenseLookup( const IndexRange & range, const size_t value )
+{
+	// ensure lookup covers the range
+	if (denseLookup.size() <= range.to) {
+		denseLookup.resize( range.to+1, notCovered );
+	}
+	std::fill( denseLookup.begin()+range.from, denseLookup.begin()+range.to+1, value );
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void
+IndexRangeList::
+rebuildDenseLookup()
+{
+	denseLookup.clear();
+	for (const_iterator r=begin(); r!=end(); r++) {
+		updateDenseLookup( *r, r->to );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
 
 
 } // namespace
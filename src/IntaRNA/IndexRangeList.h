@@ -4,7 +4,8 @@
 
 #include "IntaRNA/IndexRange.h"
 
-#include <list>
+#include <limits>
+#include <vector>
 
 #include <boost/regex.hpp>
 
@@ -13,6 +14,13 @@ namespace IntaRNA {
 /**
  * Sorted list of non-overlapping ascending ranges.
  *
+ * The ranges are stored in a sorted vector such that covers() and overlaps()
+ * are answered via binary search in O(log n) for n ranges.
+ *
+ * For dense queries (e.g. a check for each index of a sequence), an
+ * additional per-index lookup can be enabled via enableDenseLookup() that
+ * answers covers() in constant time.
+ *
  * TODO add support for overlapping ranges
  *
  * @author Martin Mann
@@ -23,7 +31,7 @@ class IndexRangeList
 protected:
 
 	//! List of ranges
-	typedef std::list< IndexRange > List;
+	typedef std::vector< IndexRange > List;
 
 public:
 
@@ -124,6 +132,22 @@ public:
 	 */
 	iterator erase( iterator i );
 
+	/**
+	 * Enables a per-index lookup that answers covers() in constant time.
+	 * The lookup is kept up to date by all altering member functions and
+	 * needs memory linear in the maximal index covered by the list.
+	 *
+	 * NOTE: altering a range via a non-const iterator is not tracked by the
+	 * lookup.
+	 */
+	void enableDenseLookup();
+
+	/**
+	 * Whether or not the per-index lookup for covers() is enabled
+	 * @return true if enableDenseLookup() was called; false otherwise
+	 */
+	bool hasDenseLookup() const;
+
 	/**
 	 * Access to the first index range within the list
 	 * @return the begin of the list
@@ -205,7 +229,7 @@ public:
 	 * @return a new range list with shifted ranges where all ranges shifted to
 	 *    indices below 0 are (I) removed if range'.to < 0 or (II) cut to
 	 *    range'.from = 0; the same holds respectively for upper bound
-	 *    violations exceeding indexMax.
+	 *    violations exceeding indexMax. The dense lookup setting is kept.
 	 */
 	IndexRangeList
 	shift( const int indexShift, const size_t indexMax ) const;
@@ -244,9 +268,31 @@ public:
 
 protected:
 
+	//! marker for indices not covered by any range within denseLookup
+	static const size_t notCovered;
+
 	//! the list of indices
 	List list;
 
+	//! whether or not denseLookup is to be used and maintained
+	bool useDenseLookup;
+
+	//! per index the end of the covering range or notCovered;
+	//! indices beyond its size are not covered
+	std::vector<size_t> denseLookup;
+
+	/**
+	 * Updates the dense lookup for the indices of the given range
+	 * @param range the range to update
+	 * @param value the value to set for all indices of range
+	 */
+	void updateDenseLookup( const IndexRange & range, const size_t value );
+
+	/**
+	 * Recomputes the dense lookup from the current list
+	 */
+	void rebuildDenseLookup();
+
 };
 
 /**
@@ -267,6 +313,8 @@ inline
 IndexRangeList::IndexRangeList()
 :
 list()
+, useDenseLookup(false)
+, denseLookup()
 {
 }
 
@@ -276,6 +324,8 @@ inline
 IndexRangeList::IndexRangeList( const std::string & stringEncoding )
 :
 list()
+, useDenseLookup(false)
+, denseLookup()
 {
 	fromString(stringEncoding);
 }
@@ -286,6 +336,8 @@ inline
 IndexRangeList::IndexRangeList( const IndexRangeList & toCopy )
 :
 list(toCopy.list)
+, useDenseLookup(toCopy.useDenseLookup)
+, denseLookup(toCopy.denseLookup)
 {
 }
 
@@ -322,7 +374,33 @@ reverse( const size_t seqLength ) const
 //////////////////////////////////////////////////////////////////////
 
 inline
-IndexRangeList::iterator IndexRangeList::erase( IndexRangeList::iterator i ) { return list.erase( i ); }
+IndexRangeList::iterator
+IndexRangeList::
+erase( IndexRangeList::iterator i )
+{
+	if (useDenseLookup) {
+		updateDenseLookup( *i, notCovered );
+	}
+	return list.erase( i );
+}
+
+//////////////////////////////////////////////////////////////////////
+
+inline
+void
+IndexRangeList::
+enableDenseLookup()
+{
+	if (!useDenseLookup) {
+		useDenseLookup = true;
+		rebuildDenseLookup();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
+inline
+bool IndexRangeList::hasDenseLookup() const { return useDenseLookup; }
 
 //////////////////////////////////////////////////////////////////////
 
@@ -377,7 +455,7 @@ size_t IndexRangeList::size() const { return list.size(); }
 //////////////////////////////////////////////////////////////////////
 
 inline
-void IndexRangeList::clear() { return list.clear(); }
+void IndexRangeList::clear() { list.clear(); denseLookup.clear(); }
 
 //////////////////////////////////////////////////////////////////////
 
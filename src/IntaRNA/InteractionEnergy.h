@@ -7,6 +7,7 @@
 #include "IntaRNA/Interaction.h"
 #include "IntaRNA/Accessibility.h"
 #include "IntaRNA/ReverseAccessibility.h"
+#include "IntaRNA/ComplementarityMask.h"
 
 namespace IntaRNA {
 
@@ -118,7 +119,7 @@ public:
 	 */
 	virtual
 	E_type
-	getE( const E_type Z ) const;
+	getE( const Z_type Z ) const;
 
 	/**
 	 * Provides details about the energy contributions for the given interaction
@@ -394,7 +395,7 @@ public:
 	 * @return the dangling end probability for the left side of the interaction
 	 */
 	virtual
-	E_type
+	Z_type
 	getPr_danglingLeft( const size_t i1, const size_t j1, const size_t i2, const size_t j2 ) const;
 
 	/**
@@ -410,7 +411,7 @@ public:
 	 * @return the dangling end probability for the right side of the interaction
 	 */
 	virtual
-	E_type
+	Z_type
 	getPr_danglingRight( const size_t i1, const size_t j1, const size_t i2, const size_t j2 ) const;
 
 	/**
@@ -449,11 +450,22 @@ public:
 		return maxInternalLoopSize2;
 	}
 
+	/**
+	 * Access to the bit-parallel complementarity information of both
+	 * sequences (using the reversed index order of seq2).
+	 * NOTE: the mask uses the indices of the original sequences, ie. no index
+	 * offset of derived wrapper classes is applied.
+	 * @return the complementarity mask of seq1 and seq2
+	 */
+	const ComplementarityMask & getComplementarityMask() const {
+		return complementarityMask;
+	}
+
 	/**
 	 * Access to the normalized temperature for Boltzmann weight computation
 	 */
 	virtual
-	E_type
+	Ekcal_type
 	getRT() const = 0;
 
 
@@ -493,7 +505,7 @@ public:
 	 * @return the Boltzmann weight, i.e. exp( - energy / RT );
 	 */
 	virtual
-	E_type
+	Z_type
 	getBoltzmannWeight( const E_type energy ) const ;
 
 
@@ -542,6 +554,9 @@ protected:
 	//! forming an intermolecular internal loop
 	const size_t maxInternalLoopSize2;
 
+	//! bit-parallel complementarity information for seq1 and seq2
+	const ComplementarityMask complementarityMask;
+
 	/**
 	 * Checks whether or not the given indices are valid index region within the
 	 * sequence for an intermolecular loop and do not violate the maximal
@@ -599,7 +614,7 @@ InteractionEnergy::InteractionEnergy( const Accessibility & accS1
 	, accS2(accS2)
 	, maxInternalLoopSize1(maxInternalLoopSize1)
 	, maxInternalLoopSize2(maxInternalLoopSize2)
-
+	, complementarityMask( accS1.getSequence(), accS2.getSequence() )
 {
 }
 
@@ -634,7 +649,7 @@ bool
 InteractionEnergy::
 areComplementary( const size_t i1, const size_t i2 ) const
 {
-	return RnaSequence::areComplementary( accS1.getSequence(), accS2.getSequence(), i1, i2);
+	return complementarityMask.areComplementary( i1, i2 );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -696,12 +711,12 @@ getAccessibility2() const
 ////////////////////////////////////////////////////////////////////////////
 
 inline
-E_type
+Z_type
 InteractionEnergy::
 getBoltzmannWeight( const E_type e ) const
 {
 	// TODO can be optimized when using exp-energies from VRNA
-	return std::exp( - e / getRT() );
+	return std::exp( - E_2_Ekcal(e) / getRT() );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -782,19 +797,19 @@ isAccessible2( const size_t i ) const
 ////////////////////////////////////////////////////////////////////////////
 
 inline
-E_type
+Z_type
 InteractionEnergy::
 getPr_danglingLeft( const size_t i1, const size_t j1, const size_t i2, const size_t j2 ) const
 {
 	// initial probabilities
-	E_type probDangle1 = 1.0, probDangle2 = 1.0;
+	Z_type probDangle1 = 1.0, probDangle2 = 1.0;
 
 	// if dangle1 possible
 	if (i1>0)  {
 		// Pr( i1-1 is unpaired | i1..j1 unpaired )
 		probDangle1 =
-			std::max( (E_type)0.0
-					, std::min( (E_type)1.0
+			std::max( (Z_type)0.0
+					, std::min( (Z_type)1.0
 							, getBoltzmannWeight( getED1(i1-1,j1)-getED1(i1,j1) )
 							)
 					)
@@ -804,8 +819,8 @@ getPr_danglingLeft( const size_t i1, const size_t j1, const size_t i2, const siz
 	if (i2>0)  {
 		// Pr( i2-1 is unpaired | i2..j2 unpaired )
 		probDangle2 =
-			std::max( (E_type)0.0
-					, std::min( (E_type)1.0
+			std::max( (Z_type)0.0
+					, std::min( (Z_type)1.0
 							, getBoltzmannWeight( getED2(i2-1,j2)-getED2(i2,j2) )
 							)
 					)
@@ -819,19 +834,19 @@ getPr_danglingLeft( const size_t i1, const size_t j1, const size_t i2, const siz
 ////////////////////////////////////////////////////////////////////////////
 
 inline
-E_type
+Z_type
 InteractionEnergy::
 getPr_danglingRight( const size_t i1, const size_t j1, const size_t i2, const size_t j2 ) const
 {
 	// initial probabilities
-	E_type probDangle1 = 1.0, probDangle2 = 1.0;
+	Z_type probDangle1 = 1.0, probDangle2 = 1.0;
 
 	// if dangle1 possible
 	if (j1+1<size1())  {
 		// Pr( j1+1 is unpaired | i1..j1 unpaired )
 		probDangle1 =
-			std::max( (E_type)0.0
-					, std::min( (E_type)1.0
+			std::max( (Z_type)0.0
+					, std::min( (Z_type)1.0
 							, getBoltzmannWeight( getED1(i1,j1+1)-getED1(i1,j1) )
 							)
 					)
@@ -841,8 +856,8 @@ getPr_danglingRight( const size_t i1, const size_t j1, const size_t i2, const si
 	if (j2+1<size2())  {
 		// Pr( j2+1 is unpaired | i2..j2 unpaired )
 		probDangle2 =
-			std::max( (E_type)0.0
-					, std::min( (E_type)1.0
+			std::max( (Z_type)0.0
+					, std::min( (Z_type)1.0
 							, getBoltzmannWeight( getED2(i2,j2+1)-getED2(i2,j2) )
 							)
 					)
@@ -871,8 +886,8 @@ getE( const size_t i1, const size_t j1
 				+ getED2( i2, j2 )
 				// dangling end penalty
 				// weighted by the probability that ends are unpaired
-				+ (getE_danglingLeft( i1, i2 )*getPr_danglingLeft(i1,j1,i2,j2))
-				+ (getE_danglingRight( j1, j2 )*getPr_danglingRight(i1,j1,i2,j2))
+				+ Ekcal_2_E(E_2_Ekcal(getE_danglingLeft( i1, i2 ))*getPr_danglingLeft(i1,j1,i2,j2))
+				+ Ekcal_2_E(E_2_Ekcal(getE_danglingRight( j1, j2 ))*getPr_danglingRight(i1,j1,i2,j2))
 				// helix closure penalty
 				+ getE_endLeft( i1, i2 )
 				+ getE_endRight( j1, j2 )
@@ -888,10 +903,10 @@ getE( const size_t i1, const size_t j1
 inline
 E_type
 InteractionEnergy::
-getE( const E_type Z ) const
+getE( const Z_type Z ) const
 {
 	// convert partition function to ensemble energy
-	return - getRT() * std::log( Z );
+	return Ekcal_2_E( - getRT() * std::log( Z ) );
 }
 
 
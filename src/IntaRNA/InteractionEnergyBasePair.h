@@ -214,7 +214,7 @@ public:
 	 * @return 1.0
 	 */
 	virtual
-	E_type
+	Ekcal_type
 	getRT() const {
 		return 1.0;
 	}
@@ -352,7 +352,7 @@ E_type
 InteractionEnergyBasePair::
 getE_init() const
 {
-	return -1.0;
+	return Ekcal_2_E( -1.0 );
 }
 
 ////////////////////////////////////////////////////////////////////////////
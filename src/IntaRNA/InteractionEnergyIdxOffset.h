@@ -56,6 +56,12 @@ public:
 	 */
 	void setOffset2(size_t offset2);
 
+	/**
+	 * Access to the wrapped energy object used for computations
+	 * @return the wrapped energy object
+	 */
+	const InteractionEnergy & getEnergyOriginal() const;
+
 
 	///////////////  OVERWRITTEN MEMBERS USING OFFSET  /////////////////
 
@@ -325,7 +331,7 @@ public:
 	 * @return the dangling end probability for the left side of the interaction
 	 */
 	virtual
-	E_type
+	Z_type
 	getPr_danglingLeft( const size_t i1, const size_t j1, const size_t i2, const size_t j2 ) const;
 
 	/**
@@ -343,7 +349,7 @@ public:
 	 * @return the dangling end probability for the right side of the interaction
 	 */
 	virtual
-	E_type
+	Z_type
 	getPr_danglingRight( const size_t i1, const size_t j1, const size_t i2, const size_t j2 ) const;
 
 
@@ -383,7 +389,7 @@ public:
 	 * Access to the normalized temperature for Boltzmann weight computation
 	 */
 	virtual
-	E_type
+	Ekcal_type
 	getRT() const;
 
 
@@ -474,6 +480,16 @@ getOffset1() const
 
 //////////////////////////////////////////////////////////////////////////
 
+inline
+const InteractionEnergy &
+InteractionEnergyIdxOffset::
+getEnergyOriginal() const
+{
+	return energyOriginal;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 inline
 void
 InteractionEnergyIdxOffset::
@@ -699,7 +715,7 @@ getE_endRight( const size_t j1, const size_t j2 ) const
 //////////////////////////////////////////////////////////////////////////
 
 inline
-E_type
+Z_type
 InteractionEnergyIdxOffset::
 getPr_danglingLeft( const size_t i1, const size_t j1, const size_t i2, const size_t j2 ) const
 {
@@ -709,7 +725,7 @@ getPr_danglingLeft( const size_t i1, const size_t j1, const size_t i2, const siz
 //////////////////////////////////////////////////////////////////////////
 
 inline
-E_type
+Z_type
 InteractionEnergyIdxOffset::
 getPr_danglingRight( const size_t i1, const size_t j1, const size_t i2, const size_t j2 ) const
 {
@@ -755,7 +771,7 @@ getIndex2( const Interaction::BasePair & bp ) const
 ////////////////////////////////////////////////////////////////////////////
 
 inline
-E_type
+Ekcal_type
 InteractionEnergyIdxOffset::
 getRT() const
 {
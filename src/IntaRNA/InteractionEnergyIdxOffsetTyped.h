@@ -0,0 +1,278 @@
+
+#ifndef INTARNA_INTERACTIONENERGYIDXOFFSETTYPED_H_
+#define INTARNA_INTERACTIONENERGYIDXOFFSETTYPED_H_
+
+#include "IntaRNA/InteractionEnergy.h"
+
+namespace IntaRNA {
+
+/**
+ * Non-polymorphic counterpart of InteractionEnergyIdxOffset for a given
+ * concrete energy type, where indices are shifted by a given positive offset
+ * (shifted towards infinity).
+ *
+ * All calls are statically bound to the implementations of EnergyType such
+ * that they can be inlined into the dynamic programming kernels of the
+ * predictors, which are templated on the energy access type. Only the
+ * subset of the energy interface used within these kernels is provided.
+ *
+ * @author Martin Mann
+ *
+ */
+template < class EnergyType >
+class InteractionEnergyIdxOffsetTyped
+{
+public:
+
+	/**
+	 * construction
+	 *
+	 * @param energyOriginal wrapped energy object used for computations
+	 * @param offset1 the index offset for sequence 1
+	 * @param offset2 the index offset for sequence 2
+	 */
+	InteractionEnergyIdxOffsetTyped( const EnergyType & energyOriginal
+								, const size_t offset1 = 0
+								, const size_t offset2 = 0 );
+
+	/**
+	 * Provides the ED penalty for making a region with sequence 1 accessible
+	 * @param i1 the start of the accessible region (shifted by offset)
+	 * @param j1 the end of the accessible region (shifted by offset)
+	 * @return the ED value for [i1,j1]
+	 */
+	E_type
+	getED1( const size_t i1, const size_t j1 ) const;
+
+	/**
+	 * Provides the ED penalty for making a region with (the reversed)
+	 * sequence 2 accessible
+	 * @param i2 the start of the accessible region (shifted by offset)
+	 * @param j2 the end of the accessible region (shifted by offset)
+	 * @return the ED value for [i2,j2]
+	 */
+	E_type
+	getED2( const size_t i2, const size_t j2 ) const;
+
+	/**
+	 * Checks whether or not two positions (shifted by offset) can form a base pair
+	 * @param i1 index in first sequence
+	 * @param i2 index in second sequence
+	 * @return true if seq1(i1) can form a base pair with seq2(i2)
+	 */
+	bool
+	areComplementary( const size_t i1, const size_t i2 ) const;
+
+	/**
+	 * Provides the overall energy of an interaction (shifted by offset),
+	 * see InteractionEnergy::getE()
+	 * @param i1 the index of the first sequence interacting with i2
+	 * @param j1 the index of the first sequence interacting with j2 with i1<=j1
+	 * @param i2 the index of the second sequence interacting with i1
+	 * @param j2 the index of the second sequence interacting with j1 with i2<=j2
+	 * @param hybridE the hybridization energy for the interaction
+	 * @return the overall interaction energy
+	 */
+	E_type
+	getE( const size_t i1, const size_t j1
+			, const size_t i2, const size_t j2
+			, const E_type hybridE ) const;
+
+	/**
+	 * Provides the duplex initiation energy.
+	 * @return the energy for duplex initiation
+	 */
+	E_type
+	getE_init() const;
+
+	/**
+	 * Provides the energy for the interaction loop closed by the
+	 * intermolecular base pairs (i1,i2) and (j1,j2) (shifted by offset)
+	 * @param i1 the index of the first sequence (<j1) interacting with i2
+	 * @param j1 the index of the first sequence (>i1) interacting with j2
+	 * @param i2 the index of the second sequence (<j2) interacting with i1
+	 * @param j2 the index of the second sequence (>i2) interacting with j1
+	 * @return the loop energy or E_INF if not a valid loop
+	 */
+	E_type
+	getE_interLeft( const size_t i1, const size_t j1, const size_t i2, const size_t j2 ) const;
+
+	/**
+	 * Access to the maximal size of an unpaired stretch within seq1 within
+	 * an interaction.
+	 * @return the maximal loop length
+	 */
+	size_t
+	getMaxInternalLoopSize1() const;
+
+	/**
+	 * Access to the maximal size of an unpaired stretch within seq2 within
+	 * an interaction.
+	 * @return the maximal loop length
+	 */
+	size_t
+	getMaxInternalLoopSize2() const;
+
+	/**
+	 * Access to the accessibility object of the first sequence
+	 * (including sequence access)
+	 * @return the accessibility object for the first sequence
+	 */
+	const Accessibility &
+	getAccessibility1() const;
+
+	/**
+	 * Access to the accessibility object of the second sequence
+	 * (including sequence access)
+	 * @return the reverse accessibility object for the second sequence
+	 */
+	const ReverseAccessibility &
+	getAccessibility2() const;
+
+protected:
+
+	//! wrapped energy object used for computations
+	const EnergyType & energyOriginal;
+
+	//! the index offset in sequence 1
+	const size_t offset1;
+
+	//! the index offset in sequence 2
+	const size_t offset2;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+inline
+InteractionEnergyIdxOffsetTyped<EnergyType>::
+InteractionEnergyIdxOffsetTyped( const EnergyType & energyOriginal
+			, const size_t offset1
+			, const size_t offset2 )
+ :
+	energyOriginal(energyOriginal)
+	, offset1(offset1)
+	, offset2(offset2)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+inline
+E_type
+InteractionEnergyIdxOffsetTyped<EnergyType>::
+getED1( const size_t i1, const size_t j1 ) const
+{
+	return energyOriginal.EnergyType::getED1( i1+offset1, j1+offset1 );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+inline
+E_type
+InteractionEnergyIdxOffsetTyped<EnergyType>::
+getED2( const size_t i2, const size_t j2 ) const
+{
+	return energyOriginal.EnergyType::getED2( i2+offset2, j2+offset2 );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+inline
+bool
+InteractionEnergyIdxOffsetTyped<EnergyType>::
+areComplementary( const size_t i1, const size_t i2 ) const
+{
+	return energyOriginal.EnergyType::areComplementary( i1+offset1, i2+offset2 );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+inline
+E_type
+InteractionEnergyIdxOffsetTyped<EnergyType>::
+getE( const size_t i1, const size_t j1
+		, const size_t i2, const size_t j2
+		, const E_type hybridE ) const
+{
+	return energyOriginal.EnergyType::getE( i1+offset1, j1+offset1, i2+offset2, j2+offset2, hybridE );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+inline
+E_type
+InteractionEnergyIdxOffsetTyped<EnergyType>::
+getE_init() const
+{
+	return energyOriginal.EnergyType::getE_init();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+inline
+E_type
+InteractionEnergyIdxOffsetTyped<EnergyType>::
+getE_interLeft( const size_t i1, const size_t j1, const size_t i2, const size_t j2 ) const
+{
+	return energyOriginal.EnergyType::getE_interLeft( i1+offset1, j1+offset1, i2+offset2, j2+offset2 );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+inline
+size_t
+InteractionEnergyIdxOffsetTyped<EnergyType>::
+getMaxInternalLoopSize1() const
+{
+	return energyOriginal.getMaxInternalLoopSize1();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+inline
+size_t
+InteractionEnergyIdxOffsetTyped<EnergyType>::
+getMaxInternalLoopSize2() const
+{
+	return energyOriginal.getMaxInternalLoopSize2();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+inline
+const Accessibility &
+InteractionEnergyIdxOffsetTyped<EnergyType>::
+getAccessibility1() const
+{
+	return energyOriginal.getAccessibility1();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyType >
+inline
+const ReverseAccessibility &
+InteractionEnergyIdxOffsetTyped<EnergyType>::
+getAccessibility2() const
+{
+	return energyOriginal.getAccessibility2();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_INTERACTIONENERGYIDXOFFSETTYPED_H_ */
@@ -24,6 +24,8 @@ InteractionEnergyVrna::InteractionEnergyVrna(
 		, const size_t maxInternalLoopSize1
 		, const size_t maxInternalLoopSize2
 		, const bool initES
+		, const EsMatrix * const esValues1
+		, const EsMatrix * const esValues2
 	)
  :
 	InteractionEnergy(accS1, accS2, maxInternalLoopSize1, maxInternalLoopSize2)
@@ -35,23 +37,36 @@ InteractionEnergyVrna::InteractionEnergyVrna(
 	, bpGC( BP_pair[RnaSequence::getCodeForChar('G')][RnaSequence::getCodeForChar('C')] )
 	, esValues1(NULL)
 	, esValues2(NULL)
+	, esValues1local(NULL)
+	, esValues2local(NULL)
 {
-	vrna_md_defaults_reset( &foldModel );
+	// broadcast of model details to VRNA global variables is not threadsafe
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_callingVRNA)
+#endif
+	{ vrna_md_defaults_reset( &foldModel ); }
+
+	// precompute loop energy tables
+	initLoopTables();
 
 	// init ES values if needed
+	// (threadsafe since based on local fold compounds only)
 	if (initES) {
-		// VRNA computation not completely threadsafe
-#if INTARNA_MULITHREADING
-		#pragma omp critical(intarna_omp_callingVRNA)
-#endif
-		{
-			// create ES container to be filled
-			esValues1 = new EsMatrix();
-			esValues2 = new EsMatrix();
-			// fill ES container
-			computeES( accS1, *esValues1 );
-			computeES( accS2, *esValues2 );
-		} // omp critical(intarna_omp_callingVRNA)
+		// use precomputed ES values if available or compute locally
+		if (esValues1 != NULL) {
+			this->esValues1 = esValues1;
+		} else {
+			esValues1local = new EsMatrix();
+			computeES( accS1, vrnaHandler, *esValues1local );
+			this->esValues1 = esValues1local;
+		}
+		if (esValues2 != NULL) {
+			this->esValues2 = esValues2;
+		} else {
+			esValues2local = new EsMatrix();
+			computeES( accS2, vrnaHandler, *esValues2local );
+			this->esValues2 = esValues2local;
+		}
 	}
 }
 
@@ -64,8 +79,8 @@ InteractionEnergyVrna::~InteractionEnergyVrna()
 		free(foldParams);
 		foldParams = NULL;
 	}
-	 INTARNA_CLEANUP(esValues1);
-	 INTARNA_CLEANUP(esValues2);
+	 INTARNA_CLEANUP(esValues1local);
+	 INTARNA_CLEANUP(esValues2local);
 
 }
 
@@ -93,7 +108,7 @@ getBestE_interLoop() const
 	for (std::set<int>::const_iterator p1=basePairCodes.begin(); p1!=basePairCodes.end(); p1++) {
 	for (std::set<int>::const_iterator p2=basePairCodes.begin(); p2!=basePairCodes.end(); p2++) {
 		minStackingE = std::min( minStackingE
-				, (E_type)E_IntLoop(	0	// unpaired region 1
+				, Edcal_2_E( E_IntLoop(	0	// unpaired region 1
 						, 0	// unpaired region 2
 						, *p1	// type BP (i1,i2)
 						, *p2	// type BP (j2,j1)
@@ -102,8 +117,8 @@ getBestE_interLoop() const
 						, 0
 						, 0
 						, foldParams)
-					// correct from dcal/mol to kcal/mol
-					/ (E_type)100.0
+					// correct from dcal/mol to energy unit
+					)
 				);
 	}
 	}
@@ -128,7 +143,7 @@ getBestE_dangling() const
 	}
 	}
 	// get minimal energy for any base pair code combination
-	E_type minDangleE = std::numeric_limits<E_type>::infinity();
+	E_type minDangleE = E_INF;
 
 	// get codes for the sequence alphabet
 	const RnaSequence::CodeSeq_type alphabet = RnaSequence::getCodeForString(RnaSequence::SequenceAlphabet);
@@ -138,14 +153,14 @@ getBestE_dangling() const
 	for (size_t i=0; i<alphabet.size(); i++) {
 	for (size_t j=0; j<alphabet.size(); j++) {
 		minDangleE = std::min( minDangleE
-				, (E_type)E_Stem( *p1
+				, Edcal_2_E( E_Stem( *p1
 					  , alphabet.at(i)
 					  , alphabet.at(j)
 					  , 1 // is an external loop
 					  , foldParams
 					  )
-					// correct from dcal/mol to kcal/mol
-					/ (E_type)100.0
+					// correct from dcal/mol to energy unit
+					)
 				);
 	}
 	}
@@ -158,7 +173,55 @@ getBestE_dangling() const
 
 void
 InteractionEnergyVrna::
-computeES( const Accessibility & acc, InteractionEnergyVrna::EsMatrix & esToFill )
+initLoopTables()
+{
+	const size_t maxU1 = getMaxInternalLoopSize1();
+	const size_t maxU2 = getMaxInternalLoopSize2();
+
+	loopClass.resize( (maxU1+1)*(maxU2+1) );
+	loopBaseE.resize( (maxU1+1)*(maxU2+1)*pairTypeNumber*pairTypeNumber, 0 );
+
+	for (size_t u1=0; u1<=maxU1; u1++) {
+	for (size_t u2=0; u2<=maxU2; u2++) {
+		// get loop class (see E_IntLoop())
+		const size_t nl = std::max(u1,u2), ns = std::min(u1,u2);
+		LoopClass lc = LC_generic;
+		if (ns == 0) {
+			lc = LC_noMismatch;
+		} else if (ns == 1) {
+			lc = (nl == 1 ? LC_1x1 : (nl == 2 ? (u1 == 1 ? LC_1x2 : LC_2x1) : LC_1xn));
+		} else if (ns == 2 && nl <= 3) {
+			lc = (nl == 2 ? LC_2x2 : LC_2x3);
+		}
+		loopClass[u1*(maxU2+1)+u2] = (unsigned char)lc;
+
+		// precompute mismatch independent energy contributions
+		for (int type=0; type<(int)pairTypeNumber; type++) {
+		for (int type_2=0; type_2<(int)pairTypeNumber; type_2++) {
+			// loop energy for mismatch code 0
+			int loopE = E_IntLoop( (int)u1, (int)u2, type, type_2, 0, 0, 0, 0, foldParams );
+			// remove according mismatch contributions
+			switch (lc) {
+			case LC_noMismatch : break;
+			case LC_1xn : loopE -= foldParams->mismatch1nI[type][0][0] + foldParams->mismatch1nI[type_2][0][0]; break;
+			case LC_2x3 : loopE -= foldParams->mismatch23I[type][0][0] + foldParams->mismatch23I[type_2][0][0]; break;
+			case LC_generic : loopE -= foldParams->mismatchI[type][0][0] + foldParams->mismatchI[type_2][0][0]; break;
+			default : loopE = 0; // not used
+			}
+			loopBaseE[ getLoopTableIndex( u1, u2, type, type_2 ) ] = loopE;
+		}
+		}
+	}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+InteractionEnergyVrna::
+computeES( const Accessibility & acc
+		, const VrnaHandler & vrnaHandler
+		, InteractionEnergyVrna::EsMatrix & esToFill )
 {
 
 	// prepare container
@@ -166,7 +229,8 @@ computeES( const Accessibility & acc, InteractionEnergyVrna::EsMatrix & esToFill
 
 	// sequence length
 	const int seqLength = (int)acc.getSequence().size();
-	const E_type RT = getRT();
+	const Ekcal_type RT = vrnaHandler.getRT();
+	vrna_md_t foldModel = vrnaHandler.getModel();
 
 	// VRNA compatible data structures
 	char * sequence = (char *) vrna_alloc(sizeof(char) * (seqLength + 1));
@@ -228,7 +292,7 @@ computeES( const Accessibility & acc, InteractionEnergyVrna::EsMatrix & esToFill
 					esToFill(i,j) = E_INF;
 				} else {
 					// ES energy = -RT*log( Qm )
-					esToFill(i,j) =  (E_type)( - RT*( std::log(qm_val)
+					esToFill(i,j) =  Ekcal_2_E( - RT*( std::log(qm_val)
 													+((FLT_OR_DBL)(j-i+1))*std::log(foldData->exp_params->pf_scale)));
 				}
 			}
@@ -11,6 +11,7 @@ extern "C" {
 	#include <ViennaRNA/model.h>
 	#include <ViennaRNA/params.h>
 	#include <ViennaRNA/loop_energies.h>
+	#include <ViennaRNA/energy_const.h>
 }
 #ifndef VIENNA_RNA_PAIR_MAT_H
 #define VIENNA_RNA_PAIR_MAT_H
@@ -21,6 +22,8 @@ extern "C" {
 
 #include <boost/numeric/ublas/triangular.hpp>
 
+#include <vector>
+
 namespace IntaRNA {
 
 // http://www.tbi.univie.ac.at/RNA/ViennaRNA/doc/RNAlib-2.3.0.pdf
@@ -35,7 +38,8 @@ class InteractionEnergyVrna: public InteractionEnergy {
 
 public:
 
-
+	//! matrix to store ES values (upper triangular matrix)
+	typedef boost::numeric::ublas::triangular_matrix<E_type, boost::numeric::ublas::upper> EsMatrix;
 
 	/**
 	 * Construct energy utility object given the accessibility ED values for
@@ -53,6 +57,14 @@ public:
 	 *          for an intermolecular loop closed by base pairs (i1,i2) and
 	 *          (j1,j2) : (j2-i2+1) <= maxInternalLoopSize
 	 * @param initES whether or not ES values are to be computed
+	 * @param esValues1 if not NULL (and initES), precomputed ES values of
+	 *          seq1 (see computeES()) that are used instead of a recomputation;
+	 *          the matrix is not copied and has to exist until this object
+	 *          is destroyed
+	 * @param esValues2 if not NULL (and initES), precomputed ES values of
+	 *          seq2 (see computeES()) that are used instead of a recomputation;
+	 *          the matrix is not copied and has to exist until this object
+	 *          is destroyed
 	 *
 	 */
 	InteractionEnergyVrna( const Accessibility & accS1
@@ -61,10 +73,28 @@ public:
 					, const size_t maxInternalLoopSize1 = 16
 					, const size_t maxInternalLoopSize2 = 16
 					, const bool initES = false
+					, const EsMatrix * const esValues1 = NULL
+					, const EsMatrix * const esValues2 = NULL
 				);
 
 	virtual ~InteractionEnergyVrna();
 
+	/**
+	 * Computes the ES values for the given accessibility object. Since the
+	 * ES values depend on a single sequence only, they can be computed once
+	 * and shared among all energy objects for this sequence.
+	 *
+	 * @param acc the accessibility object for the sequence to compute the ES
+	 *          values for (indexing of the ES values follows acc.getSequence())
+	 * @param vrnaHandler the VRNA parameter handler to be used
+	 * @param esToFill the container to write the ES values to
+	 */
+	static
+	void
+	computeES( const Accessibility & acc
+			, const VrnaHandler & vrnaHandler
+			, EsMatrix & esToFill );
+
 
 	/**
 	 * Provides the ensemble energy (ES) of all intramolecular substructures
@@ -233,7 +263,7 @@ public:
 	 * @return R*temperature
 	 */
 	virtual
-	E_type
+	Ekcal_type
 	getRT() const;
 
 	/**
@@ -276,7 +306,7 @@ protected:
 	vrna_param_t * foldParams;
 
 	//! the RT constant to be used for Boltzmann weight computations
-	E_type RT;
+	Ekcal_type RT;
 
 	//! base pair code for (C,G)
 	const int bpCG;
@@ -284,14 +314,81 @@ protected:
 	//! base pair code for (G,C)
 	const int bpGC;
 
-	//! matrix to store ES values (upper triangular matrix)
-	typedef boost::numeric::ublas::triangular_matrix<E_type, boost::numeric::ublas::upper> EsMatrix;
+	//! the ES values for seq1 if computed or provided (otherwise NULL)
+	const EsMatrix * esValues1;
 
-	//! the ES values for seq1 if computed (otherwise NULL)
-	EsMatrix * esValues1;
+	//! the ES values for seq2 if computed or provided (otherwise NULL)
+	const EsMatrix * esValues2;
 
-	//! the ES values for seq2 if computed (otherwise NULL)
-	EsMatrix * esValues2;
+	//! the ES values for seq1 if computed locally (to be deleted)
+	EsMatrix * esValues1local;
+
+	//! the ES values for seq2 if computed locally (to be deleted)
+	EsMatrix * esValues2local;
+
+	/**
+	 * Classes of interior loops that differ in the way VRNA's E_IntLoop()
+	 * combines loop size, base pair type and mismatch contributions.
+	 */
+	enum LoopClass {
+		LC_noMismatch, //!< stacking or bulge : no mismatch dependency
+		LC_1x1, //!< 1x1 interior loop : int11 lookup
+		LC_1x2, //!< 1x2 interior loop : int21 lookup
+		LC_2x1, //!< 2x1 interior loop : int21 lookup (reversed)
+		LC_2x2, //!< 2x2 interior loop : int22 lookup
+		LC_1xn, //!< 1xn interior loop : size term + mismatch1nI
+		LC_2x3, //!< 2x3 interior loop : size term + mismatch23I
+		LC_generic //!< generic interior loop : size term + mismatchI
+	};
+
+	//! number of base pair type codes used by VRNA
+	static const size_t pairTypeNumber = NBPAIRS+1;
+
+	//! loop class for each combination of unpaired bases (u1,u2), indexed
+	//! by u1*(getMaxInternalLoopSize2()+1)+u2
+	std::vector< unsigned char > loopClass;
+
+	//! mismatch independent loop energy contribution (dcal/mol) for each
+	//! combination of unpaired bases and base pair types, indexed by
+	//! getLoopTableIndex()
+	std::vector< int > loopBaseE;
+
+	/**
+	 * Precomputes loopClass and loopBaseE via E_IntLoop() for all loop sizes
+	 * up to the maximal internal loop sizes.
+	 */
+	void
+	initLoopTables();
+
+	/**
+	 * Provides the index of a loop within loopBaseE.
+	 * @param u1 the number of unpaired bases in seq1
+	 * @param u2 the number of unpaired bases in seq2
+	 * @param type the type of the left (outer) base pair
+	 * @param type_2 the type of the right (inner) base pair (reversed)
+	 * @return the index within loopBaseE
+	 */
+	size_t
+	getLoopTableIndex( const size_t u1, const size_t u2, const int type, const int type_2 ) const;
+
+	/**
+	 * Table-based equivalent of VRNA's E_IntLoop() for loops within the
+	 * maximal internal loop sizes.
+	 *
+	 * @param u1 the number of unpaired bases in seq1
+	 * @param u2 the number of unpaired bases in seq2
+	 * @param type the type of the left (outer) base pair
+	 * @param type_2 the type of the right (inner) base pair (reversed)
+	 * @param si1 the code of the base following the left base pair in seq1
+	 * @param sj1 the code of the base following the left base pair in seq2
+	 * @param sp1 the code of the base preceding the right base pair in seq1
+	 * @param sq1 the code of the base preceding the right base pair in seq2
+	 * @return the loop energy in dcal/mol
+	 */
+	int
+	getE_intLoop( const size_t u1, const size_t u2
+				, const int type, const int type_2
+				, const int si1, const int sj1, const int sp1, const int sq1 ) const;
 
 	/**
 	 * Checks whether or not a given base pair is a GC base pair
@@ -302,14 +399,6 @@ protected:
 	bool
 	isGC( const size_t i1, const size_t i2 ) const;
 
-	/**
-	 * Computes the ES values and fills esValues container
-	 * @param acc the accessibility object for the sequence to compute the ES values for
-	 * @param esToFill the container to write the ES values to
-	 */
-	void
-	computeES( const Accessibility & acc, EsMatrix & esToFill );
-
 };
 
 
@@ -323,7 +412,7 @@ InteractionEnergyVrna::
 getE_init() const
 {
 	// init term is sequence independent
-	return (E_type)foldParams->DuplexInit/(E_type)100.0;
+	return Edcal_2_E( foldParams->DuplexInit );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -334,7 +423,7 @@ InteractionEnergyVrna::
 getE_endLeft( const size_t i1, const size_t i2 ) const
 {
 	// VRNA non-GC penalty
-	return isGC(i1,i2) ? 0.0 : (E_type)foldParams->TerminalAU/(E_type)100.0;
+	return isGC(i1,i2) ? 0.0 : Edcal_2_E( foldParams->TerminalAU );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -345,13 +434,13 @@ InteractionEnergyVrna::
 getE_endRight( const size_t j1, const size_t j2 ) const
 {
 	// VRNA non-GC penalty
-	return isGC(j1,j2) ? 0.0 : (E_type)foldParams->TerminalAU/(E_type)100.0;
+	return isGC(j1,j2) ? 0.0 : Edcal_2_E( foldParams->TerminalAU );
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
 inline
-E_type
+Ekcal_type
 InteractionEnergyVrna::
 getRT() const
 {
@@ -365,7 +454,53 @@ E_type
 InteractionEnergyVrna::
 getBestE_end() const
 {
-	return (E_type)std::min(0,foldParams->TerminalAU)/(E_type)100.0;
+	return Edcal_2_E( std::min(0,foldParams->TerminalAU) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+InteractionEnergyVrna::
+getLoopTableIndex( const size_t u1, const size_t u2, const int type, const int type_2 ) const
+{
+	return ((u1*(getMaxInternalLoopSize2()+1) + u2)*pairTypeNumber + type)*pairTypeNumber + type_2;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+int
+InteractionEnergyVrna::
+getE_intLoop( const size_t u1, const size_t u2
+			, const int type, const int type_2
+			, const int si1, const int sj1, const int sp1, const int sq1 ) const
+{
+	// same case distinction as VRNA's E_IntLoop() with precomputed size terms
+	switch( loopClass[ u1*(getMaxInternalLoopSize2()+1) + u2 ] ) {
+	case LC_noMismatch :
+		return loopBaseE[ getLoopTableIndex( u1, u2, type, type_2 ) ];
+	case LC_1x1 :
+		return foldParams->int11[type][type_2][si1][sj1];
+	case LC_1x2 :
+		return foldParams->int21[type][type_2][si1][sq1][sj1];
+	case LC_2x1 :
+		return foldParams->int21[type_2][type][sq1][si1][sp1];
+	case LC_2x2 :
+		return foldParams->int22[type][type_2][si1][sp1][sq1][sj1];
+	case LC_1xn :
+		return loopBaseE[ getLoopTableIndex( u1, u2, type, type_2 ) ]
+				+ foldParams->mismatch1nI[type][si1][sj1]
+				+ foldParams->mismatch1nI[type_2][sq1][sp1];
+	case LC_2x3 :
+		return loopBaseE[ getLoopTableIndex( u1, u2, type, type_2 ) ]
+				+ foldParams->mismatch23I[type][si1][sj1]
+				+ foldParams->mismatch23I[type_2][sq1][sp1];
+	default : // LC_generic
+		return loopBaseE[ getLoopTableIndex( u1, u2, type, type_2 ) ]
+				+ foldParams->mismatchI[type][si1][sj1]
+				+ foldParams->mismatchI[type_2][sq1][sp1];
+	}
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -378,19 +513,30 @@ getE_interLeft( const size_t i1, const size_t j1, const size_t i2, const size_t
 	// if valid internal loop
 	if ( isValidInternalLoop(i1,j1,i2,j2) ) {
 		assert( i1!=j1 && i2!=j2 );
-		// Vienna RNA : compute internal loop / stacking energy for base pair [i1,i2]
-		return (E_type)E_IntLoop(	(int)j1-i1-1	// unpaired region 1
-							, (int)j2-i2-1	// unpaired region 2
-							, BP_pair[accS1.getSequence().asCodes().at(i1)][accS2.getSequence().asCodes().at(i2)]	// type BP (i1,i2)
-							, BP_pair[accS2.getSequence().asCodes().at(j2)][accS1.getSequence().asCodes().at(j1)]	// type BP (j2,j1)
-							, accS1.getSequence().asCodes().at(i1+1)
-							, accS2.getSequence().asCodes().at(i2+1)
-							, accS1.getSequence().asCodes().at(j1-1)
-							, accS2.getSequence().asCodes().at(j2-1)
-							, foldParams)
-				// correct from dcal/mol to kcal/mol
-				/ (E_type)100.0
-				;
+		// unchecked access since indices are covered by isValidInternalLoop()
+		const RnaSequence::CodeSeq_type & s1 = accS1.getSequence().asCodes();
+		const RnaSequence::CodeSeq_type & s2 = accS2.getSequence().asCodes();
+		// compute internal loop / stacking energy for base pair [i1,i2]
+		const int loopE = getE_intLoop( j1-i1-1	// unpaired region 1
+							, j2-i2-1	// unpaired region 2
+							, BP_pair[s1[i1]][s2[i2]]	// type BP (i1,i2)
+							, BP_pair[s2[j2]][s1[j1]]	// type BP (j2,j1)
+							, s1[i1+1]
+							, s2[i2+1]
+							, s1[j1-1]
+							, s2[j2-1] );
+#if INTARNA_IN_DEBUG_MODE
+		// sanity check : identical to Vienna RNA loop energy
+		if (loopE != E_IntLoop( (int)j1-i1-1, (int)j2-i2-1
+							, BP_pair[s1[i1]][s2[i2]], BP_pair[s2[j2]][s1[j1]]
+							, s1[i1+1], s2[i2+1], s1[j1-1], s2[j2-1]
+							, foldParams))
+		{
+			throw std::runtime_error("InteractionEnergyVrna::getE_interLeft("+toString(i1)+","+toString(j1)+","+toString(i2)+","+toString(j2)+") : table-based energy differs from E_IntLoop()");
+		}
+#endif
+		// correct from dcal/mol to energy unit
+		return Edcal_2_E( loopE );
 	} else {
 		return E_INF;
 	}
@@ -404,14 +550,14 @@ InteractionEnergyVrna::
 getE_danglingLeft( const size_t i1, const size_t i2 ) const
 {
 	// Vienna RNA : dangling end contribution
-	return (E_type) E_Stem( BP_pair[accS1.getSequence().asCodes().at(i1)][accS2.getSequence().asCodes().at(i2)]
+	return Edcal_2_E( E_Stem( BP_pair[accS1.getSequence().asCodes().at(i1)][accS2.getSequence().asCodes().at(i2)]
 							  , ( i1==0 ? -1 : accS1.getSequence().asCodes().at(i1-1) )
 							  , ( i2==0 ? -1 : accS2.getSequence().asCodes().at(i2-1) )
 							  , 1 // is an external loop
 							  , foldParams
 							  )
-					// correct from dcal/mol to kcal/mol
-							  /(E_type)100.0
+					// correct from dcal/mol to energy unit
+							  )
 			// substract closing penalty
 			- getE_endLeft(i1,i2);
 }
@@ -424,14 +570,14 @@ InteractionEnergyVrna::
 getE_danglingRight( const size_t j1, const size_t j2 ) const
 {
 	// Vienna RNA : dangling end contribution (reverse base pair to be sequence end conform)
-	return (E_type) E_Stem( BP_pair[accS2.getSequence().asCodes().at(j2)][accS1.getSequence().asCodes().at(j1)]
+	return Edcal_2_E( E_Stem( BP_pair[accS2.getSequence().asCodes().at(j2)][accS1.getSequence().asCodes().at(j1)]
 							  , ( j2+1>=accS2.getSequence().size() ? -1 : accS2.getSequence().asCodes().at(j2+1) )
 							  , ( j1+1>=accS1.getSequence().size() ? -1 : accS1.getSequence().asCodes().at(j1+1) )
 							  , 1 // is an external loop
 							  , foldParams
 							  )
-					// correct from dcal/mol to kcal/mol
-							  /(E_type)100.0
+					// correct from dcal/mol to energy unit
+							  )
 			// substract closing penalty
 			- getE_endRight(j1,j2);
 }
@@ -490,7 +636,7 @@ E_type
 InteractionEnergyVrna::
 getE_multiUnpaired( const size_t numUnpaired ) const
 {
-	return numUnpaired * ((E_type)foldParams->MLbase) / (E_type)100.0;
+	return Edcal_2_E( (int)numUnpaired * foldParams->MLbase );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -500,10 +646,10 @@ E_type
 InteractionEnergyVrna::
 getE_multiHelix( const size_t j1, const size_t j2 ) const
 {
-	return ((E_type)foldParams->MLintern[
+	return Edcal_2_E( foldParams->MLintern[
 	                                     BP_pair[accS2.getSequence().asCodes().at(j2)]
 	                                             [accS1.getSequence().asCodes().at(j1)]
-	                                    ]) / (E_type)100.0;
+	                                    ] );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -513,7 +659,7 @@ E_type
 InteractionEnergyVrna::
 getE_multiClosing() const
 {
-	return ((E_type)foldParams->MLclosing) / (E_type)100.0;
+	return Edcal_2_E( foldParams->MLclosing );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,293 @@
+
+#ifndef INTARNA_MATRIXARENA_H_
+#define INTARNA_MATRIXARENA_H_
+
+#include "IntaRNA/general.h"
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include <algorithm>
+#include <stdexcept>
+
+namespace IntaRNA {
+
+/**
+ * Memory arena that provides 2D matrices of arbitrary dimensions from a few
+ * large contiguous memory blocks instead of one heap allocation per matrix.
+ *
+ * Matrices are handed out in allocation order from the current block; a new
+ * block (slab of minBlockSize elements or the size of the requested matrix
+ * if larger) is only added if the remaining blocks cannot hold a requested
+ * matrix. Thus, the memory overhead per block is bounded by the size of the
+ * largest matrix. clear() releases all matrices at once but keeps the blocks
+ * such that subsequent allocations (e.g. of the next prediction) reuse the
+ * memory.
+ *
+ * Pointers to matrices and their elements stay valid until clear() is called.
+ *
+ * @author Martin Mann
+ *
+ */
+template < typename T >
+class MatrixArena
+{
+
+public:
+
+	/**
+	 * Row-major 2D matrix whose elements are located within the arena.
+	 * Provides the subset of the boost::numeric::ublas::matrix interface
+	 * used by the predictors.
+	 */
+	class Matrix
+	{
+	public:
+
+		/**
+		 * Number of rows
+		 * @return the first dimension of the matrix
+		 */
+		size_t size1() const { return rows; }
+
+		/**
+		 * Number of columns
+		 * @return the second dimension of the matrix
+		 */
+		size_t size2() const { return cols; }
+
+		/**
+		 * Access to an element
+		 * @param i the row index (< size1())
+		 * @param j the column index (< size2())
+		 * @return the element at (i,j)
+		 */
+		T & operator()( const size_t i, const size_t j ) {
+#if INTARNA_IN_DEBUG_MODE
+			if (i >= rows || j >= cols) throw std::runtime_error("MatrixArena::Matrix() : index out of range");
+#endif
+			return data[i*cols+j];
+		}
+
+		/**
+		 * Constant access to an element
+		 * @param i the row index (< size1())
+		 * @param j the column index (< size2())
+		 * @return the element at (i,j)
+		 */
+		const T & operator()( const size_t i, const size_t j ) const {
+#if INTARNA_IN_DEBUG_MODE
+			if (i >= rows || j >= cols) throw std::runtime_error("MatrixArena::Matrix() : index out of range");
+#endif
+			return data[i*cols+j];
+		}
+
+	protected:
+
+		friend class MatrixArena;
+
+		//! the first element within the arena
+		T * data;
+		//! the number of rows
+		size_t rows;
+		//! the number of columns
+		size_t cols;
+
+	};
+
+public:
+
+	/**
+	 * Construction of an empty arena
+	 * @param minBlockSize the minimal number of elements per memory block
+	 */
+	MatrixArena( const size_t minBlockSize = 1<<18 );
+
+	/**
+	 * Destruction : frees all memory blocks
+	 */
+	virtual ~MatrixArena();
+
+	/**
+	 * Provides a new matrix of the given dimensions. The element values are
+	 * undefined.
+	 * @param size1 the number of rows
+	 * @param size2 the number of columns
+	 * @return the new matrix (owned by the arena)
+	 */
+	Matrix *
+	allocate( const size_t size1, const size_t size2 );
+
+	/**
+	 * Releases all matrices; the memory is kept for reuse
+	 */
+	void
+	clear();
+
+	/**
+	 * Number of matrices currently allocated
+	 * @return the number of matrices allocated since the last clear()
+	 */
+	size_t
+	getMatrixNumber() const;
+
+	/**
+	 * Number of elements currently used by allocated matrices
+	 * @return the overall size of all allocated matrices
+	 */
+	size_t
+	getSize() const;
+
+	/**
+	 * Number of elements reserved by the memory blocks
+	 * @return the overall capacity of the arena
+	 */
+	size_t
+	getCapacity() const;
+
+protected:
+
+	//! the minimal number of elements per memory block
+	const size_t minBlockSize;
+
+	//! the memory blocks (deque to keep elements in place when adding blocks)
+	std::deque< std::vector<T> > blocks;
+
+	//! the overall number of elements of all blocks
+	size_t capacity;
+
+	//! the block to allocate the next matrix from
+	size_t curBlock;
+
+	//! the number of elements already used within curBlock
+	size_t curBlockUsed;
+
+	//! the number of elements used by allocated matrices
+	size_t used;
+
+	//! the matrix objects (deque to keep pointers valid when adding matrices)
+	std::deque< Matrix > matrices;
+
+	//! the number of matrices in use
+	size_t matricesUsed;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+MatrixArena<T>::
+MatrixArena( const size_t minBlockSize )
+ :
+	minBlockSize( std::max( (size_t)1, minBlockSize ) )
+	, blocks()
+	, capacity(0)
+	, curBlock(0)
+	, curBlockUsed(0)
+	, used(0)
+	, matrices()
+	, matricesUsed(0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+MatrixArena<T>::
+~MatrixArena()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+typename MatrixArena<T>::Matrix *
+MatrixArena<T>::
+allocate( const size_t size1, const size_t size2 )
+{
+	const size_t elements = size1*size2;
+
+	// find block with enough space left
+	while (curBlock < blocks.size() && blocks.at(curBlock).size()-curBlockUsed < elements) {
+		curBlock++;
+		curBlockUsed = 0;
+	}
+	// add new block if needed
+	if (curBlock == blocks.size()) {
+		const size_t blockSize = std::max( elements, minBlockSize );
+		blocks.push_back( std::vector<T>( blockSize ) );
+		capacity += blockSize;
+	}
+
+	// get matrix object
+	if (matricesUsed == matrices.size()) {
+		matrices.push_back( Matrix() );
+	}
+	Matrix & m = matrices[matricesUsed++];
+	m.data = blocks[curBlock].data() + curBlockUsed;
+	m.rows = size1;
+	m.cols = size2;
+
+	// update usage
+	curBlockUsed += elements;
+	used += elements;
+
+	return &m;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+void
+MatrixArena<T>::
+clear()
+{
+	curBlock = 0;
+	curBlockUsed = 0;
+	used = 0;
+	matricesUsed = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+size_t
+MatrixArena<T>::
+getMatrixNumber() const
+{
+	return matricesUsed;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+size_t
+MatrixArena<T>::
+getSize() const
+{
+	return used;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < typename T >
+inline
+size_t
+MatrixArena<T>::
+getCapacity() const
+{
+	return capacity;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_MATRIXARENA_H_ */
@@ -4,6 +4,8 @@
 
 #include "IntaRNA/general.h"
 
+#include <algorithm>
+
 namespace IntaRNA {
 
 /**
@@ -43,6 +45,12 @@ public:
 	//! the maximal energy difference to the mfe of a reported interaction
 	const E_type deltaE;
 
+	//! optional global upper bound of the energy of a reported interaction
+	//! that is monotonically decreasing during prediction (e.g. updated by
+	//! other threads) and thus has to be read atomically (see getMaxE());
+	//! NULL if not used
+	const E_type * maxEglobal;
+
 public:
 
 	/**
@@ -54,16 +62,50 @@ public:
 	 *            sites are allowed for reporting
 	 * @param maxE maximal energy of a reported interaction (<= 0.0)
 	 * @param deltaE maximal energy difference of a reported interaction to mfe
+	 * @param maxEglobal optional global upper bound of the energy of a
+	 *            reported interaction (monotonically decreasing) or NULL
 	 */
 	OutputConstraint(	  const size_t reportMax = 1
 						, const ReportOverlap reportOverlap = OVERLAP_BOTH
 						, const E_type maxE = 0.0
-						, const E_type deltaE = E_INF );
+						, const E_type deltaE = E_INF
+						, const E_type * maxEglobal = NULL );
 
 	//! destruction
 	virtual ~OutputConstraint();
+
+	/**
+	 * Provides the current maximal energy of a reported interaction, i.e.
+	 * the minimum of maxE and the current global bound (if present).
+	 *
+	 * @return the current maximal energy of a reported interaction
+	 */
+	E_type
+	getMaxE() const;
 };
 
+/////////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+OutputConstraint::
+getMaxE() const
+{
+	// check if no global bound present
+	if (maxEglobal == NULL) {
+		return maxE;
+	}
+	// get current global bound
+	E_type curMaxEglobal;
+#if INTARNA_MULITHREADING
+	#pragma omp atomic read
+#endif
+	curMaxEglobal = *maxEglobal;
+	return std::min( maxE, curMaxEglobal );
+}
+
+/////////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* OUTPUTCONSTRAINT_H_ */
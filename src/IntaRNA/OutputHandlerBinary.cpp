@@ -0,0 +1,501 @@
+#include "IntaRNA/OutputHandlerBinary.h"
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <map>
+
+#include <boost/algorithm/string.hpp>
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////
+
+#if INTARNA_INTEGER_ENERGY
+//! code of E_INF energies (sums involving E_INF are stored as E_INF)
+static const long long binaryEnergyINF = std::numeric_limits<boost::int64_t>::max();
+#else
+//! bit representation of energies
+typedef boost::uint32_t BinaryEnergyBits;
+static_assert( sizeof(E_type) == sizeof(BinaryEnergyBits), "E_type is expected to be 32 bit" );
+#endif
+
+////////////////////////////////////////////////////////////////////////
+
+OutputHandlerBinary::OutputHandlerBinary(
+		  std::ostream & out
+		, const InteractionEnergy & energy
+		, const size_t blockSize
+		)
+ :	out(out)
+	, energy(energy)
+	, blockSize(std::max((size_t)1,blockSize))
+	, pairId(getNextPairId())
+	, pairWritten(false)
+	, blockRecords(0)
+	, blockCols(C_number)
+	, lastStart1(0)
+	, lastStart2(0)
+{
+}
+
+////////////////////////////////////////////////////////////////////////
+
+OutputHandlerBinary::~OutputHandlerBinary()
+{
+	// force output
+	writeBlock();
+	out.flush();
+}
+
+////////////////////////////////////////////////////////////////////////
+
+size_t
+OutputHandlerBinary::
+getNextPairId()
+{
+	static size_t nextPairId = 0;
+	size_t newId = 0;
+#if INTARNA_MULITHREADING
+	#pragma omp atomic capture
+#endif
+	newId = nextPairId++;
+	return newId;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerBinary::
+add( const Interaction & i )
+{
+#if INTARNA_IN_DEBUG_MODE
+	// debug checks
+	if ( i.basePairs.size() > 0 && ! i.isValid() ) {
+		throw std::runtime_error("OutputHandlerBinary::add() : given interaction is not valid : "+toString(i));
+	}
+#endif
+
+	// special handling if no base pairs present
+	if (i.basePairs.size() == 0) {
+		return;
+	}
+
+	// get interaction start/end per sequence
+	const size_t i1 = i.basePairs.begin()->first;
+	const size_t j1 = i.basePairs.rbegin()->first;
+	const size_t i2 = i.basePairs.begin()->second;
+	const size_t j2 = i.basePairs.rbegin()->second;
+
+	// get individual energy contributions
+	InteractionEnergy::EnergyContributions contr = energy.getE_contributions(i);
+
+	// boundaries (delta encoded within block)
+	writeSigned( blockCols[C_start1], (long long)i1 - (long long)lastStart1 );
+	writeUnsigned( blockCols[C_width1], j1-i1 );
+	writeSigned( blockCols[C_start2], (long long)j2 - (long long)lastStart2 );
+	writeUnsigned( blockCols[C_width2], i2-j2 );
+	lastStart1 = i1;
+	lastStart2 = j2;
+
+	// base pairs (delta encoded to the preceding base pair)
+	writeUnsigned( blockCols[C_basePairs], i.basePairs.size() );
+	for (auto bpLast = i.basePairs.begin(), bp = bpLast+1; bp != i.basePairs.end(); bpLast = bp++) {
+		writeUnsigned( blockCols[C_basePairs], bp->first - bpLast->first );
+		writeUnsigned( blockCols[C_basePairs], bpLast->second - bp->second );
+	}
+
+	// energies
+	writeEnergy( blockCols[C_E], i.energy );
+	writeEnergy( blockCols[C_ED1], contr.ED1 );
+	writeEnergy( blockCols[C_ED2], contr.ED2 );
+	writeEnergy( blockCols[C_E_init], contr.init );
+	writeEnergy( blockCols[C_E_loops], contr.loops );
+	writeEnergy( blockCols[C_E_dangleL], contr.dangleLeft );
+	writeEnergy( blockCols[C_E_dangleR], contr.dangleRight );
+	writeEnergy( blockCols[C_E_endL], contr.endLeft );
+	writeEnergy( blockCols[C_E_endR], contr.endRight );
+
+	// seed information
+	writeUnsigned( blockCols[C_seed], (i.seed == NULL) ? 0 : 1 );
+	if (i.seed != NULL) {
+		// seed boundaries relative to the interaction
+		writeSigned( blockCols[C_seedPos], (long long)i.seed->bp_i.first - (long long)i1 );
+		writeSigned( blockCols[C_seedPos], (long long)i.seed->bp_j.first - (long long)i.seed->bp_i.first );
+		writeSigned( blockCols[C_seedPos], (long long)i2 - (long long)i.seed->bp_i.second );
+		writeSigned( blockCols[C_seedPos], (long long)i.seed->bp_i.second - (long long)i.seed->bp_j.second );
+		// seed energy and ED values
+		writeEnergy( blockCols[C_seedE], i.seed->energy );
+		writeEnergy( blockCols[C_seedE], energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first ) );
+		writeEnergy( blockCols[C_seedE], energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second ) );
+	}
+
+	// write block to stream if full
+	blockRecords++;
+	if (blockRecords >= blockSize) {
+		writeBlock();
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerBinary::
+writeBlock()
+{
+	// nothing to write
+	if (blockRecords == 0) {
+		return;
+	}
+
+	// compile chunks locally (no locking needed)
+	std::string chunks;
+	if (!pairWritten) {
+		chunks.push_back('P');
+		writeUnsigned( chunks, pairId );
+		writeString( chunks, energy.getAccessibility1().getSequence().getId() );
+		writeString( chunks, energy.getAccessibility1().getSequence().asString() );
+		writeString( chunks, energy.getAccessibility2().getSequence().getId() );
+		writeString( chunks, energy.getAccessibility2().getAccessibilityOrigin().getSequence().asString() );
+		// store RT bitwise to enable identical Pu computation
+		const Ekcal_type RT = energy.getRT();
+		boost::uint32_t RTbits = 0;
+		static_assert( sizeof(RT) == sizeof(RTbits), "Ekcal_type is expected to be 32 bit" );
+		std::memcpy( &RTbits, &RT, sizeof(RT) );
+		writeUnsigned( chunks, RTbits );
+		pairWritten = true;
+	}
+	chunks.push_back('B');
+	writeUnsigned( chunks, pairId );
+	writeUnsigned( chunks, blockRecords );
+	writeUnsigned( chunks, blockCols.size() );
+	for (auto col = blockCols.begin(); col != blockCols.end(); col++) {
+		writeUnsigned( chunks, col->size() );
+		chunks.append( *col );
+		col->clear();
+	}
+
+	// ensure outputs do not intervene
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_outputStreamUpdate)
+#endif
+	{
+		out.write( chunks.data(), chunks.size() );
+	}
+
+	// reset block
+	blockRecords = 0;
+	lastStart1 = 0;
+	lastStart2 = 0;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerBinary::
+writeUnsigned( std::string & data, unsigned long long value )
+{
+	// LEB128 : 7 bit per byte, highest bit marks continuation
+	while (value >= 0x80) {
+		data.push_back( (char)((value & 0x7F) | 0x80) );
+		value >>= 7;
+	}
+	data.push_back( (char)value );
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerBinary::
+writeSigned( std::string & data, const long long value )
+{
+	// zigzag : map small absolute values to small unsigned values
+	writeUnsigned( data, (value < 0)
+			? ((((unsigned long long)(-(value+1))) << 1) | 1)
+			: (((unsigned long long)value) << 1) );
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerBinary::
+writeString( std::string & data, const std::string & value )
+{
+	writeUnsigned( data, value.size() );
+	data.append( value );
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerBinary::
+writeEnergy( std::string & data, const E_type value )
+{
+#if INTARNA_INTEGER_ENERGY
+	// native integer value
+	if (E_isINF(value)) {
+		writeSigned( data, binaryEnergyINF );
+	} else {
+		writeSigned( data, (long long)value );
+	}
+#else
+	// exact bit representation (including INF, NaN and negative zero)
+	BinaryEnergyBits bits = 0;
+	std::memcpy( &bits, &value, sizeof(value) );
+	writeUnsigned( data, bits );
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////
+
+unsigned long long
+OutputHandlerBinary::
+readUnsigned( const std::string & data, size_t & pos )
+{
+	unsigned long long value = 0;
+	for (size_t shift = 0; ; shift += 7) {
+		if (pos >= data.size() || shift > 63) {
+			throw std::runtime_error("OutputHandlerBinary::readUnsigned() : corrupted block data");
+		}
+		const unsigned char byte = (unsigned char)data.at(pos++);
+		value |= ((unsigned long long)(byte & 0x7F)) << shift;
+		if ((byte & 0x80) == 0) {
+			return value;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+long long
+OutputHandlerBinary::
+readSigned( const std::string & data, size_t & pos )
+{
+	const unsigned long long value = readUnsigned( data, pos );
+	return (value & 1) ? -((long long)(value >> 1))-1 : (long long)(value >> 1);
+}
+
+////////////////////////////////////////////////////////////////////////
+
+E_type
+OutputHandlerBinary::
+readEnergy( const std::string & data, size_t & pos )
+{
+#if INTARNA_INTEGER_ENERGY
+	const long long value = readSigned( data, pos );
+	if (value == binaryEnergyINF) {
+		return E_INF;
+	}
+	if (value < (long long)std::numeric_limits<E_type>::min() || value > (long long)E_MAX) {
+		throw std::runtime_error("OutputHandlerBinary::readEnergy() : energy out of range");
+	}
+	return (E_type)value;
+#else
+	const unsigned long long bits = readUnsigned( data, pos );
+	if (bits > std::numeric_limits<BinaryEnergyBits>::max()) {
+		throw std::runtime_error("OutputHandlerBinary::readEnergy() : corrupted energy data");
+	}
+	const BinaryEnergyBits energyBits = (BinaryEnergyBits)bits;
+	E_type value;
+	std::memcpy( &value, &energyBits, sizeof(value) );
+	return value;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////
+
+unsigned long long
+OutputHandlerBinary::
+readUnsigned( std::istream & in )
+{
+	unsigned long long value = 0;
+	for (size_t shift = 0; ; shift += 7) {
+		const int byte = in.get();
+		if (byte == std::char_traits<char>::eof() || shift > 63) {
+			throw std::runtime_error("OutputHandlerBinary::readUnsigned() : unexpected end of input");
+		}
+		value |= ((unsigned long long)(byte & 0x7F)) << shift;
+		if ((byte & 0x80) == 0) {
+			return value;
+		}
+	}
+}
+
+////////////////////////////////////////////////////////////////////////
+
+std::string
+OutputHandlerBinary::
+readString( std::istream & in )
+{
+	std::string value( readUnsigned( in ), '\0' );
+	if (!value.empty() && !in.read( &(value[0]), value.size() )) {
+		throw std::runtime_error("OutputHandlerBinary::readString() : unexpected end of input");
+	}
+	return value;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+size_t
+OutputHandlerBinary::
+writeCsv( std::istream & in
+		, std::ostream & out
+		, const OutputHandlerCsv::ColTypeList & colOrder
+		, const std::string & colSep
+		, const bool printHeader )
+{
+	// check file header
+	const std::string fileHeader = getFileHeader();
+	std::string header( fileHeader.size(), '\0' );
+	if (!in.read( &(header[0]), header.size() ) || header != fileHeader) {
+		throw std::runtime_error("OutputHandlerBinary::writeCsv() : input is not in binary IntaRNA output format");
+	}
+
+	if (printHeader) {
+		out <<OutputHandlerCsv::getHeader( colOrder, colSep );
+	}
+
+	//! information of a sequence pair
+	struct PairInfo {
+		RnaSequence seq1;
+		RnaSequence seq2;
+		std::string csvId1;
+		std::string csvId2;
+		Ekcal_type RT;
+		PairInfo( const std::string & id1, const std::string & seq1
+				, const std::string & id2, const std::string & seq2
+				, const std::string & colSep, const Ekcal_type RT )
+		 : seq1(id1,seq1), seq2(id2,seq2)
+			, csvId1(boost::replace_all_copy(id1, colSep, "_"))
+			, csvId2(boost::replace_all_copy(id2, colSep, "_"))
+			, RT(RT)
+		{}
+	};
+	std::map< size_t, PairInfo > pairs;
+
+	// decoding data of current block
+	std::vector< std::string > cols;
+	std::vector< size_t > colPos;
+	InteractionEnergy::EnergyContributions contr;
+	size_t interactionNumber = 0;
+
+	// parse chunks
+	for (int chunkType = in.get(); chunkType != std::char_traits<char>::eof(); chunkType = in.get()) {
+		switch( chunkType ) {
+
+		case 'P': {
+			const size_t pairId = readUnsigned( in );
+			const std::string id1 = readString( in );
+			const std::string seq1 = readString( in );
+			const std::string id2 = readString( in );
+			const std::string seq2 = readString( in );
+			const boost::uint32_t RTbits = readUnsigned( in );
+			Ekcal_type RT;
+			std::memcpy( &RT, &RTbits, sizeof(RT) );
+			pairs.erase( pairId );
+			pairs.emplace( std::piecewise_construct
+						, std::forward_as_tuple( pairId )
+						, std::forward_as_tuple( id1, seq1, id2, seq2, colSep, RT ) );
+			break;
+		}
+
+		case 'B': {
+			const size_t pairId = readUnsigned( in );
+			auto pairIt = pairs.find( pairId );
+			if (pairIt == pairs.end()) {
+				throw std::runtime_error("OutputHandlerBinary::writeCsv() : block refers to unknown pair ID "+toString(pairId));
+			}
+			const PairInfo & pair = pairIt->second;
+			const std::string & seq1 = pair.seq1.asString();
+			const std::string & seq2 = pair.seq2.asString();
+			const size_t records = readUnsigned( in );
+			const size_t colNumber = readUnsigned( in );
+			if (colNumber < (size_t)C_number) {
+				throw std::runtime_error("OutputHandlerBinary::writeCsv() : block with too few columns");
+			}
+			// read columns
+			cols.resize( colNumber );
+			colPos.assign( colNumber, 0 );
+			for (size_t c = 0; c < colNumber; c++) {
+				cols[c].resize( readUnsigned( in ) );
+				if (!cols[c].empty() && !in.read( &(cols[c][0]), cols[c].size() )) {
+					throw std::runtime_error("OutputHandlerBinary::writeCsv() : unexpected end of input");
+				}
+			}
+
+			// decode and print records
+			Interaction i( pair.seq1, pair.seq2 );
+			size_t lastStart1 = 0, lastStart2 = 0;
+			for (size_t r = 0; r < records; r++) {
+				// boundaries
+				const size_t i1 = lastStart1 + readSigned( cols[C_start1], colPos[C_start1] );
+				const size_t j1 = i1 + readUnsigned( cols[C_width1], colPos[C_width1] );
+				const size_t j2 = lastStart2 + readSigned( cols[C_start2], colPos[C_start2] );
+				const size_t i2 = j2 + readUnsigned( cols[C_width2], colPos[C_width2] );
+				lastStart1 = i1;
+				lastStart2 = j2;
+				if (j1 >= seq1.size() || i2 >= seq2.size()) {
+					throw std::runtime_error("OutputHandlerBinary::writeCsv() : interaction boundaries exceed sequence length");
+				}
+
+				// base pairs
+				i.clear();
+				i.basePairs.resize( readUnsigned( cols[C_basePairs], colPos[C_basePairs] ) );
+				if (i.basePairs.empty()) {
+					throw std::runtime_error("OutputHandlerBinary::writeCsv() : interaction without base pairs");
+				}
+				i.basePairs.begin()->first = i1;
+				i.basePairs.begin()->second = i2;
+				for (auto bpLast = i.basePairs.begin(), bp = bpLast+1; bp != i.basePairs.end(); bpLast = bp++) {
+					bp->first = bpLast->first + readUnsigned( cols[C_basePairs], colPos[C_basePairs] );
+					bp->second = bpLast->second - readUnsigned( cols[C_basePairs], colPos[C_basePairs] );
+				}
+
+				// energies
+				i.energy = readEnergy( cols[C_E], colPos[C_E] );
+				contr.ED1 = readEnergy( cols[C_ED1], colPos[C_ED1] );
+				contr.ED2 = readEnergy( cols[C_ED2], colPos[C_ED2] );
+				contr.init = readEnergy( cols[C_E_init], colPos[C_E_init] );
+				contr.loops = readEnergy( cols[C_E_loops], colPos[C_E_loops] );
+				contr.dangleLeft = readEnergy( cols[C_E_dangleL], colPos[C_E_dangleL] );
+				contr.dangleRight = readEnergy( cols[C_E_dangleR], colPos[C_E_dangleR] );
+				contr.endLeft = readEnergy( cols[C_E_endL], colPos[C_E_endL] );
+				contr.endRight = readEnergy( cols[C_E_endR], colPos[C_E_endR] );
+
+				// seed information
+				E_type seedED1 = 0, seedED2 = 0;
+				if (readUnsigned( cols[C_seed], colPos[C_seed] ) != 0) {
+					const size_t si1 = i1 + readSigned( cols[C_seedPos], colPos[C_seedPos] );
+					const size_t sj1 = si1 + readSigned( cols[C_seedPos], colPos[C_seedPos] );
+					const size_t si2 = i2 - readSigned( cols[C_seedPos], colPos[C_seedPos] );
+					const size_t sj2 = si2 - readSigned( cols[C_seedPos], colPos[C_seedPos] );
+					const E_type seedE = readEnergy( cols[C_seedE], colPos[C_seedE] );
+					seedED1 = readEnergy( cols[C_seedE], colPos[C_seedE] );
+					seedED2 = readEnergy( cols[C_seedE], colPos[C_seedE] );
+					i.setSeedRange( Interaction::BasePair(si1,si2), Interaction::BasePair(sj1,sj2), seedE );
+				}
+
+				// print columns as done by OutputHandlerCsv
+				OutputHandlerCsv::writeRow( out, i, contr, seedED1, seedED2, pair.RT
+						, pair.csvId1, pair.csvId2, seq1, seq2, colOrder, colSep );
+				interactionNumber++;
+			}
+			break;
+		}
+
+		default :
+			throw std::runtime_error("OutputHandlerBinary::writeCsv() : unknown chunk type '"+toString((char)chunkType)+"'");
+		}
+	}
+
+	return interactionNumber;
+}
+
+////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
@@ -0,0 +1,288 @@
+
+#ifndef INTARNA_OUTPUTHANDLERBINARY_H_
+#define INTARNA_OUTPUTHANDLERBINARY_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/OutputHandler.h"
+#include "IntaRNA/OutputHandlerCsv.h"
+#include "IntaRNA/InteractionEnergy.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * OutputHandler that writes interactions in a compact binary columnar format,
+ * which can be converted to CSV via writeCsv().
+ *
+ * Format (all integers are unsigned LEB128 varints, signed values are
+ * zigzag encoded, strings are length-prefixed):
+ *
+ *  - file header : the magic string getFileHeader()
+ *  - pair chunk 'P' : pair ID, id1, seq1, id2, seq2 (original order), RT
+ *    (written once per output handler, i.e. per sequence pair, before its
+ *    first block; referenced by ID within the blocks)
+ *  - block chunk 'B' : pair ID, number of records, number of columns
+ *    followed by the length and data of each column (see BinCol), i.e. the
+ *    values of a column are stored consecutively for all records of a block
+ *
+ * Coordinates are delta encoded within a block, base pairs are delta encoded
+ * within an interaction and energies are stored lossless, i.e. as the bit
+ * representation of the floating point values or as the native integer
+ * values for integer energy arithmetic (see writeEnergy()).
+ *
+ * Since each output handler writes complete chunks only, the output of
+ * several output handlers (threads) can be written to the same stream.
+ *
+ * @author Martin Mann
+ *
+ */
+class OutputHandlerBinary : public OutputHandler
+{
+public:
+
+	/**
+	 * Construct a binary output handler for interaction reporting.
+	 *
+	 * NOTE: the file header has to be written to the stream beforehand
+	 * (see getFileHeader()).
+	 *
+	 * @param out the stream to write to
+	 * @param energy the interaction energy object used for computation
+	 * @param blockSize the maximal number of interactions per block (>0)
+	 */
+	OutputHandlerBinary( std::ostream & out
+						, const InteractionEnergy & energy
+						, const size_t blockSize = 4096
+						);
+
+	/**
+	 * destruction, writes the last block to stream
+	 */
+	virtual ~OutputHandlerBinary();
+
+	/**
+	 * Adds a given RNA-RNA interaction to the current block.
+	 *
+	 * @param interaction the interaction to output
+	 */
+	virtual
+	void
+	add( const Interaction & interaction );
+
+	/**
+	 * Handles a given RNA-RNA interaction range as a
+	 * RNA-RNA interaction with two base pairs.
+	 *
+	 * @param range the interaction range to add
+	 */
+	virtual
+	void
+	add( const InteractionRange & range );
+
+	/**
+	 * Provides the magic string that starts each binary output
+	 * @return the file header
+	 */
+	static
+	std::string
+	getFileHeader();
+
+	/**
+	 * Converts binary output into CSV format as done by OutputHandlerCsv.
+	 *
+	 * @param in the binary input to convert
+	 * @param out the stream to write the CSV output to
+	 * @param colOrder the order and list of columns to be printed
+	 * @param colSep the column separator to be used in CSV output
+	 * @param printHeader whether or not to print header information = col names
+	 * @return the number of interactions converted
+	 */
+	static
+	size_t
+	writeCsv( std::istream & in
+			, std::ostream & out
+			, const OutputHandlerCsv::ColTypeList & colOrder
+			, const std::string & colSep = ";"
+			, const bool printHeader = true );
+
+protected:
+
+	//! the columns of a block
+	enum BinCol {
+		C_start1 = 0, //!< i1 (delta to the previous record)
+		C_width1, //!< j1-i1
+		C_start2, //!< j2 (delta to the previous record)
+		C_width2, //!< i2-j2
+		C_basePairs, //!< number of base pairs and their deltas
+		C_E, //!< overall energy
+		C_ED1, //!< ED value of seq1
+		C_ED2, //!< ED value of seq2
+		C_E_init, //!< initiation energy
+		C_E_loops, //!< loop energies
+		C_E_dangleL, //!< left dangling end contribution
+		C_E_dangleR, //!< right dangling end contribution
+		C_E_endL, //!< left end penalty
+		C_E_endR, //!< right end penalty
+		C_seed, //!< whether or not seed information is present
+		C_seedPos, //!< seed boundaries relative to the interaction
+		C_seedE, //!< seed energy and ED values
+		C_number //!< number of columns
+	};
+
+	//! the output stream to write to
+	std::ostream & out;
+
+	//! the interaction energy function used for interaction computation
+	const InteractionEnergy & energy;
+
+	//! the maximal number of interactions per block
+	const size_t blockSize;
+
+	//! the ID of the sequence pair of this handler within the output
+	const size_t pairId;
+
+	//! whether or not the pair chunk was written
+	bool pairWritten;
+
+	//! the number of interactions in the current block
+	size_t blockRecords;
+
+	//! the data of each column of the current block
+	std::vector< std::string > blockCols;
+
+	//! the start in seq1 of the last interaction in the current block
+	size_t lastStart1;
+
+	//! the start in seq2 of the last interaction in the current block
+	size_t lastStart2;
+
+	/**
+	 * Writes the current block (and the pair chunk if needed) to stream.
+	 */
+	void
+	writeBlock();
+
+	/**
+	 * Provides a new pair ID unique within this program run
+	 * @return the new pair ID
+	 */
+	static
+	size_t
+	getNextPairId();
+
+	/**
+	 * Appends an unsigned varint to the given data
+	 * @param data the data to extend
+	 * @param value the value to append
+	 */
+	static
+	void
+	writeUnsigned( std::string & data, unsigned long long value );
+
+	/**
+	 * Appends a zigzag encoded signed varint to the given data
+	 * @param data the data to extend
+	 * @param value the value to append
+	 */
+	static
+	void
+	writeSigned( std::string & data, const long long value );
+
+	/**
+	 * Appends a length-prefixed string to the given data
+	 * @param data the data to extend
+	 * @param value the string to append
+	 */
+	static
+	void
+	writeString( std::string & data, const std::string & value );
+
+	/**
+	 * Appends an energy lossless to the given data, i.e. the bits of a
+	 * floating point energy or the value of an integer energy
+	 * @param data the data to extend
+	 * @param value the energy to append
+	 */
+	static
+	void
+	writeEnergy( std::string & data, const E_type value );
+
+	/**
+	 * Reads an energy stored via writeEnergy() from the given data
+	 * @param data the data to read from
+	 * @param pos the position to read from, will be updated
+	 * @return the read energy
+	 */
+	static
+	E_type
+	readEnergy( const std::string & data, size_t & pos );
+
+	/**
+	 * Reads an unsigned varint from the given data
+	 * @param data the data to read from
+	 * @param pos the position to read from, will be updated
+	 * @return the read value
+	 */
+	static
+	unsigned long long
+	readUnsigned( const std::string & data, size_t & pos );
+
+	/**
+	 * Reads a zigzag encoded signed varint from the given data
+	 * @param data the data to read from
+	 * @param pos the position to read from, will be updated
+	 * @return the read value
+	 */
+	static
+	long long
+	readSigned( const std::string & data, size_t & pos );
+
+	/**
+	 * Reads an unsigned varint from the given stream
+	 * @param in the stream to read from
+	 * @return the read value
+	 */
+	static
+	unsigned long long
+	readUnsigned( std::istream & in );
+
+	/**
+	 * Reads a length-prefixed string from the given stream
+	 * @param in the stream to read from
+	 * @return the read string
+	 */
+	static
+	std::string
+	readString( std::istream & in );
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+void
+OutputHandlerBinary::
+add( const InteractionRange & range )
+{
+	// forward to interaction reporting
+	add( Interaction(range) );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+std::string
+OutputHandlerBinary::
+getFileHeader()
+{
+	return std::string("IntaRNAbin2\n");
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_OUTPUTHANDLERBINARY_H_ */
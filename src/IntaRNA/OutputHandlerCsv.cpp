@@ -21,8 +21,10 @@ OutputHandlerCsv::OutputHandlerCsv(
 		, const ColTypeList colOrder
 		, const std::string& colSep
 		, const bool printHeader
+		, const size_t flushThreshold
 		)
  :	out(out)
+	, outBuffer(out, flushThreshold)
 	, energy(energy)
 	, colOrder(colOrder)
 	, colSep(colSep)
@@ -47,6 +49,7 @@ OutputHandlerCsv::OutputHandlerCsv(
 OutputHandlerCsv::~OutputHandlerCsv()
 {
 	// force output
+	outBuffer.flush();
 	out.flush();
 }
 
@@ -68,215 +71,243 @@ add( const Interaction & i )
 		return;
 	}
 
+	// get individual energy contributions
+	InteractionEnergy::EnergyContributions contr = energy.getE_contributions(i);
+
+	// get seed accessibilities if needed
+	E_type EDseed1 = 0, EDseed2 = 0;
+	if (i.seed != NULL) {
+		EDseed1 = energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first );
+		EDseed2 = energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second );
+	}
+
+	// format output into local buffer (no locking needed)
+	writeRow( outBuffer.getStream(), i, contr, EDseed1, EDseed2, energy.getRT()
+			// ensure no colSeps are contained
+			, boost::replace_all_copy(energy.getAccessibility1().getSequence().getId(), colSep, "_")
+			, boost::replace_all_copy(energy.getAccessibility2().getSequence().getId(), colSep, "_")
+			, energy.getAccessibility1().getSequence().asString()
+			, energy.getAccessibility2().getAccessibilityOrigin().getSequence().asString()
+			, colOrder, colSep );
+
+	// write buffer to stream if needed
+	outBuffer.flushIfFull();
+
+}
+
+////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerCsv::
+writeRow( std::ostream & out
+		, const Interaction & i
+		, const InteractionEnergy::EnergyContributions & contr
+		, const E_type EDseed1
+		, const E_type EDseed2
+		, const Ekcal_type RT
+		, const std::string & csvId1
+		, const std::string & csvId2
+		, const std::string & sequence1
+		, const std::string & sequence2
+		, const ColTypeList & colOrder
+		, const std::string & colSep )
+{
 	// get interaction start/end per sequence
 	const size_t i1 = i.basePairs.begin()->first;
 	const size_t j1 = i.basePairs.rbegin()->first;
 	const size_t i2 = i.basePairs.begin()->second;
 	const size_t j2 = i.basePairs.rbegin()->second;
 
-	// get individual energy contributions
-	InteractionEnergy::EnergyContributions contr = energy.getE_contributions(i);
+	for (auto col = colOrder.begin(); col != colOrder.end(); col++) {
+		// print separator if needed
+		if (col != colOrder.begin()) {
+			out <<colSep;
+		}
+		// print this column information
+		switch ( *col ) {
+
+		case id1:
+			out <<csvId1;
+			break;
+
+		case id2:
+			out <<csvId2;
+			break;
+
+		case seq1:
+			out <<sequence1;
+			break;
+
+		case seq2:
+			out <<sequence2;
+			break;
+
+		case subseq1:
+			out <<sequence1.substr(i1, j1-i1+1);
+			break;
+
+		case subseq2:
+			out <<sequence2.substr(j2, i2-j2+1);
+			break;
+
+		case subseqDP:
+			out <<sequence1.substr(i1, j1-i1+1)
+				<<'&'
+				<<sequence2.substr(j2, i2-j2+1);
+			break;
+
+		case subseqDB:
+			out <<(i1+1)
+				<<sequence1.substr(i1, j1-i1+1)
+				<<'&'
+				<<(j2+1)
+				<<sequence2.substr(j2, i2-j2+1);
+			break;
+
+		case start1:
+			out <<(i1+1);
+			break;
+
+		case end1:
+			out <<(j1+1);
+			break;
+
+		case start2:
+			out <<(j2+1);
+			break;
+
+		case end2:
+			out <<(i2+1);
+			break;
+
+		case hybridDP:
+			out <<Interaction::dotBracket( i );
+			break;
+
+		case hybridDB:
+			out <<Interaction::dotBar( i );
+			break;
+
+		case E:
+			out <<E_2_Ekcal(i.energy);
+			break;
+
+		case ED1:
+			out <<E_2_Ekcal(contr.ED1);
+			break;
+
+		case ED2:
+			out <<E_2_Ekcal(contr.ED2);
+			break;
+
+		case Pu1:
+			out <<std::exp( - E_2_Ekcal(contr.ED1) / RT );
+			break;
+
+		case Pu2:
+			out <<std::exp( - E_2_Ekcal(contr.ED2) / RT );
+			break;
+
+		case E_init:
+			out <<E_2_Ekcal(contr.init);
+			break;
+
+		case E_loops:
+			out <<E_2_Ekcal(contr.loops);
+			break;
+
+		case E_dangleL:
+			out <<E_2_Ekcal(contr.dangleLeft);
+			break;
+
+		case E_dangleR:
+			out <<E_2_Ekcal(contr.dangleRight);
+			break;
+
+		case E_endL:
+			out <<E_2_Ekcal(contr.endLeft);
+			break;
+
+		case E_endR:
+			out <<E_2_Ekcal(contr.endRight);
+			break;
+
+		case seedStart1:
+			if (i.seed == NULL) {
+				out <<std::numeric_limits<Ekcal_type>::signaling_NaN();
+			} else {
+				out <<(i.seed->bp_i.first+1);
+			}
+			break;
 
-	// ensure outputs do not intervene
-#if INTARNA_MULITHREADING
-	#pragma omp critical(intarna_omp_outputStreamUpdate)
-#endif
-	{
+		case seedEnd1:
+			if (i.seed == NULL) {
+				out <<std::numeric_limits<Ekcal_type>::signaling_NaN();
+			} else {
+				out <<(i.seed->bp_j.first+1);
+			}
+			break;
 
-		for (auto col = colOrder.begin(); col != colOrder.end(); col++) {
-			// print separator if needed
-			if (col != colOrder.begin()) {
-				out <<colSep;
+		case seedStart2:
+			if (i.seed == NULL) {
+				out <<std::numeric_limits<Ekcal_type>::signaling_NaN();
+			} else {
+				out <<(i.seed->bp_j.second+1);
 			}
-			// print this column information
-			switch ( *col ) {
-
-			case id1:
-				// ensure no colSeps are contained
-				out <<boost::replace_all_copy(energy.getAccessibility1().getSequence().getId(), colSep, "_");
-				break;
-
-			case id2:
-				// ensure no colSeps are contained
-				out <<boost::replace_all_copy(energy.getAccessibility2().getSequence().getId(), colSep, "_");
-				break;
-
-			case seq1:
-				out <<energy.getAccessibility1().getSequence().asString();
-				break;
-
-			case seq2:
-				out <<energy.getAccessibility2().getAccessibilityOrigin().getSequence().asString();
-				break;
-
-			case subseq1:
-				out <<energy.getAccessibility1().getSequence().asString().substr(i1, j1-i1+1);
-				break;
-
-			case subseq2:
-				out <<energy.getAccessibility2().getAccessibilityOrigin().getSequence().asString().substr(j2, i2-j2+1);
-				break;
-
-			case subseqDP:
-				out <<energy.getAccessibility1().getSequence().asString().substr(i1, j1-i1+1)
-					<<'&'
-					<<energy.getAccessibility2().getAccessibilityOrigin().getSequence().asString().substr(j2, i2-j2+1);
-				break;
-
-			case subseqDB:
-				out <<(i1+1)
-					<<energy.getAccessibility1().getSequence().asString().substr(i1, j1-i1+1)
-					<<'&'
-					<<(j2+1)
-					<<energy.getAccessibility2().getAccessibilityOrigin().getSequence().asString().substr(j2, i2-j2+1);
-				break;
-
-			case start1:
-				out <<(i1+1);
-				break;
-
-			case end1:
-				out <<(j1+1);
-				break;
-
-			case start2:
-				out <<(j2+1);
-				break;
-
-			case end2:
-				out <<(i2+1);
-				break;
-
-			case hybridDP:
-				out <<Interaction::dotBracket( i );
-				break;
-
-			case hybridDB:
-				out <<Interaction::dotBar( i );
-				break;
-
-			case E:
-				out <<i.energy;
-				break;
-
-			case ED1:
-				out <<contr.ED1;
-				break;
-
-			case ED2:
-				out <<contr.ED2;
-				break;
-
-			case Pu1:
-				out <<std::exp( - contr.ED1 / energy.getRT() );
-				break;
-
-			case Pu2:
-				out <<std::exp( - contr.ED2 / energy.getRT() );
-				break;
-
-			case E_init:
-				out <<contr.init;
-				break;
-
-			case E_loops:
-				out <<contr.loops;
-				break;
-
-			case E_dangleL:
-				out <<contr.dangleLeft;
-				break;
-
-			case E_dangleR:
-				out <<contr.dangleRight;
-				break;
-
-			case E_endL:
-				out <<contr.endLeft;
-				break;
-
-			case E_endR:
-				out <<contr.endRight;
-				break;
-
-			case seedStart1:
-				if (i.seed == NULL) {
-					out <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					out <<(i.seed->bp_i.first+1);
-				}
-				break;
-
-			case seedEnd1:
-				if (i.seed == NULL) {
-					out <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					out <<(i.seed->bp_j.first+1);
-				}
-				break;
-
-			case seedStart2:
-				if (i.seed == NULL) {
-					out <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					out <<(i.seed->bp_j.second+1);
-				}
-				break;
-
-			case seedEnd2:
-				if (i.seed == NULL) {
-					out <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					out <<(i.seed->bp_i.second+1);
-				}
-				break;
-
-			case seedE:
-				if (i.seed == NULL) {
-					out <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					out <<i.seed->energy;
-				}
-				break;
-
-			case seedED1:
-				if (i.seed == NULL) {
-					out <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					out <<energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first );
-				}
-				break;
-
-			case seedED2:
-				if (i.seed == NULL) {
-					out <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					out <<energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second );
-				}
-				break;
-
-			case seedPu1:
-				if (i.seed == NULL) {
-					out <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					out <<std::exp( - energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first ) / energy.getRT() );
-				}
-				break;
-
-			case seedPu2:
-				if (i.seed == NULL) {
-					out <<std::numeric_limits<E_type>::signaling_NaN();
-				} else {
-					out <<std::exp( - energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second ) / energy.getRT() );
-				}
-				break;
-
-			default : throw std::runtime_error("OutputHandlerCsv::add() : unhandled ColType '"+colType2string[*col]+"'");
+			break;
+
+		case seedEnd2:
+			if (i.seed == NULL) {
+				out <<std::numeric_limits<Ekcal_type>::signaling_NaN();
+			} else {
+				out <<(i.seed->bp_i.second+1);
 			}
-		}
-		out <<'\n';
-	} // omp critical(intarna_omp_outputStreamUpdate)
+			break;
+
+		case seedE:
+			if (i.seed == NULL) {
+				out <<std::numeric_limits<Ekcal_type>::signaling_NaN();
+			} else {
+				out <<E_2_Ekcal(i.seed->energy);
+			}
+			break;
+
+		case seedED1:
+			if (i.seed == NULL) {
+				out <<std::numeric_limits<Ekcal_type>::signaling_NaN();
+			} else {
+				out <<E_2_Ekcal(EDseed1);
+			}
+			break;
 
+		case seedED2:
+			if (i.seed == NULL) {
+				out <<std::numeric_limits<Ekcal_type>::signaling_NaN();
+			} else {
+				out <<E_2_Ekcal(EDseed2);
+			}
+			break;
+
+		case seedPu1:
+			if (i.seed == NULL) {
+				out <<std::numeric_limits<Ekcal_type>::signaling_NaN();
+			} else {
+				out <<std::exp( - E_2_Ekcal(EDseed1) / RT );
+			}
+			break;
+
+		case seedPu2:
+			if (i.seed == NULL) {
+				out <<std::numeric_limits<Ekcal_type>::signaling_NaN();
+			} else {
+				out <<std::exp( - E_2_Ekcal(EDseed2) / RT );
+			}
+			break;
+
+		default : throw std::runtime_error("OutputHandlerCsv::writeRow() : unhandled ColType '"+colType2string[*col]+"'");
+		}
+	}
+	out <<'\n';
 }
 
 ////////////////////////////////////////////////////////////////////////
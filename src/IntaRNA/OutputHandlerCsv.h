@@ -6,6 +6,7 @@
 
 #include "IntaRNA/OutputHandler.h"
 #include "IntaRNA/InteractionEnergy.h"
+#include "IntaRNA/OutputStreamBuffer.h"
 
 #include <list>
 #include <map>
@@ -137,12 +138,15 @@ public:
 	 * @param colOrder the order and list of columns to be printed
 	 * @param colSep the column separator to be used in CSV output
 	 * @param printHeader whether or not to print header information = col names
+	 * @param flushThreshold the number of locally buffered characters that
+	 *        triggers a write to out (0 = write each interaction directly)
 	 */
 	OutputHandlerCsv( std::ostream & out
 						, const InteractionEnergy & energy
 						, const ColTypeList colOrder
 						, const std::string& colSep = ";"
 						, const bool printHeader = false
+						, const size_t flushThreshold = OutputStreamBuffer::defaultFlushThreshold
 						);
 
 	/**
@@ -203,11 +207,47 @@ public:
 	std::string
 	getHeader( const ColTypeList & colTypes, const std::string& colSep = ";" );
 
+	/**
+	 * Writes the columns of a given interaction as a CSV row (incl. line end)
+	 * without access to the energy function, e.g. to convert stored
+	 * interaction data.
+	 *
+	 * @param out the stream to write to
+	 * @param i the interaction to write (non-empty)
+	 * @param contr the energy contributions of the interaction
+	 * @param EDseed1 the ED value of the seed in seq1 (ignored if no seed)
+	 * @param EDseed2 the ED value of the seed in seq2 (ignored if no seed)
+	 * @param RT the RT value used to compute unpaired probabilities
+	 * @param csvId1 the id of seq1 (without colSep)
+	 * @param csvId2 the id of seq2 (without colSep)
+	 * @param sequence1 the full sequence 1
+	 * @param sequence2 the full sequence 2
+	 * @param colOrder the order and list of columns to be printed
+	 * @param colSep the column separator to be used
+	 */
+	static
+	void
+	writeRow( std::ostream & out
+			, const Interaction & i
+			, const InteractionEnergy::EnergyContributions & contr
+			, const E_type EDseed1
+			, const E_type EDseed2
+			, const Ekcal_type RT
+			, const std::string & csvId1
+			, const std::string & csvId2
+			, const std::string & sequence1
+			, const std::string & sequence2
+			, const ColTypeList & colOrder
+			, const std::string & colSep );
+
 protected:
 
 	//! the output stream to write to
 	std::ostream & out;
 
+	//! local buffer of the formatted output to be written to out
+	OutputStreamBuffer outBuffer;
+
 	//! the interaction energy function used for interaction computation
 	const InteractionEnergy & energy;
 
@@ -64,10 +64,7 @@ add( const Interaction & i )
 	{
 		if (!initialOutputDone) {
 			if (printSeparator) {
-				out <<"\n=========================\n"
-					<<'\n';
-
-
+				out <<getSeparator();
 			}
 			// write sequences in FASTA to out
 			out
@@ -214,16 +211,16 @@ add( const Interaction & i )
 				<<"positions(ncRNA)      : "<<(i.basePairs.rbegin()->second +1)<<" -- "<<(i.basePairs.begin()->second +1) <<'\n'
 				<<"positions seed(ncRNA) : "<<(i.seed!=NULL?toString(i.seed->bp_j.second +1):"?")<<" -- "<<(i.seed!=NULL?toString(i.seed->bp_i.second +1):"?") <<'\n'
 				<<"positions with dangle(ncRNA): "<<(i.basePairs.rbegin()->second +1)<<" -- "<<(i.basePairs.begin()->second +1) <<'\n'
-				<<"ED target need: "<<contr.ED1 <<" kcal/mol"<<'\n'
-				<<"ED ncRNA  need: "<<contr.ED2 <<" kcal/mol"<<'\n'
-				<<"hybrid energy : "<<(i.energy-contr.ED1-contr.ED2) <<" kcal/mol"<<'\n'
+				<<"ED target need: "<<E_2_Ekcal(contr.ED1) <<" kcal/mol"<<'\n'
+				<<"ED ncRNA  need: "<<E_2_Ekcal(contr.ED2) <<" kcal/mol"<<'\n'
+				<<"hybrid energy : "<<E_2_Ekcal(i.energy-contr.ED1-contr.ED2) <<" kcal/mol"<<'\n'
 				<<"\n"
-				<<"energy: "<<i.energy <<" kcal/mol\n"
+				<<"energy: "<<E_2_Ekcal(i.energy) <<" kcal/mol\n"
 				;
 		} else {
 			// normal minimal information output
 			out	<<'\n'
-				<<"energy: "<<i.energy <<" kcal/mol\n"
+				<<"energy: "<<E_2_Ekcal(i.energy) <<" kcal/mol\n"
 				;
 		}
 
@@ -258,6 +255,13 @@ addSeparator (const bool yesNo )
 
 ////////////////////////////////////////////////////////////////////////////
 
+std::string
+OutputHandlerIntaRNA1::
+getSeparator()
+{
+	return "\n=========================\n\n";
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
 ////////////////////////////////////////////////////////////////////////////
@@ -66,6 +66,15 @@ public:
 	void
 	addSeparator (const bool yesNo );
 
+	/**
+	 * Provides the separator printed before the output if requested via
+	 * addSeparator().
+	 * @return the separator string
+	 */
+	static
+	std::string
+	getSeparator();
+
 protected:
 
 	//! whether or not to produce detailed (true) or normal (false) output
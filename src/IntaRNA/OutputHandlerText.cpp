@@ -17,10 +17,12 @@ OutputHandlerText(
 		std::ostream & out,
 		const InteractionEnergy & energy,
 		const size_t flankingLength_,
-		const bool detailedOutput
+		const bool detailedOutput,
+		const size_t flushThreshold
 		)
  :
 	out(out)
+	, outBuffer(out, flushThreshold)
 	, energy(energy)
 	, flankingLength(flankingLength_)
 	, detailedOutput(detailedOutput)
@@ -35,6 +37,7 @@ OutputHandlerText(
 OutputHandlerText::
 ~OutputHandlerText()
 {
+	outBuffer.flush();
 	out.flush();
 }
 
@@ -53,14 +56,11 @@ add( const Interaction & i )
 
 	// special handling if no base pairs present
 	if (i.basePairs.size() == 0) {
-		// ensure outputs do not intervene
-#if INTARNA_MULITHREADING
-		#pragma omp critical(intarna_omp_outputStreamUpdate)
-#endif
-		{
-			out <<"\n"
-				<<"no favorable interaction for "<<i.s1->getId() <<" and "<<i.s2->getId()<<std::endl;
-		} // omp critical(intarna_omp_outputStreamUpdate)
+		// format output into local buffer (no locking needed)
+		outBuffer.getStream() <<"\n"
+				<<"no favorable interaction for "<<i.s1->getId() <<" and "<<i.s2->getId()<<'\n';
+		// write buffer to stream if needed
+		outBuffer.flushIfFull();
 		return;
 	}
 
@@ -253,13 +253,11 @@ add( const Interaction & i )
 	// get individual energy contributions
 	InteractionEnergy::EnergyContributions contr = energy.getE_contributions(i);
 
-	// ensure outputs do not intervene
-#if INTARNA_MULITHREADING
-	#pragma omp critical(intarna_omp_outputStreamUpdate)
-#endif
+	// format output into local buffer (no locking needed)
+	std::ostream & outBuf = outBuffer.getStream();
 	{
 		// print full interaction to output stream
-		out <<'\n'
+		outBuf <<'\n'
 			// get ID of s1
 			<<i.s1->getId() <<'\n'
 			// get position in s1
@@ -279,7 +277,7 @@ add( const Interaction & i )
 			;
 
 		if (detailedOutput) {
-			out
+			outBuf
 				// interaction range
 				<<"\n"
 				<<"interaction seq1   = "<<(i.basePairs.begin()->first +1)<<" -- "<<(i.basePairs.rbegin()->first +1) <<'\n'
@@ -287,40 +285,43 @@ add( const Interaction & i )
 				;
 		} // detailed
 			// print energy
-		out
+		outBuf
 			<<"\n"
-			<<"interaction energy = "<<i.energy <<" kcal/mol\n"
+			<<"interaction energy = "<<E_2_Ekcal(i.energy) <<" kcal/mol\n"
 			;
 
 		if (detailedOutput) {
-			out
-				<<"  = E(init)        = "<<contr.init<<'\n'
-				<<"  + E(loops)       = "<<contr.loops<<'\n'
-				<<"  + E(dangleLeft)  = "<<contr.dangleLeft<<'\n'
-				<<"  + E(dangleRight) = "<<contr.dangleRight<<'\n'
-				<<"  + E(endLeft)     = "<<contr.endLeft<<'\n'
-				<<"  + E(endRight)    = "<<contr.endRight<<'\n'
-				<<"  + ED(seq1)       = "<<contr.ED1<<'\n'
-				<<"  + ED(seq2)       = "<<contr.ED2<<'\n'
-				<<"  + Pu(seq1)       = "<<std::exp(-contr.ED1/energy.getRT())<<'\n'
-				<<"  + Pu(seq2)       = "<<std::exp(-contr.ED2/energy.getRT())<<'\n'
+			outBuf
+				<<"  = E(init)        = "<<E_2_Ekcal(contr.init)<<'\n'
+				<<"  + E(loops)       = "<<E_2_Ekcal(contr.loops)<<'\n'
+				<<"  + E(dangleLeft)  = "<<E_2_Ekcal(contr.dangleLeft)<<'\n'
+				<<"  + E(dangleRight) = "<<E_2_Ekcal(contr.dangleRight)<<'\n'
+				<<"  + E(endLeft)     = "<<E_2_Ekcal(contr.endLeft)<<'\n'
+				<<"  + E(endRight)    = "<<E_2_Ekcal(contr.endRight)<<'\n'
+				<<"  + ED(seq1)       = "<<E_2_Ekcal(contr.ED1)<<'\n'
+				<<"  + ED(seq2)       = "<<E_2_Ekcal(contr.ED2)<<'\n'
+				<<"  + Pu(seq1)       = "<<std::exp(-E_2_Ekcal(contr.ED1)/energy.getRT())<<'\n'
+				<<"  + Pu(seq2)       = "<<std::exp(-E_2_Ekcal(contr.ED2)/energy.getRT())<<'\n'
 				;
 
 			// print seed information if available
 			if (i.seed != NULL) {
-				out
+				outBuf
 					<<"\n"
 					<<"seed seq1   = "<<(i.seed->bp_i.first +1)<<" -- "<<(i.seed->bp_j.first +1) <<'\n'
 					<<"seed seq2   = "<<(i.seed->bp_j.second +1)<<" -- "<<(i.seed->bp_i.second +1) <<'\n'
-					<<"seed energy = "<<(i.seed->energy)<<" kcal/mol\n"
-					<<"seed ED1    = "<<energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first )<<" kcal/mol\n"
-					<<"seed ED2    = "<<energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second )<<" kcal/mol\n"
-					<<"seed Pu1    = "<<std::exp(-(energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first ))/energy.getRT())<<'\n'
-					<<"seed Pu2    = "<<std::exp(-(energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second ))/energy.getRT())<<'\n'
+					<<"seed energy = "<<E_2_Ekcal(i.seed->energy)<<" kcal/mol\n"
+					<<"seed ED1    = "<<E_2_Ekcal(energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first ))<<" kcal/mol\n"
+					<<"seed ED2    = "<<E_2_Ekcal(energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second ))<<" kcal/mol\n"
+					<<"seed Pu1    = "<<std::exp(-E_2_Ekcal(energy.getED1( i.seed->bp_i.first, i.seed->bp_j.first ))/energy.getRT())<<'\n'
+					<<"seed Pu2    = "<<std::exp(-E_2_Ekcal(energy.getAccessibility2().getAccessibilityOrigin().getED( i.seed->bp_j.second, i.seed->bp_i.second ))/energy.getRT())<<'\n'
 					;
 			} // seed
 		} // detailed
-	} // omp critical(intarna_omp_outputStreamUpdate)
+	}
+
+	// write buffer to stream if needed
+	outBuffer.flushIfFull();
 
 }
 
@@ -4,6 +4,7 @@
 
 #include "IntaRNA/OutputHandler.h"
 #include "IntaRNA/InteractionEnergy.h"
+#include "IntaRNA/OutputStreamBuffer.h"
 
 #include <iostream>
 
@@ -27,11 +28,14 @@ public:
 	 *        interaction to be printed in the output
 	 * @param detailedOutput if (true) detailed output is provided; normal
 	 *        reduced output otherwise
+	 * @param flushThreshold the number of locally buffered characters that
+	 *        triggers a write to out (0 = write each interaction directly)
 	 */
 	OutputHandlerText( std::ostream & out
 				, const InteractionEnergy & energy
 				, const size_t flankingLength = 10
-				, const bool detailedOutput = false );
+				, const bool detailedOutput = false
+				, const size_t flushThreshold = OutputStreamBuffer::defaultFlushThreshold );
 
 	/**
 	 * destruction, enforces a flush on the output stream.
@@ -64,6 +68,9 @@ protected:
 	//! the output stream to write the interaction text representation to
 	std::ostream & out;
 
+	//! local buffer of the formatted output to be written to out
+	OutputStreamBuffer outBuffer;
+
 	//! the interaction energy handler used for the energy computations
 	const InteractionEnergy & energy;
 
@@ -0,0 +1,51 @@
+#include "IntaRNA/OutputHandlerTopK.h"
+
+namespace IntaRNA {
+
+////////////////////////////////////////////////////////////////////////////
+
+OutputHandlerTopK::
+OutputHandlerTopK( const OutputTopK & topK )
+ :	OutputHandler()
+	, topK(topK)
+	, candidates()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+OutputHandlerTopK::
+~OutputHandlerTopK()
+{
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerTopK::
+add( const Interaction & interaction )
+{
+	// ignore empty interactions (no-interaction reports)
+	if (interaction.basePairs.empty()) {
+		return;
+	}
+	// count report
+	reportedInteractions++;
+	// store copy if candidate for global top-K
+	if (interaction.energy < topK.getMaxE()) {
+		candidates.push_back( interaction );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+OutputHandlerTopK::
+add( const InteractionRange & range )
+{
+	add( Interaction(range) );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+} // namespace
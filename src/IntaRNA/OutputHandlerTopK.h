@@ -0,0 +1,88 @@
+#ifndef INTARNA_OUTPUTHANDLERTOPK_H_
+#define INTARNA_OUTPUTHANDLERTOPK_H_
+
+#include "IntaRNA/OutputHandler.h"
+#include "IntaRNA/OutputTopK.h"
+
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * Output handler that collects all interactions of a prediction that are
+ * candidates for the global top-K output, i.e. that have an energy below
+ * the current bound of the given OutputTopK storage.
+ *
+ * The collected interactions have to be formatted and added to the storage
+ * before the sequences and energy handler of the prediction are deleted.
+ *
+ * @author Martin Mann
+ *
+ */
+class OutputHandlerTopK : public OutputHandler {
+
+protected:
+
+	//! the global top-K storage providing the energy bound
+	const OutputTopK & topK;
+
+	//! the collected candidate interactions
+	std::vector< Interaction > candidates;
+
+public:
+
+	/**
+	 * construction
+	 * @param topK the global top-K storage providing the energy bound
+	 */
+	OutputHandlerTopK( const OutputTopK & topK );
+
+	/**
+	 * destruction
+	 */
+	virtual ~OutputHandlerTopK();
+
+	/**
+	 * Stores a copy of the given interaction if its energy is below the
+	 * current bound of the top-K storage.
+	 *
+	 * @param interaction the interaction to add
+	 */
+	virtual
+	void
+	add( const Interaction & interaction );
+
+	/**
+	 * Handles a given RNA-RNA interaction range as a
+	 * RNA-RNA interaction with two base pairs.
+	 *
+	 * @param range the interaction range to add
+	 */
+	virtual
+	void
+	add( const InteractionRange & range );
+
+	/**
+	 * Access to the collected candidate interactions
+	 * @return the interactions that were below the top-K bound when added
+	 */
+	const std::vector< Interaction > &
+	getCandidates() const;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+const std::vector< Interaction > &
+OutputHandlerTopK::
+getCandidates() const
+{
+	return candidates;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_OUTPUTHANDLERTOPK_H_ */
@@ -0,0 +1,125 @@
+
+#include "IntaRNA/OutputReorderBuffer.h"
+
+#include <stdexcept>
+#include <thread>
+
+namespace IntaRNA {
+
+//////////////////////////////////////////////////////////////////////////
+
+OutputReorderBuffer::
+OutputReorderBuffer( std::ostream & out, const size_t window )
+ :	out(out)
+	, window(window)
+	, nextIndex(0)
+	, reportedWritten(0)
+	, aborted(false)
+	, pending()
+{
+	if (window == 0) {
+		throw std::runtime_error("OutputReorderBuffer() : window has to be > 0");
+	}
+#if INTARNA_MULITHREADING
+	omp_init_lock( &lock );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+OutputReorderBuffer::
+~OutputReorderBuffer()
+{
+#if INTARNA_MULITHREADING
+	omp_destroy_lock( &lock );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+bool
+OutputReorderBuffer::
+waitForSlot( const size_t index )
+{
+	while (true) {
+#if INTARNA_MULITHREADING
+		omp_set_lock( &lock );
+#endif
+		// check whether or not the task is within the window
+		const bool isAborted = aborted;
+		const bool inWindow = index < nextIndex + window;
+#if INTARNA_MULITHREADING
+		omp_unset_lock( &lock );
+#endif
+		if (isAborted) {
+			return false;
+		}
+		if (inWindow) {
+			return true;
+		}
+		// wait for other tasks to be completed
+		std::this_thread::yield();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+OutputReorderBuffer::
+add( const size_t index
+	, const std::string & output
+	, const size_t reported
+	, const std::string & separator )
+{
+#if INTARNA_MULITHREADING
+	omp_set_lock( &lock );
+#endif
+	if (!aborted) {
+		// store output
+		TaskOutput & taskOutput = pending[index];
+		taskOutput.output = output;
+		taskOutput.reported = reported;
+		taskOutput.separator = separator;
+
+		// write all outputs next in order
+		while ( !pending.empty() && pending.begin()->first == nextIndex ) {
+			const TaskOutput & next = pending.begin()->second;
+			// ensure outputs do not intervene
+#if INTARNA_MULITHREADING
+			#pragma omp critical(intarna_omp_outputStreamUpdate)
+#endif
+			{
+				if (next.reported > 0 && reportedWritten > 0) {
+					out <<next.separator;
+				}
+				out <<next.output;
+			} // omp critical(intarna_omp_outputStreamUpdate)
+			reportedWritten += next.reported;
+			pending.erase( pending.begin() );
+			nextIndex++;
+		}
+	}
+#if INTARNA_MULITHREADING
+	omp_unset_lock( &lock );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+OutputReorderBuffer::
+abort()
+{
+#if INTARNA_MULITHREADING
+	omp_set_lock( &lock );
+#endif
+	aborted = true;
+	pending.clear();
+#if INTARNA_MULITHREADING
+	omp_unset_lock( &lock );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,124 @@
+
+#ifndef INTARNA_OUTPUTREORDERBUFFER_H_
+#define INTARNA_OUTPUTREORDERBUFFER_H_
+
+#include "IntaRNA/general.h"
+
+#include <iostream>
+#include <map>
+#include <string>
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
+namespace IntaRNA {
+
+/**
+ * Writes the outputs of independently computed (indexed) tasks in the order
+ * of their indices to a stream, independently of the order of their
+ * completion.
+ *
+ * The outputs of completed tasks that cannot be written yet are buffered.
+ * To bound the memory needed, at most 'window' tasks can be processed ahead
+ * of the first task whose output was not written yet (see waitForSlot()).
+ *
+ * @author Martin Mann
+ *
+ */
+class OutputReorderBuffer
+{
+public:
+
+	/**
+	 * Construction
+	 *
+	 * @param out the stream to write the ordered output to
+	 * @param window the maximal number of tasks (>0) that can be processed
+	 *        ahead of the first task whose output was not written yet
+	 */
+	OutputReorderBuffer( std::ostream & out, const size_t window );
+
+	/**
+	 * Destruction
+	 */
+	virtual ~OutputReorderBuffer();
+
+	/**
+	 * Blocks until the task with the given index is within the window of
+	 * tasks to be processed or abort() was called.
+	 *
+	 * @param index the index of the task to be processed
+	 * @return true if the task can be processed; false if abort() was called
+	 */
+	bool
+	waitForSlot( const size_t index );
+
+	/**
+	 * Adds the output of a completed task and writes all outputs that are
+	 * next in order.
+	 *
+	 * @param index the index of the completed task
+	 * @param output the output of the task
+	 * @param reported the number of interactions reported by the task
+	 * @param separator the separator to be written before the output if
+	 *        both this task and any preceding task reported interactions
+	 */
+	void
+	add( const size_t index
+		, const std::string & output
+		, const size_t reported
+		, const std::string & separator = "" );
+
+	/**
+	 * Aborts the ordered output, i.e. releases all tasks waiting within
+	 * waitForSlot() and disables the output of all pending tasks.
+	 */
+	void
+	abort();
+
+protected:
+
+	/**
+	 * Output of a completed task
+	 */
+	class TaskOutput {
+	public:
+		//! the output of the task
+		std::string output;
+		//! the number of interactions reported by the task
+		size_t reported;
+		//! the separator to be written if needed
+		std::string separator;
+	};
+
+	//! the stream to write the ordered output to
+	std::ostream & out;
+
+	//! the maximal number of tasks processed ahead of nextIndex
+	const size_t window;
+
+	//! the index of the next task to be written
+	size_t nextIndex;
+
+	//! the number of interactions reported by all written tasks
+	size_t reportedWritten;
+
+	//! whether or not abort() was called
+	bool aborted;
+
+	//! the outputs of completed tasks not written yet
+	std::map< size_t, TaskOutput > pending;
+
+#if INTARNA_MULITHREADING
+	//! lock to synchronize the access to the members
+	omp_lock_t lock;
+#endif
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_OUTPUTREORDERBUFFER_H_ */
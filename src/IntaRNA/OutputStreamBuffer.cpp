@@ -0,0 +1,61 @@
+
+#include "IntaRNA/OutputStreamBuffer.h"
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
+namespace IntaRNA {
+
+//////////////////////////////////////////////////////////////////////////
+
+const size_t OutputStreamBuffer::defaultFlushThreshold;
+
+//////////////////////////////////////////////////////////////////////////
+
+OutputStreamBuffer::
+OutputStreamBuffer( std::ostream & out
+			, const size_t flushThreshold )
+ :	out(out)
+	, buffer()
+	, flushThreshold(flushThreshold)
+{
+	// ensure identical formatting of the buffered output
+	buffer.copyfmt( out );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+OutputStreamBuffer::
+~OutputStreamBuffer()
+{
+	// write remaining output
+	flush();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+OutputStreamBuffer::
+flush()
+{
+	// check if there is something to write
+	if (buffer.tellp() <= 0) {
+		return;
+	}
+	// get buffered block (outside the lock)
+	const std::string block = buffer.str();
+	buffer.str("");
+
+	// ensure outputs do not intervene
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_outputStreamUpdate)
+#endif
+	{
+		out.write( block.c_str(), block.size() );
+	} // omp critical(intarna_omp_outputStreamUpdate)
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
@@ -0,0 +1,104 @@
+
+#ifndef INTARNA_OUTPUTSTREAMBUFFER_H_
+#define INTARNA_OUTPUTSTREAMBUFFER_H_
+
+#include "IntaRNA/general.h"
+
+#include <iostream>
+#include <sstream>
+
+namespace IntaRNA {
+
+/**
+ * Collects the output of a single output handler (i.e. of a single thread)
+ * in a local buffer that is written to the shared output stream in blocks.
+ *
+ * Thus, the formatting of the output is done without locking and only
+ * the write of completed blocks is synchronized among the threads
+ * (omp critical(intarna_omp_outputStreamUpdate)).
+ *
+ * @author Martin Mann
+ *
+ */
+class OutputStreamBuffer
+{
+public:
+
+	//! default number of buffered characters that triggers a write
+	static const size_t defaultFlushThreshold = 65536;
+
+	/**
+	 * Construction
+	 *
+	 * @param out the stream to write the buffered output to
+	 * @param flushThreshold the number of buffered characters that triggers
+	 *        a write to out within flushIfFull() (0 = write each record)
+	 */
+	OutputStreamBuffer( std::ostream & out
+				, const size_t flushThreshold = defaultFlushThreshold );
+
+	/**
+	 * Destruction, writes all buffered output to the stream.
+	 */
+	virtual ~OutputStreamBuffer();
+
+	/**
+	 * Access to the buffer to write to
+	 * @return the buffer stream
+	 */
+	std::ostream &
+	getStream();
+
+	/**
+	 * Writes the buffered output to the stream if the flush threshold is
+	 * reached. To be called after each completed output record.
+	 */
+	void
+	flushIfFull();
+
+	/**
+	 * Writes the buffered output to the stream and clears the buffer.
+	 */
+	void
+	flush();
+
+protected:
+
+	//! the stream to write the buffered output to
+	std::ostream & out;
+
+	//! the local buffer of the output
+	std::stringstream buffer;
+
+	//! the number of buffered characters that triggers a write
+	const size_t flushThreshold;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+std::ostream &
+OutputStreamBuffer::
+getStream()
+{
+	return buffer;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+void
+OutputStreamBuffer::
+flushIfFull()
+{
+	if ( (size_t)buffer.tellp() >= flushThreshold ) {
+		flush();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_OUTPUTSTREAMBUFFER_H_ */
@@ -0,0 +1,121 @@
+#include "IntaRNA/OutputTopK.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace IntaRNA {
+
+//////////////////////////////////////////////////////////////////////////
+
+OutputTopK::
+OutputTopK( const size_t k )
+ :	k(k)
+	, heap()
+	, maxE(E_INF)
+{
+	if (k == 0) {
+		throw std::runtime_error("OutputTopK() : k has to be > 0");
+	}
+#if INTARNA_MULITHREADING
+	omp_init_lock( &lock );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+OutputTopK::
+~OutputTopK()
+{
+#if INTARNA_MULITHREADING
+	omp_destroy_lock( &lock );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+bool
+OutputTopK::
+add( const E_type energy, const std::string & output )
+{
+	// check without locking (bound is monotonically decreasing)
+	if (!(energy < getMaxE())) {
+		return false;
+	}
+
+	bool added = false;
+#if INTARNA_MULITHREADING
+	omp_set_lock( &lock );
+#endif
+	Entry entry;
+	entry.energy = energy;
+	entry.output = output;
+	if (heap.size() < k) {
+		// storage not full yet
+		heap.push_back( entry );
+		std::push_heap( heap.begin(), heap.end() );
+		added = true;
+	} else
+	if (entry < heap.front()) {
+		// replace the worst output
+		std::pop_heap( heap.begin(), heap.end() );
+		heap.back() = entry;
+		std::push_heap( heap.begin(), heap.end() );
+		added = true;
+	}
+	// update bound if storage is full
+	if (added && heap.size() == k) {
+		const E_type newMaxE = heap.front().energy;
+#if INTARNA_MULITHREADING
+		#pragma omp atomic write
+#endif
+		maxE = newMaxE;
+	}
+#if INTARNA_MULITHREADING
+	omp_unset_lock( &lock );
+#endif
+
+	return added;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+size_t
+OutputTopK::
+size() const
+{
+#if INTARNA_MULITHREADING
+	omp_set_lock( &lock );
+#endif
+	const size_t curSize = heap.size();
+#if INTARNA_MULITHREADING
+	omp_unset_lock( &lock );
+#endif
+	return curSize;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+OutputTopK::
+write( std::ostream & out, const std::string & separator ) const
+{
+#if INTARNA_MULITHREADING
+	omp_set_lock( &lock );
+#endif
+	// sort a copy to keep the heap intact
+	std::vector< Entry > sorted( heap );
+	std::sort( sorted.begin(), sorted.end() );
+	for (auto e = sorted.begin(); e != sorted.end(); e++) {
+		if (e != sorted.begin()) {
+			out <<separator;
+		}
+		out <<e->output;
+	}
+#if INTARNA_MULITHREADING
+	omp_unset_lock( &lock );
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
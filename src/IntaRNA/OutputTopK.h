@@ -0,0 +1,158 @@
+
+#ifndef INTARNA_OUTPUTTOPK_H_
+#define INTARNA_OUTPUTTOPK_H_
+
+#include "IntaRNA/general.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
+namespace IntaRNA {
+
+/**
+ * Thread-safe storage of the (formatted) outputs of the K interactions with
+ * lowest energy over all predictions of a program run.
+ *
+ * The outputs are kept in a bounded max-heap, i.e. an output replaces the
+ * one with highest energy if the storage is full.
+ * The energy an output has to be below to be stored (see getMaxE()) can be
+ * used as a global upper bound for the energy of interactions to be reported
+ * by the predictors (see OutputConstraint::maxEglobal).
+ *
+ * @author Martin Mann
+ *
+ */
+class OutputTopK
+{
+public:
+
+	/**
+	 * Construction
+	 *
+	 * @param k the maximal number of outputs to store (>0)
+	 */
+	OutputTopK( const size_t k );
+
+	/**
+	 * Destruction
+	 */
+	virtual ~OutputTopK();
+
+	/**
+	 * Provides the energy an interaction has to be below to be stored, i.e.
+	 * the energy of the K-th best output stored or E_INF if less than K
+	 * outputs are stored. The value is monotonically decreasing.
+	 *
+	 * @return the current energy bound
+	 */
+	E_type
+	getMaxE() const;
+
+	/**
+	 * Provides access to the energy bound returned by getMaxE() that is
+	 * updated by add(); it has to be read atomically.
+	 *
+	 * @return the address of the current energy bound
+	 */
+	const E_type *
+	getMaxEbound() const;
+
+	/**
+	 * Stores the output of an interaction if its energy is below getMaxE().
+	 *
+	 * @param energy the energy of the interaction
+	 * @param output the formatted output of the interaction
+	 * @return true if the output was stored; false otherwise
+	 */
+	bool
+	add( const E_type energy, const std::string & output );
+
+	/**
+	 * Provides the number of outputs stored
+	 * @return the number of stored outputs
+	 */
+	size_t
+	size() const;
+
+	/**
+	 * Writes all stored outputs sorted by increasing energy (ties are sorted
+	 * by output).
+	 *
+	 * @param out the stream to write to
+	 * @param separator the separator to be written between two outputs
+	 */
+	void
+	write( std::ostream & out, const std::string & separator = "" ) const;
+
+protected:
+
+	/**
+	 * Output of an interaction
+	 */
+	class Entry {
+	public:
+		//! the energy of the interaction
+		E_type energy;
+		//! the formatted output of the interaction
+		std::string output;
+		/**
+		 * Ordering by energy and output
+		 * @param e the entry to compare to
+		 * @return (energy, output) < (e.energy, e.output)
+		 */
+		bool operator < ( const Entry & e ) const {
+			return energy < e.energy || (!(e.energy < energy) && output < e.output);
+		}
+	};
+
+	//! the maximal number of outputs to store
+	const size_t k;
+
+	//! max-heap of the stored outputs
+	std::vector< Entry > heap;
+
+	//! the energy an interaction has to be below to be stored
+	E_type maxE;
+
+#if INTARNA_MULITHREADING
+	//! lock to synchronize the access to the heap
+	mutable omp_lock_t lock;
+#endif
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+OutputTopK::
+getMaxE() const
+{
+	E_type curMaxE;
+#if INTARNA_MULITHREADING
+	#pragma omp atomic read
+#endif
+	curMaxE = maxE;
+	return curMaxE;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+const E_type *
+OutputTopK::
+getMaxEbound() const
+{
+	return &maxE;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_OUTPUTTOPK_H_ */
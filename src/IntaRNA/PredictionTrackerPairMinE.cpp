@@ -1,10 +1,16 @@
 
 #include "IntaRNA/PredictionTrackerPairMinE.h"
 
+#include <algorithm>
+
 namespace IntaRNA {
 
 //////////////////////////////////////////////////////////////////////
 
+const size_t PredictionTrackerPairMinE::blockLevelMax = 3;
+
+//////////////////////////////////////////////////////////////////////
+
 PredictionTrackerPairMinE::
 PredictionTrackerPairMinE(
 		const InteractionEnergy & energy
@@ -17,7 +23,16 @@ PredictionTrackerPairMinE(
 	, outStream(NULL)
 	, E_INF_string(E_INF_string)
 	, pairMinE( energy.size1(), energy.size2(), E_INF ) // init E_INF
+	, blockMinE()
+	, floorLog2( std::max(energy.size1(),energy.size2())+1, 0 )
 {
+	// setup lookup of block lengths
+	for (size_t w=2; w<floorLog2.size(); w++) {
+		floorLog2[w] = floorLog2[w/2] + 1;
+	}
+	// block lengths are limited by the maximal interaction lengths
+	blockMinE.resize( std::min( blockLevelMax, floorLog2.at(energy.getAccessibility1().getMaxLength()) )+1
+			, std::vector< E2dMatrix * >( std::min( blockLevelMax, floorLog2.at(energy.getAccessibility2().getMaxLength()) )+1, NULL ) );
 #if INTARNA_IN_DEBUG_MODE
 	if (streamName.empty()) {
 		throw std::runtime_error("PredictionTrackerPairMinE() : streamName empty");
@@ -44,7 +59,16 @@ PredictionTrackerPairMinE(
 	, outStream(outStream)
 	, E_INF_string(E_INF_string)
 	, pairMinE( energy.size1(), energy.size2(), E_INF ) // init E_INF
+	, blockMinE()
+	, floorLog2( std::max(energy.size1(),energy.size2())+1, 0 )
 {
+	// setup lookup of block lengths
+	for (size_t w=2; w<floorLog2.size(); w++) {
+		floorLog2[w] = floorLog2[w/2] + 1;
+	}
+	// block lengths are limited by the maximal interaction lengths
+	blockMinE.resize( std::min( blockLevelMax, floorLog2.at(energy.getAccessibility1().getMaxLength()) )+1
+			, std::vector< E2dMatrix * >( std::min( blockLevelMax, floorLog2.at(energy.getAccessibility2().getMaxLength()) )+1, NULL ) );
 }
 
 //////////////////////////////////////////////////////////////////////
@@ -52,6 +76,9 @@ PredictionTrackerPairMinE(
 PredictionTrackerPairMinE::
 ~PredictionTrackerPairMinE()
 {
+	// compute index-pair-wise minima
+	resolveBlockMinE();
+
 	writeData( *outStream
 				, pairMinE
 				, energy
@@ -86,15 +113,78 @@ updateOptimumCalled( const size_t i1_, const size_t j1_
 	if (i2>j2) throw std::runtime_error("PredictionTrackerPairMinE::updateProfile() : i2 "+toString(i2)+" > j2 "+toString(j2));
 #endif
 
-	// update pair data
-	for (size_t k1=i1; k1<=j1; k1++) {
-		for (size_t k2=i2; k2<=j2; k2++) {
-			// check if E is smaller than current minE
-			if ( curE < pairMinE(k1,k2) ) {
-				// write new minimum
-				pairMinE(k1,k2) = curE;
+	// get block lengths covering the range with two blocks per dimension
+	// if possible, otherwise with blocks of maximal length
+	const size_t p1 = std::min( floorLog2[j1-i1+1], blockMinE.size()-1 );
+	const size_t p2 = std::min( floorLog2[j2-i2+1], blockMinE.at(p1).size()-1 );
+	const size_t b1 = ((size_t)1)<<p1;
+	const size_t b2 = ((size_t)1)<<p2;
+
+	// update minima of all (overlapping) blocks covering the range,
+	// where the last block per dimension is aligned to j1/j2
+	E2dMatrix & minE = getBlockMinE( p1, p2 );
+	for (size_t s1=i1; s1<=j1; s1+=b1) {
+		const size_t k1 = std::min( s1, j1+1-b1 );
+	for (size_t s2=i2; s2<=j2; s2+=b2) {
+		const size_t k2 = std::min( s2, j2+1-b2 );
+		if ( curE < minE(k1,k2) ) { minE(k1,k2) = curE; }
+	}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
+PredictionTrackerPairMinE::E2dMatrix &
+PredictionTrackerPairMinE::
+getBlockMinE( const size_t p1, const size_t p2 )
+{
+	// single index pairs are stored directly
+	if (p1 == 0 && p2 == 0) {
+		return pairMinE;
+	}
+	// allocate if not done yet (valid block starts only)
+	if (blockMinE[p1][p2] == NULL) {
+		blockMinE[p1][p2] = new E2dMatrix( pairMinE.size1()+1-(((size_t)1)<<p1)
+										, pairMinE.size2()+1-(((size_t)1)<<p2)
+										, E_INF );
+	}
+	return *(blockMinE[p1][p2]);
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void
+PredictionTrackerPairMinE::
+resolveBlockMinE()
+{
+	// propagate from longer to shorter blocks, i.e. each block minimum is
+	// pushed to its two halves (splitting seq1 blocks first)
+	for (size_t p1 = blockMinE.size(); p1-- > 0; ) {
+	for (size_t p2 = blockMinE.at(p1).size(); p2-- > 0; ) {
+		// skip unused block lengths and single index pairs
+		if (blockMinE[p1][p2] == NULL) {
+			continue;
+		}
+		const E2dMatrix & minE = *(blockMinE[p1][p2]);
+		// split in seq1 if possible, otherwise in seq2
+		const size_t half1 = (p1 > 0) ? (((size_t)1)<<(p1-1)) : 0;
+		const size_t half2 = (p1 > 0) ? 0 : (((size_t)1)<<(p2-1));
+		E2dMatrix & halfMinE = getBlockMinE( (p1 > 0 ? p1-1 : p1), (p1 > 0 ? p2 : p2-1) );
+		// push all block starts
+		for (size_t k1=0; k1 < minE.size1(); k1++) {
+		for (size_t k2=0; k2 < minE.size2(); k2++) {
+			const E_type curE = minE(k1,k2);
+			if ( curE < halfMinE(k1,k2) ) {
+				halfMinE(k1,k2) = curE;
 			}
+			if ( curE < halfMinE(k1+half1,k2+half2) ) {
+				halfMinE(k1+half1,k2+half2) = curE;
+			}
+		}
 		}
+		// cleanup
+		INTARNA_CLEANUP( blockMinE[p1][p2] );
+	}
 	}
 }
 
@@ -135,7 +225,7 @@ writeData( std::ostream &out
 				out<<E_INF_string;
 			} else {
 				// print energy
-				out <<pairMinE(i,j);
+				out <<E_2_Ekcal(pairMinE(i,j));
 			}
 		}
 		// line end
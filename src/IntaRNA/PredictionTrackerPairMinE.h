@@ -6,6 +6,7 @@
 #include "IntaRNA/InteractionEnergy.h"
 
 #include <iostream>
+#include <vector>
 
 #include <boost/algorithm/string.hpp>
 #include <boost/numeric/ublas/matrix.hpp>
@@ -17,7 +18,20 @@ namespace IntaRNA {
  * Collects for each intermolecular index pair the minimal energy of any interaction
  * covering this pair (even if not forming a base pair).
  *
- * The pair data is written to stream on destruction.
+ * To avoid the update of all covered index pairs for each
+ * Predictor.updateOptima() call, each interaction range is split into four
+ * (overlapping) blocks of power-of-two lengths, which are stored
+ * in a 2D sparse table of block minima. The index-pair-wise minima
+ * are resolved in a single sweep before the pair data is written to
+ * stream on destruction.
+ *
+ * Memory : each used block length combination needs its own n1 x n2 matrix.
+ * Block lengths are thus limited to 2^blockLevelMax per sequence, such that
+ * at most (blockLevelMax+1)^2 matrices (including the pair matrix) are
+ * allocated, i.e. 16x the memory of the pair matrix for the default.
+ * Longer interaction ranges are covered by
+ * ceil(w1/2^blockLevelMax)*ceil(w2/2^blockLevelMax) blocks of maximal length
+ * instead of four.
  */
 class PredictionTrackerPairMinE: public PredictionTracker
 {
@@ -103,8 +117,41 @@ protected:
 	typedef boost::numeric::ublas::matrix<E_type> E2dMatrix;
 
 	//! the index-pair-wise minimal energy values
+	//! (block minima of the lengths (1,1) until resolved via resolveBlockMinE())
 	E2dMatrix pairMinE;
 
+	//! the maximal log2 of the block lengths per sequence
+	static const size_t blockLevelMax;
+
+	//! blockMinE[p1][p2](k1,k2) = minimal energy of any interaction covering
+	//! the block [k1,k1+2^p1-1]x[k2,k2+2^p2-1] (NULL if not used yet);
+	//! blockMinE[0][0] is not used (pairMinE instead).
+	//! Each matrix holds the (n1-2^p1+1)x(n2-2^p2+1) valid block starts only,
+	//! is allocated on first use and freed by resolveBlockMinE().
+	//! Levels are limited by blockLevelMax and the maximal interaction lengths.
+	std::vector< std::vector< E2dMatrix * > > blockMinE;
+
+	//! floorLog2[w] = largest p with 2^p <= w (for w>0)
+	std::vector< size_t > floorLog2;
+
+	/**
+	 * Provides the block minima matrix for the given block lengths and
+	 * allocates it if not done yet.
+	 *
+	 * @param p1 the log2 of the block length in seq1
+	 * @param p2 the log2 of the block length in seq2
+	 * @return the according block minima matrix
+	 */
+	E2dMatrix &
+	getBlockMinE( const size_t p1, const size_t p2 );
+
+	/**
+	 * Propagates all block minima down to the index pairs, i.e. into
+	 * pairMinE, and frees the block minima matrices.
+	 */
+	void
+	resolveBlockMinE();
+
 	/**
 	 * Writes profile data to stream.
 	 *
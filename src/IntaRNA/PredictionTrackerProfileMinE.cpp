@@ -18,8 +18,8 @@ PredictionTrackerProfileMinE(
 	, seq1stream(NULL)
 	, seq2stream(NULL)
 	, E_INF_string(E_INF_string)
-	, seq1minE( seq1streamName.empty() ? 0 : energy.size1(), E_INF ) // init E_INF
-	, seq2minE( seq2streamName.empty() ? 0 : energy.size2(), E_INF ) // init E_INF
+	, seq1minE( seq1streamName.empty() ? 0 : 2*energy.size1(), E_INF ) // init E_INF
+	, seq2minE( seq2streamName.empty() ? 0 : 2*energy.size2(), E_INF ) // init E_INF
 {
 	// open streams
 	if (!seq1streamName.empty()) {
@@ -55,8 +55,8 @@ PredictionTrackerProfileMinE(
 	, seq1stream(seq1stream)
 	, seq2stream(seq2stream)
 	, E_INF_string(E_INF_string)
-	, seq1minE( seq1stream==NULL ? 0 : energy.size1(), E_INF ) // init E_INF
-	, seq2minE( seq2stream==NULL ? 0 : energy.size2(), E_INF ) // init E_INF
+	, seq1minE( seq1stream==NULL ? 0 : 2*energy.size1(), E_INF ) // init E_INF
+	, seq2minE( seq2stream==NULL ? 0 : 2*energy.size2(), E_INF ) // init E_INF
 {
 }
 
@@ -67,15 +67,17 @@ PredictionTrackerProfileMinE::
 {
 	// write profiles to streams
 	if (seq1stream != NULL) {
+		resolveProfile( seq1minE );
 		writeProfile( *seq1stream
-					, seq1minE.begin()
+					, seq1minE.begin() + energy.size1()
 					, seq1minE.end()
 					, energy.getAccessibility1().getSequence()
 					, E_INF_string );
 	}
 	if (seq2stream != NULL) {
+		resolveProfile( seq2minE );
 		writeProfile( *seq2stream
-					, seq2minE.begin()
+					, seq2minE.begin() + energy.size2()
 					, seq2minE.end()
 					, energy.getAccessibility2().getAccessibilityOrigin().getSequence()
 					, E_INF_string );
@@ -130,18 +132,44 @@ updateProfile(	  MinEProfile & profile
 {
 	// update if the profile is not empty (is to be filled)
 	if (! profile.empty()) {
+		// sequence length
+		const size_t n = profile.size()/2;
 #if INTARNA_IN_DEBUG_MODE
-		if (i>=profile.size() || j>=profile.size()) throw std::runtime_error("PredictionTrackerProfileMinE::updateProfile() : index range ["+toString(i)+","+toString(j)+"] exceeds sequence length "+toString(profile.size()));
+		if (i>=n || j>=n) throw std::runtime_error("PredictionTrackerProfileMinE::updateProfile() : index range ["+toString(i)+","+toString(j)+"] exceeds sequence length "+toString(n));
 		if (i>j) throw std::runtime_error("PredictionTrackerProfileMinE::updateProfile() : i "+toString(i)+" > j "+toString(j));
 #endif
-		// update profile data
-		for (size_t k=i; k<=j; k++) {
+		// update all tree nodes covering [i,j] bottom-up
+		for (size_t l=i+n, r=j+n+1; l<r; l/=2, r/=2) {
 			// check if E is smaller than current minE
-			if ( E < profile.at(k) ) {
-				// write new minimum
-				profile[k] = E;
+			if (l%2 == 1) {
+				if ( E < profile[l] ) { profile[l] = E; }
+				l++;
 			}
+			if (r%2 == 1) {
+				r--;
+				if ( E < profile[r] ) { profile[r] = E; }
+			}
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
+void
+PredictionTrackerProfileMinE::
+resolveProfile( MinEProfile & profile )
+{
+	// propagate minima from the root towards the leaves (position data)
+	for (size_t k=1; k < profile.size()/2; k++) {
+		// check if E is smaller than current minE of the children
+		if ( profile[k] < profile[2*k] ) {
+			profile[2*k] = profile[k];
+		}
+		if ( profile[k] < profile[2*k+1] ) {
+			profile[2*k+1] = profile[k];
 		}
+		// mark as propagated
+		profile[k] = E_INF;
 	}
 }
 
@@ -15,7 +15,11 @@ namespace IntaRNA {
  * Collects for each sequence position the minimal energy of any interaction
  * enclosing this position.
  *
- * The profile(s) of this information is written to stream on destruction.
+ * The profiles are stored as segment trees, such that each
+ * Predictor.updateOptima() call updates only O(log(interaction width))
+ * entries. The position-wise minima are resolved in a single sweep
+ * before the profile(s) of this information is written to stream on
+ * destruction.
  */
 class PredictionTrackerProfileMinE: public PredictionTracker
 {
@@ -104,7 +108,10 @@ protected:
 	//! the output string representation of E_INF values in the profile output
 	const std::string E_INF_string;
 
-	//! container definition for minE profile data
+	//! container definition for minE profile data, i.e. a segment tree of
+	//! size 2*n: the entries [n,2n) hold the position-wise minima and the
+	//! inner nodes [1,n) the minima of ranges still to be propagated
+	//! to their children (see resolveProfile())
 	typedef std::vector<E_type> MinEProfile;
 
 	//! the position-wise minimal energy values for seq1
@@ -114,7 +121,8 @@ protected:
 	MinEProfile seq2minE;
 
 	/**
-	 * Updates a given minE profile if not empty.
+	 * Updates a given minE profile if not empty, i.e. the minimum of all
+	 * tree nodes covering the range [i,j] is updated.
 	 *
 	 * @param profile the minE profile to update
 	 * @param i the first index to update (inclusive)
@@ -128,6 +136,16 @@ protected:
 					, const size_t j
 					, const E_type E);
 
+	/**
+	 * Propagates the minima of all inner nodes of the given minE profile
+	 * down to the position-wise minima.
+	 *
+	 * @param profile the minE profile to resolve
+	 */
+	static
+	void
+	resolveProfile( MinEProfile & profile );
+
 	/**
 	 * Writes profile data to stream.
 	 *
@@ -178,7 +196,7 @@ writeProfile( std::ostream &out
 		if ( E_isINF( *curE ) ) {
 			out<<E_INF_string <<'\n';
 		} else {
-			out <<*curE <<'\n';
+			out <<E_2_Ekcal(*curE) <<'\n';
 		}
 		// increase position counter
 		i++;
@@ -4,12 +4,19 @@
 
 #include "IntaRNA/general.h"
 #include "IntaRNA/InteractionEnergyIdxOffset.h"
+#include "IntaRNA/InteractionEnergyIdxOffsetTyped.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
 
 #include "IntaRNA/OutputConstraint.h"
 #include "IntaRNA/OutputHandler.h"
 
 #include "IntaRNA/PredictionTracker.h"
 
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
 namespace IntaRNA {
 
 /**
@@ -72,6 +79,16 @@ public:
 	size_t
 	getMaxInteractionWidth( const size_t w, const size_t maxLoopSize );
 
+	/**
+	 * Sets the maximal number of threads to be used for parallel computations
+	 * within a single predict() call (if supported by the predictor).
+	 * The prediction results do not depend on the number of threads.
+	 *
+	 * @param threads the maximal number of threads to be used (>0)
+	 */
+	void
+	setThreads( const size_t threads );
+
 protected:
 
 	//! energy computation handler
@@ -83,6 +100,26 @@ protected:
 	//! prediction tracker to be used
 	PredictionTracker * predTracker;
 
+	//! the energy handler if it is of type InteractionEnergyVrna (otherwise
+	//! NULL) to run DP kernels specialized for this energy type
+	const InteractionEnergyVrna * const energyVrna;
+
+	//! the energy handler if it is of type InteractionEnergyBasePair
+	//! (otherwise NULL) to run DP kernels specialized for this energy type
+	const InteractionEnergyBasePair * const energyBasePair;
+
+	//! maximal number of threads to be used within predict() (see setThreads())
+	size_t threads;
+
+	/**
+	 * Provides the number of threads to be used for parallel computations
+	 * within predict(), i.e. the number given via setThreads() or 1 if called
+	 * from within an active parallel region (no nested parallelization).
+	 *
+	 * @return the number of threads to be used
+	 */
+	size_t
+	getThreadsToUse() const;
 
 	/**
 	 * Initializes the list of best solutions to be filled by updateOptima()
@@ -139,6 +176,9 @@ Predictor::Predictor( const InteractionEnergy & energy
 	energy(energy)
 	, output(output)
 	, predTracker(predTracker)
+	, energyVrna( dynamic_cast<const InteractionEnergyVrna*>(&energy) )
+	, energyBasePair( dynamic_cast<const InteractionEnergyBasePair*>(&energy) )
+	, threads(1)
 {
 }
 
@@ -166,6 +206,34 @@ getMaxInteractionWidth( const size_t w, const size_t maxLoopSize )
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+void
+Predictor::
+setThreads( const size_t threads )
+{
+	if (threads == 0) {
+		throw std::runtime_error("Predictor::setThreads() : number of threads has to be > 0");
+	}
+	this->threads = threads;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+Predictor::
+getThreadsToUse() const
+{
+#if INTARNA_MULITHREADING
+	// no nested parallelization
+	return omp_in_parallel() ? 1 : threads;
+#else
+	return 1;
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* PREDICTOR_H_ */
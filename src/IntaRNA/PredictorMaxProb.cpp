@@ -12,9 +12,11 @@ PredictorMaxProb(
 		, PredictionTracker * predTracker )
  : Predictor(energy,output,predTracker)
 	, hybridZ( 0,0 )
+	, hybridZArena()
 	, Z(0.0)
 	, maxProbInteraction(energy.getAccessibility1().getSequence()
 			,energy.getAccessibility2().getAccessibilityOrigin().getSequence())
+	, maxProbZ(0.0)
 {
 }
 
@@ -96,7 +98,7 @@ predict( const IndexRange & r1
 			&& energy.areComplementary( i1, i2 ))
 		{
 			// create new 2d matrix for different interaction site widths
-			hybridZ(i1,i2) = new E2dMatrix(
+			hybridZ(i1,i2) = hybridZArena.allocate(
 				/*w1 = */ std::min(energy.getAccessibility1().getMaxLength(), std::min( hybridZ.size1()-i1, maxWidthFori1i2) ),
 				/*w2 = */ std::min(energy.getAccessibility2().getMaxLength(), std::min( hybridZ.size2()-i2, maxWidthFori1i2) ));
 
@@ -131,13 +133,8 @@ void
 PredictorMaxProb::
 clear()
 {
-	// delete 3rd and 4th dimension of the matrix
-	for (E4dMatrix::iterator1 iRows = hybridZ.begin1(); iRows != hybridZ.end1(); iRows++) {
-		for (E4dMatrix::iterator2 ijEntry = iRows.begin(); ijEntry != iRows.end(); ijEntry++) {
-			// delete 2d matrix for current ij
-			 INTARNA_CLEANUP(*ijEntry);
-		}
-	}
+	// release 3rd and 4th dimension of the matrix (memory kept for reuse)
+	hybridZArena.clear();
 	// clear matrix, free data
 	hybridZ.clear();
 
@@ -159,7 +156,7 @@ fillHybridZ()
 	Z = 0.0;
 
 	// current Z value
-	E_type curZ = 0.0;
+	Z_type curZ = 0.0;
 	// iterate increasingly over all window sizes w1 (seq1) and w2 (seq2)
 	for (w1=0; w1<energy.getAccessibility1().getMaxLength(); w1++) {
 	for (w2=0; w2<energy.getAccessibility2().getMaxLength(); w2++) {
@@ -221,7 +218,7 @@ fillHybridZ()
 			// store value
 			(*hybridZ(i1,i2))(w1,w2) = curZ;
 			// update max prob interaction
-			updateOptima( i1,j1,i2,j2, (*hybridZ(i1,i2))(w1,w2), true );
+			updateOptimaZ( i1,j1,i2,j2, (*hybridZ(i1,i2))(w1,w2), true );
 		}
 		}
 	}
@@ -238,7 +235,7 @@ PredictorMaxProb::
 initOptima( const OutputConstraint & outConstraint )
 {
 	// initialize max prob interaction (partition function value)
-	maxProbInteraction.energy = 0.0;
+	maxProbZ = 0.0;
 	// reset boundary base pairs
 	maxProbInteraction.r1.from = RnaSequence::lastPos;
 	maxProbInteraction.r1.to = RnaSequence::lastPos;
@@ -256,7 +253,20 @@ void
 PredictorMaxProb::
 updateOptima( const size_t i1, const size_t j1
 		, const size_t i2, const size_t j2
-		, const E_type interZ
+		, const E_type curE
+		, const bool isHybridE )
+{
+	// convert energy into according Boltzmann weight
+	updateOptimaZ( i1,j1,i2,j2, energy.getBoltzmannWeight(curE), isHybridE );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMaxProb::
+updateOptimaZ( const size_t i1, const size_t j1
+		, const size_t i2, const size_t j2
+		, const Z_type interZ
 		, const bool isHybridZ )
 {
 //		{ LOG(DEBUG) <<"Z( "<<i1<<"-"<<j1<<", "<<i2<<"-"<<j2<<" ) = "
@@ -264,7 +274,7 @@ updateOptima( const size_t i1, const size_t j1
 //						<<" = " <<(eH + eE + eD); }
 
 	// add Boltzmann weights of all penalties
-	E_type curZ = isHybridZ ? interZ * energy.getBoltzmannWeight( energy.getE(i1,j1,i2,j2,0.0) ) : interZ;
+	Z_type curZ = isHybridZ ? interZ * energy.getBoltzmannWeight( energy.getE(i1,j1,i2,j2,0.0) ) : interZ;
 
 	// report call if needed
 	if (predTracker != NULL) {
@@ -275,9 +285,9 @@ updateOptima( const size_t i1, const size_t j1
 	// update overall partition function
 	Z += (double)curZ;
 
-	if (curZ > maxProbInteraction.energy) {
+	if (curZ > maxProbZ) {
 		// store new global min
-		maxProbInteraction.energy = curZ;
+		maxProbZ = curZ;
 		// store interaction boundaries
 		// left
 		maxProbInteraction.r1.from = i1+energy.getOffset1();
@@ -305,10 +315,10 @@ reportOptima( const OutputConstraint & outConstraint )
 	}
 
 	// maximal probability is
-	// double maxProb = (double)maxProbInteraction.getEnergy() / Z;
+	// double maxProb = (double)maxProbZ / Z;
 
 	// convert the partition function into an ensemble energy
-	maxProbInteraction.energy = energy.getE( maxProbInteraction.energy );
+	maxProbInteraction.energy = energy.getE( maxProbZ );
 
 	// push to output handler
 	output.add( maxProbInteraction );
@@ -4,6 +4,7 @@
 
 #include "IntaRNA/Predictor.h"
 #include "IntaRNA/InteractionRange.h"
+#include "IntaRNA/MatrixArena.h"
 
 #include <boost/numeric/ublas/matrix.hpp>
 
@@ -20,8 +21,11 @@ class PredictorMaxProb: public Predictor {
 
 protected:
 
-	//! matrix type to cover the energies for different interaction site widths
-	typedef boost::numeric::ublas::matrix<E_type> E2dMatrix;
+	//! memory arena providing the matrices for the different start positions
+	typedef MatrixArena<Z_type> E2dMatrixArena;
+
+	//! matrix type to cover the partition functions for different interaction site widths
+	typedef E2dMatrixArena::Matrix E2dMatrix;
 
 	//! full 4D DP-matrix for computation to hold all start position combinations
 	//! first index = start positions (i1,i2) of (seq1,seq2)
@@ -77,12 +81,19 @@ protected:
 	//! NOTE: hybridZ(i1,i2)==NULL if not complementary(seq1[i1],seq2[i2])
 	E4dMatrix hybridZ;
 
+	//! memory of all 2d matrices referenced by hybridZ,
+	//! kept for reuse among predict() calls
+	E2dMatrixArena hybridZArena;
+
 	//! the overall partition function = sum or all hybridZ entries
 	double Z;
 
 	//! interaction boundaries with maximal probability
 	InteractionRange maxProbInteraction;
 
+	//! partition function of maxProbInteraction
+	Z_type maxProbZ;
+
 protected:
 
 	/**
@@ -106,6 +117,25 @@ protected:
 	void
 	initOptima( const OutputConstraint & outConstraint );
 
+	/**
+	 * updates the global optimum if needed using the Boltzmann weight of the
+	 * given energy, see updateOptimaZ()
+	 *
+	 * @param i1 the index of the first sequence interacting with i2
+	 * @param j1 the index of the first sequence interacting with j2
+	 * @param i2 the index of the second sequence interacting with i1
+	 * @param j2 the index of the second sequence interacting with j1
+	 * @param curE the energy of the interaction site
+	 * @param isHybridE whether or not the given energy is only the
+	 *        hybridization energy (init+loops) or the total interaction energy
+	 */
+	virtual
+	void
+	updateOptima( const size_t i1, const size_t j1
+			, const size_t i2, const size_t j2
+			, const E_type curE
+			, const bool isHybridE );
+
 	/**
 	 * updates the global optimum if needed
 	 *
@@ -117,11 +147,10 @@ protected:
 	 * @param isHybridZ whether or not the given hybridZ is only for
 	 *        hybridizations (init+loops) or the total interaction energy details
 	 */
-	virtual
 	void
-	updateOptima( const size_t i1, const size_t j1
+	updateOptimaZ( const size_t i1, const size_t j1
 			, const size_t i2, const size_t j2
-			, const E_type Z
+			, const Z_type Z
 			, const bool isHybridZ );
 
 
@@ -16,12 +16,16 @@ PredictorMfe::PredictorMfe(
 	: Predictor(energy,output,predTracker)
 	, mfeInteractions()
 	, reportedInteractions()
+	, nextBestCandidates()
+	, nextBestCandidatesFilled(false)
 	, minStackingEnergy( energy.getBestE_interLoop() )
 	, minInitEnergy( energy.getE_init() )
 	, minDangleEnergy( energy.getBestE_dangling() )
 	, minEndEnergy( energy.getBestE_end() )
 {
-
+	// reported ranges are checked per index during suboptimal enumeration
+	reportedInteractions.first.enableDenseLookup();
+	reportedInteractions.second.enableDenseLookup();
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -46,7 +50,7 @@ initOptima( const OutputConstraint & outConstraint )
 	// init all interactions to be filled
 	for (InteractionList::iterator i = mfeInteractions.begin(); i!= mfeInteractions.end(); i++) {
 		// initialize global E minimum : should be below 0.0
-		i->energy = outConstraint.maxE;
+		i->energy = outConstraint.getMaxE();
 		// ensure it holds only the boundary
 		if (i->basePairs.size()!=2) {
 			i->basePairs.resize(2);
@@ -168,11 +172,14 @@ reportOptima( const OutputConstraint & outConstraint )
 	// number of reported interactions
 	size_t reported = 0;
 	// get maximal report energy = mfe + deltaE + precisionEpsilon
-	const E_type maxE = std::min(outConstraint.maxE, (E_type)(mfeInteractions.begin()->energy + outConstraint.deltaE + E_precisionEpsilon));
+	const E_type maxE = std::min(outConstraint.getMaxE(), (E_type)(mfeInteractions.begin()->energy + outConstraint.deltaE + E_precisionEpsilon));
 
 	// clear reported interaction ranges
 	reportedInteractions.first.clear();
 	reportedInteractions.second.clear();
+	// ensure next best candidates are recomputed
+	nextBestCandidates.clear();
+	nextBestCandidatesFilled = false;
 
 	// check if non-overlapping output is wanted
 	if (outConstraint.reportOverlap!=OutputConstraint::ReportOverlap::OVERLAP_BOTH) {
@@ -249,5 +256,81 @@ reportOptima( const OutputConstraint & outConstraint )
 
 ////////////////////////////////////////////////////////////////////////////
 
+void
+PredictorMfe::
+getNextBestCandidate( Interaction & curBest, const size_t size1, const size_t size2 )
+{
+	// store current best energy
+	const E_type curBestE = curBest.energy;
+
+	// overwrite energy for update
+	curBest.energy = E_INF;
+	curBest.basePairs.resize(2);
+
+	// fill heap with the best candidate of each left interaction end
+	if (!nextBestCandidatesFilled) {
+		nextBestCandidates.clear();
+		NextBestCandidate c;
+		for (c.i1=0; c.i1<size1; c.i1++) {
+			// ensure interaction site start is not covered
+			if (reportedInteractions.first.covers(c.i1)) {
+				continue;
+			}
+			for (c.i2=0; c.i2<size2; c.i2++) {
+				// ensure interaction site start is not covered
+				if (reportedInteractions.second.covers(c.i2)) {
+					continue;
+				}
+				if (updateNextBestCandidate( c, curBestE )) {
+					nextBestCandidates.push_back( c );
+				}
+			}
+		}
+		std::make_heap( nextBestCandidates.begin(), nextBestCandidates.end() );
+		nextBestCandidatesFilled = true;
+	}
+
+	// get top candidate not overlapping any reported interaction
+	while( !nextBestCandidates.empty() ) {
+		const NextBestCandidate & top = nextBestCandidates.front();
+		// check if still valid
+		if ( top.E >= curBestE
+			&& !reportedInteractions.first.overlaps( IndexRange(top.i1,top.j1) )
+			&& !reportedInteractions.second.overlaps( IndexRange(top.i2,top.j2) ))
+		{
+			//// FOUND THE NEXT BEST SOLUTION
+			// candidate is kept since it is invalidated by its own report
+			curBest.energy = top.E;
+			curBest.basePairs[0] = energy.getBasePair( top.i1, top.i2 );
+			curBest.basePairs[1] = energy.getBasePair( top.j1, top.j2 );
+			return;
+		}
+		// move invalid candidate to the end
+		std::pop_heap( nextBestCandidates.begin(), nextBestCandidates.end() );
+		NextBestCandidate & c = nextBestCandidates.back();
+		// update candidate if left end not covered
+		if ( !reportedInteractions.first.covers(c.i1)
+			&& !reportedInteractions.second.covers(c.i2)
+			&& updateNextBestCandidate( c, curBestE ))
+		{
+			std::push_heap( nextBestCandidates.begin(), nextBestCandidates.end() );
+		} else {
+			nextBestCandidates.pop_back();
+		}
+	}
+
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+PredictorMfe::
+updateNextBestCandidate( NextBestCandidate & /*c*/, const E_type /*minE*/ ) const
+{
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 
 } // namespace
@@ -9,6 +9,7 @@
 
 #include <list>
 #include <utility>
+#include <vector>
 
 namespace IntaRNA {
 
@@ -64,6 +65,41 @@ protected:
 	//! NOTE: the indices for seq2 are reversed
 	std::pair< IndexRangeList, IndexRangeList > reportedInteractions;
 
+	/**
+	 * Candidate for the next best interaction (see getNextBestCandidate()),
+	 * i.e. the best interaction known for the left end (i1,i2)
+	 */
+	class NextBestCandidate {
+	public:
+		//! overall energy of the interaction
+		E_type E;
+		//! left end in seq1
+		size_t i1;
+		//! right end in seq1
+		size_t j1;
+		//! left end in seq2
+		size_t i2;
+		//! right end in seq2
+		size_t j2;
+
+		/**
+		 * Heap order : the candidate to be reported first (lowest energy; ties
+		 * are resolved as by an index iteration decreasing in (i1,i2) and
+		 * increasing in (j1,j2)) is the maximal element.
+		 * @param c the candidate to compare to
+		 * @return true if c is to be reported before this candidate
+		 */
+		bool operator < ( const NextBestCandidate & c ) const;
+	};
+
+	//! heap of the next best candidates for all left interaction ends
+	//! (see getNextBestCandidate())
+	std::vector< NextBestCandidate > nextBestCandidates;
+
+	//! whether or not nextBestCandidates was filled within the current
+	//! reportOptima() call
+	bool nextBestCandidatesFilled;
+
 	//! minimal stacking energy
 	const E_type minStackingEnergy;
 	//! minimal interaction initiation energy
@@ -126,6 +162,43 @@ protected:
 	void
 	getNextBest( Interaction & curBest ) = 0;
 
+	/**
+	 * Generic implementation of getNextBest() based on the candidate heap
+	 * nextBestCandidates.
+	 *
+	 * On the first call within reportOptima(), the heap is filled in one pass
+	 * with the best candidate of each left end (i1,i2) via
+	 * updateNextBestCandidate(). Afterwards, only the top candidate is checked
+	 * against reportedInteractions. If it overlaps a reported interaction,
+	 * it is updated (or dropped) and the heap is repaired (lazy invalidation).
+	 * Thus, the enumeration of k interactions needs roughly
+	 * O(cells + k log(cells)) instead of k full matrix scans.
+	 *
+	 * @param curBest IN/OUT the current best interaction to be replaced (see
+	 *        getNextBest())
+	 * @param size1 the number of left ends to consider in seq1
+	 * @param size2 the number of left ends to consider in seq2
+	 */
+	void
+	getNextBestCandidate( Interaction & curBest, const size_t size1, const size_t size2 );
+
+	/**
+	 * Sets the given candidate to the best interaction with left end
+	 * (c.i1,c.i2) that has an energy of at least minE and does not overlap
+	 * any interaction stored in reportedInteractions. Ties are resolved by
+	 * smallest j1 and then smallest j2.
+	 *
+	 * Has to be overwritten by all predictors using getNextBestCandidate();
+	 * the default implementation provides no candidate.
+	 *
+	 * @param c IN/OUT the candidate to update (left end has to be set)
+	 * @param minE the minimal energy of the candidate
+	 * @return true if a candidate was found; false otherwise
+	 */
+	virtual
+	bool
+	updateNextBestCandidate( NextBestCandidate & c, const E_type minE ) const;
+
 	/**
 	 * Calls for the stored mfe and suboptimal solutions traceBack(i)
 	 * and pushes the according interactions to the output handler.
@@ -140,6 +213,22 @@ protected:
 
 };
 
+////////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+PredictorMfe::NextBestCandidate::
+operator < ( const NextBestCandidate & c ) const
+{
+	if (E != c.E) return E > c.E;
+	if (i1 != c.i1) return i1 < c.i1;
+	if (i2 != c.i2) return i2 < c.i2;
+	if (j1 != c.j1) return j1 > c.j1;
+	return j2 > c.j2;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 } // namespace
 
 #endif /* PREDICTORMFE_H_ */
@@ -16,6 +16,9 @@ PredictorMfe2d(
 	, hybridE_pq( 0,0 )
 	, hybridErange( energy.getAccessibility1().getSequence()
 			, energy.getAccessibility2().getAccessibilityOrigin().getSequence() )
+	, loopE_k2( energy.getMaxInternalLoopSize2()+1, E_INF )
+	, optimumCalls( NULL )
+	, optimumCallsMaxE( E_INF )
 {
 }
 
@@ -69,6 +72,16 @@ predict( const IndexRange & r1
 	// initialize mfe interaction for updates
 	initOptima( outConstraint );
 
+	// number of threads to be used (not for prediction tracking)
+	const size_t threadsToUse = (predTracker == NULL) ? getThreadsToUse() : 1;
+
+	if (threadsToUse > 1) {
+
+		// fill matrices and store best interactions
+		fillHybridE_parallel( outConstraint, threadsToUse );
+
+	} else {
+
 	// for all right ends j1
 	for (size_t j1 = hybridE_pq.size1(); j1-- > 0; ) {
 		// check if j1 is accessible
@@ -89,6 +102,8 @@ predict( const IndexRange & r1
 		}
 	}
 
+	}
+
 	// report mfe interaction
 	reportOptima( outConstraint );
 }
@@ -112,10 +127,10 @@ initHybridE( const size_t j1, const size_t j2
 	// global vars to avoid reallocation
 	size_t i1,i2,w1,w2,k1,k2;
 
-	// to mark as to be computed
-	const E_type E_MAX = std::numeric_limits<E_type>::max();
 	// to test whether computation is reasonable
 	const E_type minInitDangleEndEnergy = minInitEnergy + 2.0*minDangleEnergy + 2.0*minEndEnergy;
+	// current maximal energy of a reported interaction (read once)
+	const E_type maxE = outConstraint.getMaxE();
 
 	hybridErange.r1.from = std::max(i1init,j1-std::min(j1,energy.getAccessibility1().getMaxLength()+1));
 	hybridErange.r1.to = j1;
@@ -149,8 +164,8 @@ initHybridE( const size_t j1, const size_t j2
 			// if it holds for all w'>=w: ED1(i1+w1')+ED2(i2+w2')-outConstraint.maxE > -1*(min(w1',w2')*EmaxStacking + Einit + 2*Edangle + 2*Eend)
 			// ie. the ED values exceed the max possible energy gain of an interaction
 			if( largerWindowsINF
-				&& ( -1.0*(std::min(w1,w2)*minStackingEnergy + minInitDangleEndEnergy)
-					< (curED1 + energy.getED2(i2,j2) - outConstraint.maxE))
+				&& ( -1.0*((E_type)std::min(w1,w2)*minStackingEnergy + minInitDangleEndEnergy)
+					< (curED1 + energy.getED2(i2,j2) - maxE))
 				)
 			{
 				// mark as NOT to be computed
@@ -181,6 +196,29 @@ fillHybridE( const size_t j1, const size_t j2
 	assert(hybridErange.r1.to == j1);
 	assert(hybridErange.r2.to == j2);
 
+	// run DP kernel specialized for the energy type (if known)
+	if (energyVrna != NULL) {
+		fillHybridE_kernel( InteractionEnergyIdxOffsetTyped<InteractionEnergyVrna>(
+								*energyVrna, energy.getOffset1(), energy.getOffset2() )
+							, j1, j2 );
+	} else if (energyBasePair != NULL) {
+		fillHybridE_kernel( InteractionEnergyIdxOffsetTyped<InteractionEnergyBasePair>(
+								*energyBasePair, energy.getOffset1(), energy.getOffset2() )
+							, j1, j2 );
+	} else {
+		fillHybridE_kernel( energy, j1, j2 );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+template < class EnergyAccess >
+void
+PredictorMfe2d::
+fillHybridE_kernel( const EnergyAccess & energy
+			, const size_t j1, const size_t j2 )
+{
+
 	// global vars to avoid reallocation
 	size_t i1,i2,w1,w2,k1,k2;
 
@@ -229,20 +267,23 @@ fillHybridE( const size_t j1, const size_t j2
 
 				// check all combinations of decompositions into (i1,i2)..(k1,k2)-(j1,j2)
 				if (w1 > 2 && w2 > 2) {
+					// number of k2 values to check, ie. k2 in [i2+1,i2+k2num]
+					const size_t k2num = std::min(j2-1,i2+energy.getMaxInternalLoopSize2()+1) - i2;
 					for (k1=std::min(j1-1,i1+energy.getMaxInternalLoopSize1()+1); k1>i1; k1--) {
-					for (k2=std::min(j2-1,i2+energy.getMaxInternalLoopSize2()+1); k2>i2; k2--) {
-						// check if (k1,k2) are valid left boundary
-						if ( E_isNotINF( hybridE_pq(k1,k2) ) ) {
-							curMinE = std::min( curMinE,
-									(energy.getE_interLeft(i1,k1,i2,k2)
-											+ hybridE_pq(k1,k2) )
-									);
+						// access to the consecutive row hybridE_pq(k1,i2+1..)
+						const E_type * const hybridE_k1 = &(hybridE_pq(k1,i2+1));
+						// get loop energies for all k2 with (k1,k2) being valid left boundary
+						for (k2=0; k2<k2num; k2++) {
+							loopE_k2[k2] = E_isNotINF( hybridE_k1[k2] )
+									? energy.getE_interLeft(i1,k1,i2,i2+1+k2)
+									: E_INF;
 						}
-					}
+						// minimize over all k2 at once
+						curMinE = VectorizedEnergyMin::getMinSum( &(loopE_k2[0]), hybridE_k1, k2num, curMinE );
 					}
 				}
-				// store value
-				hybridE_pq(i1,i2) = curMinE;
+				// store value (sums involving E_INF are reduced to E_INF)
+				hybridE_pq(i1,i2) = std::min( curMinE, E_INF );
 				// update mfe if needed
 				updateOptima( i1,j1,i2,j2, hybridE_pq(i1,i2), true );
 				continue;
@@ -254,6 +295,93 @@ fillHybridE( const size_t j1, const size_t j2
 
 ////////////////////////////////////////////////////////////////////////////
 
+void
+PredictorMfe2d::
+fillHybridE_parallel( const OutputConstraint & outConstraint
+			, const size_t threadsToUse )
+{
+	// worker predictors with individual matrices (first worker is this)
+	std::vector< PredictorMfe2d * > workers( threadsToUse, this );
+	for (size_t t=1; t<workers.size(); t++) {
+		workers[t] = new PredictorMfe2d( energy.getEnergyOriginal(), output, NULL );
+		workers[t]->energy.setOffset1( energy.getOffset1() );
+		workers[t]->energy.setOffset2( energy.getOffset2() );
+		workers[t]->hybridE_pq.resize( hybridE_pq.size1(), hybridE_pq.size2() );
+	}
+
+	// recorded updateOptima() calls for each right end j2 of the current j1
+	std::vector< std::vector< OptimumCall > > optimumCallsJ2( hybridE_pq.size2() );
+
+	// for all right ends j1
+	for (size_t j1 = hybridE_pq.size1(); j1-- > 0; ) {
+		// check if j1 is accessible
+		if (!energy.isAccessible1(j1))
+			continue;
+
+		// only calls below the energy of the worst optimum known can update
+		// the optima, since this energy is not increasing over time
+		const E_type maxE = mfeInteractions.empty() ? -E_INF : mfeInteractions.rbegin()->energy;
+
+		// compute all right ends j2 in parallel (independent of each other)
+#if INTARNA_MULITHREADING
+		#pragma omp parallel for schedule(dynamic,1) num_threads( threadsToUse )
+#endif
+		for (size_t j2 = 0; j2 < hybridE_pq.size2(); j2++) {
+			optimumCallsJ2[j2].clear();
+			// check if j2 is accessible and base pair (j1,j2) possible
+			if (!energy.isAccessible2(j2) || !energy.areComplementary( j1, j2 ))
+				continue;
+			// get worker of this thread
+#if INTARNA_MULITHREADING
+			PredictorMfe2d & worker = *(workers.at( omp_get_thread_num() ));
+#else
+			PredictorMfe2d & worker = *(workers.at( 0 ));
+#endif
+			// fill matrix and record updateOptima() calls
+			worker.optimumCalls = &(optimumCallsJ2[j2]);
+			worker.optimumCallsMaxE = maxE;
+			worker.fillHybridE( j1, j2, outConstraint );
+			worker.optimumCalls = NULL;
+		}
+
+		// update optima in the order of the serial computation
+		for (size_t j2 = hybridE_pq.size2(); j2-- > 0; ) {
+			for (std::vector< OptimumCall >::const_iterator c = optimumCallsJ2[j2].begin(); c != optimumCallsJ2[j2].end(); c++) {
+				PredictorMfe::updateOptima( c->i1, c->j1, c->i2, c->j2, c->E, false );
+			}
+		}
+	}
+
+	// garbage collection
+	for (size_t t=1; t<workers.size(); t++) {
+		 INTARNA_CLEANUP(workers[t]);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe2d::
+updateOptima( const size_t i1, const size_t j1
+		, const size_t i2, const size_t j2
+		, const E_type interE
+		, const bool isHybridE )
+{
+	// check if to be evaluated directly
+	if (optimumCalls == NULL) {
+		PredictorMfe::updateOptima( i1,j1, i2,j2, interE, isHybridE );
+		return;
+	}
+	// get final energy of current interaction
+	const E_type curE = isHybridE ? energy.getE( i1,j1, i2,j2, interE ) : interE;
+	// record call if it can update the optima
+	if (curE < optimumCallsMaxE) {
+		optimumCalls->push_back( OptimumCall( i1,j1, i2,j2, curE ) );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 void
 PredictorMfe2d::
 traceBack( Interaction & interaction )
@@ -4,6 +4,9 @@
 
 #include "IntaRNA/PredictorMfe.h"
 #include "IntaRNA/Interaction.h"
+#include "IntaRNA/VectorizedEnergyMin.h"
+
+#include <vector>
 
 #include <boost/numeric/ublas/matrix.hpp>
 
@@ -74,6 +77,39 @@ protected:
 	//! the current range of computed entries within hybridE_pq set by initHybridE()
 	InteractionRange hybridErange;
 
+	//! loop energies for all k2 of the current (i1,k1,i2) decomposition
+	//! within fillHybridE_kernel() (E_INF if (k1,k2) is no valid left boundary)
+	std::vector<E_type> loopE_k2;
+
+	/**
+	 * An updateOptima() call recorded during the parallel computation
+	 */
+	class OptimumCall {
+	public:
+		//! init data
+		OptimumCall( const size_t i1, const size_t j1, const size_t i2, const size_t j2, const E_type E )
+			: i1(i1), j1(j1), i2(i2), j2(j2), E(E)
+		{}
+	public:
+		//! left end of the interaction in seq1
+		size_t i1;
+		//! right end of the interaction in seq1
+		size_t j1;
+		//! left end of the interaction in seq2
+		size_t i2;
+		//! right end of the interaction in seq2
+		size_t j2;
+		//! total energy of the interaction
+		E_type E;
+	};
+
+	//! if non-NULL, updateOptima() calls are not evaluated but recorded
+	//! if their total energy is below optimumCallsMaxE
+	std::vector< OptimumCall > * optimumCalls;
+
+	//! upper bound of the total energy of recorded updateOptima() calls
+	E_type optimumCallsMaxE;
+
 protected:
 
 	/**
@@ -109,6 +145,55 @@ protected:
 				, const size_t i1init=0, const size_t i2init=0
 				);
 
+	/**
+	 * DP kernel of fillHybridE() for an initialized hybridE matrix that is
+	 * specialized for the given energy access type to enable inlining.
+	 *
+	 * @param energy the energy access object (with index offset)
+	 * @param j1 end of the interaction within seq 1
+	 * @param j2 end of the interaction within seq 2
+	 */
+	template < class EnergyAccess >
+	void
+	fillHybridE_kernel( const EnergyAccess & energy
+				, const size_t j1, const size_t j2 );
+
+	/**
+	 * Computes the hybridE matrices for all right interaction ends (j1,j2)
+	 * using the given number of threads. For each j1, all j2 are computed in
+	 * parallel by worker predictors with individual matrices. Their
+	 * updateOptima() calls are recorded and replayed in the order of the
+	 * serial computation to ensure identical results.
+	 *
+	 * NOTE: prediction tracking is not supported since not all calls are
+	 * replayed.
+	 *
+	 * @param outConstraint constrains the interactions reported to the output handler
+	 * @param threadsToUse the number of threads to be used (>1)
+	 */
+	void
+	fillHybridE_parallel( const OutputConstraint & outConstraint
+				, const size_t threadsToUse );
+
+	/**
+	 * Updates the global list of best solutions found so far or records
+	 * the call if optimumCalls is non-NULL.
+	 *
+	 * @param i1 the index of the first sequence interacting with i2
+	 * @param j1 the index of the first sequence interacting with j2
+	 * @param i2 the index of the second sequence interacting with i1
+	 * @param j2 the index of the second sequence interacting with j1
+	 * @param energy the energy of the interaction site
+	 * @param isHybridE whether or not the given energy is only the
+	 *        hybridization energy (init+loops) or the total interaction energy
+	 */
+	virtual
+	void
+	updateOptima( const size_t i1, const size_t j1
+				, const size_t i2, const size_t j2
+				, const E_type energy
+				, const bool isHybridE );
+
 	/**
 	 * Fills a given interaction (boundaries given) with the according
 	 * hybridizing base pairs.
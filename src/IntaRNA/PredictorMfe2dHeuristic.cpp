@@ -2,6 +2,7 @@
 #include "IntaRNA/PredictorMfe2dHeuristic.h"
 
 #include <stdexcept>
+#include <vector>
 
 namespace IntaRNA {
 
@@ -101,64 +102,92 @@ void
 PredictorMfe2dHeuristic::
 fillHybridE()
 {
-	// compute entries
-	// current minimal value
-	E_type curE = E_INF, curEtotal = E_INF, curCellEtotal = E_INF;
-	size_t i1,i2,w1,w2;
-	BestInteraction * curCell = NULL;
-	const BestInteraction * rightExt = NULL;
+	// number of threads to compute the cells of a row in parallel
+	const size_t threadsToUse = getThreadsToUse();
+	// total energies of the current row to update the optima in serial order
+	std::vector<E_type> rowEtotal( hybridE.size2(), E_INF );
+
+#if INTARNA_MULITHREADING
+	#pragma omp parallel num_threads( threadsToUse ) if( threadsToUse > 1 )
+#endif
 	// iterate (decreasingly) over all left interaction starts
-	for (i1=hybridE.size1(); i1-- > 0;) {
-	for (i2=hybridE.size2(); i2-- > 0;) {
-		// direct cell access
-		curCell = &(hybridE(i1,i2));
-		// check if left side can pair
-		if (E_isINF(curCell->E)) {
-			continue;
+	for (size_t i1=hybridE.size1(); i1-- > 0;) {
+
+		// compute all cells of the row (independent of each other)
+#if INTARNA_MULITHREADING
+		#pragma omp for schedule(dynamic,16)
+#endif
+		for (size_t i2=0; i2<hybridE.size2(); i2++) {
+			rowEtotal[i2] = fillHybridE_cell( i1, i2 );
 		}
-		// current
-		curCellEtotal = energy.getE(i1,curCell->j1,i2,curCell->j2,curCell->E);
-
-		// TODO PARALLELIZE THIS DOUBLE LOOP ?!
-		// iterate over all loop sizes w1 (seq1) and w2 (seq2) (minus 1)
-		for (w1=1; w1-1 <= energy.getMaxInternalLoopSize1() && i1+w1<hybridE.size1(); w1++) {
-		for (w2=1; w2-1 <= energy.getMaxInternalLoopSize2() && i2+w2<hybridE.size2(); w2++) {
-			// direct cell access (const)
-			rightExt = &(hybridE(i1+w1,i2+w2));
-			// check if right side can pair
-			if (E_isINF(rightExt->E)) {
-				continue;
-			}
-			// check if interaction length is within boundary
-			if ( (rightExt->j1 +1 -i1) > energy.getAccessibility1().getMaxLength()
-				|| (rightExt->j2 +1 -i2) > energy.getAccessibility2().getMaxLength() )
-			{
-				continue;
-			}
-			// compute energy for this loop sizes
-			curE = energy.getE_interLeft(i1,i1+w1,i2,i2+w2) + rightExt->E;
-			// check if this combination yields better energy
-			curEtotal = energy.getE(i1,rightExt->j1,i2,rightExt->j2,curE);
-			if ( curEtotal < curCellEtotal )
-			{
-				// update current best for this left boundary
-				// copy right boundary
-				*curCell = *rightExt;
-				// set new energy
-				curCell->E = curE;
-				// store total energy to avoid recomputation
-				curCellEtotal = curEtotal;
+
+		// update mfe if needed (in the order of the serial computation to
+		// ensure identical results for any number of threads)
+#if INTARNA_MULITHREADING
+		#pragma omp single
+#endif
+		for (size_t i2=hybridE.size2(); i2-- > 0;) {
+			// check if left side can pair
+			if (E_isNotINF(hybridE(i1,i2).E)) {
+				updateOptima( i1,hybridE(i1,i2).j1, i2,hybridE(i1,i2).j2, rowEtotal[i2], false );
 			}
+		}
 
-		} // w2
-		} // w1
+	} // i1
 
-		// update mfe if needed
-		updateOptima( i1,curCell->j1, i2,curCell->j2, curCellEtotal, false );
+}
 
-	} // i2
-	} // i1
+////////////////////////////////////////////////////////////////////////////
+
+E_type
+PredictorMfe2dHeuristic::
+fillHybridE_cell( const size_t i1, const size_t i2 )
+{
+	// direct cell access
+	BestInteraction * curCell = &(hybridE(i1,i2));
+	// check if left side can pair
+	if (E_isINF(curCell->E)) {
+		return E_INF;
+	}
+	// current
+	E_type curE = E_INF, curEtotal = E_INF;
+	E_type curCellEtotal = energy.getE(i1,curCell->j1,i2,curCell->j2,curCell->E);
+	const BestInteraction * rightExt = NULL;
+
+	// iterate over all loop sizes w1 (seq1) and w2 (seq2) (minus 1)
+	for (size_t w1=1; w1-1 <= energy.getMaxInternalLoopSize1() && i1+w1<hybridE.size1(); w1++) {
+	for (size_t w2=1; w2-1 <= energy.getMaxInternalLoopSize2() && i2+w2<hybridE.size2(); w2++) {
+		// direct cell access (const)
+		rightExt = &(hybridE(i1+w1,i2+w2));
+		// check if right side can pair
+		if (E_isINF(rightExt->E)) {
+			continue;
+		}
+		// check if interaction length is within boundary
+		if ( (rightExt->j1 +1 -i1) > energy.getAccessibility1().getMaxLength()
+			|| (rightExt->j2 +1 -i2) > energy.getAccessibility2().getMaxLength() )
+		{
+			continue;
+		}
+		// compute energy for this loop sizes
+		curE = energy.getE_interLeft(i1,i1+w1,i2,i2+w2) + rightExt->E;
+		// check if this combination yields better energy
+		curEtotal = energy.getE(i1,rightExt->j1,i2,rightExt->j2,curE);
+		if ( curEtotal < curCellEtotal )
+		{
+			// update current best for this left boundary
+			// copy right boundary
+			*curCell = *rightExt;
+			// set new energy
+			curCell->E = curE;
+			// store total energy to avoid recomputation
+			curCellEtotal = curEtotal;
+		}
 
+	} // w2
+	} // w1
+
+	return curCellEtotal;
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -172,6 +201,14 @@ traceBack( Interaction & interaction )
 		return;
 	}
 
+	// check for single interaction (before sanity checks since not valid)
+	if (interaction.basePairs.at(0).first == interaction.basePairs.at(1).first) {
+		// delete second boundary (identical to first)
+		interaction.basePairs.resize(1);
+		// update done
+		return;
+	}
+
 #if INTARNA_IN_DEBUG_MODE
 	// sanity checks
 	if ( ! interaction.isValid() ) {
@@ -182,14 +219,6 @@ traceBack( Interaction & interaction )
 	}
 #endif
 
-	// check for single interaction
-	if (interaction.basePairs.at(0).first == interaction.basePairs.at(1).first) {
-		// delete second boundary (identical to first)
-		interaction.basePairs.resize(1);
-		// update done
-		return;
-	}
-
 	// ensure sorting
 	interaction.sort();
 	// get indices in hybridE for boundary base pairs
@@ -241,7 +270,8 @@ traceBack( Interaction & interaction )
 		assert( !traceNotFound );
 	}
 #if INTARNA_IN_DEBUG_MODE
-	if ( (j2-i2) > 1 ) {
+	// the remaining loop (i1,i2)-(j1,j2) can still contain a bulge in seq2
+	if ( (j2-i2) > energy.getMaxInternalLoopSize2()+1 ) {
 		throw std::runtime_error("PredictorMfe2dHeuristic::traceBack() : trace leaves ji<j2 : "+toString(i2)+"<"+toString(j2));
 	}
 #endif
@@ -266,74 +296,38 @@ void
 PredictorMfe2dHeuristic::
 getNextBest( Interaction & curBest )
 {
+	getNextBestCandidate( curBest, hybridE.size1(), hybridE.size2() );
+}
 
-	// get original
-	const E_type curBestE = curBest.energy;
+////////////////////////////////////////////////////////////////////////////
 
-	// TODO replace index iteration with something based on ranges from reportedInteractions
+bool
+PredictorMfe2dHeuristic::
+updateNextBestCandidate( NextBestCandidate & c, const E_type minE ) const
+{
+	return updateNextBestCandidate( c, minE, hybridE );
+}
 
-	// identify cell with next best non-overlapping interaction site
-	// iterate (decreasingly) over all left interaction starts
-	size_t i1,i2;
-	BestInteraction * curBestCell = NULL;
-	E_type curBestCellE = E_INF;
-	Interaction::BasePair curBestCellStart;
-	BestInteraction * curCell = NULL;
-	E_type curCellE = E_INF;
-	IndexRange r1,r2;
-	for (i1=hybridE.size1(); i1-- > 0;) {
-		// ensure interaction site start is not covered
-		if (reportedInteractions.first.covers(i1)) {
-			continue;
-		}
-		for (i2=hybridE.size2(); i2-- > 0;) {
-			// ensure interaction site start is not covered
-			if (reportedInteractions.second.covers(i2)) {
-				continue;
-			}
-			// direct cell access
-			curCell = &(hybridE(i1,i2));
-			// check if left side can pair
-			if (E_isINF(curCell->E))
-			{
-				continue;
-			}
-			// get overall energy of the interaction
-			curCellE = energy.getE(i1,curCell->j1,i2,curCell->j2,curCell->E);
-			// or energy is too low to be considered
-			// or energy is higher than current best found so far
-			if (curCellE < curBestE || curCellE >= curBestCellE )
-			{
-				continue;
-			}
-			// ensure site is not overlapping
-			r1.from = i1;
-			r1.to = curCell->j1;
-			if ( reportedInteractions.first.overlaps( r1 )) {
-				continue;
-			}
-			r2.from = i2;
-			r2.to = curCell->j2;
-			if ( reportedInteractions.second.overlaps( r2 )) {
-				continue;
-			}
-			//// FOUND THE NEXT BETTER SOLUTION
-			// overwrite current best found so far
-			curBestCell = curCell;
-			curBestCellE = curCellE;
-			curBestCellStart.first = i1;
-			curBestCellStart.second = i2;
-
-		} // i2
-	} // i1
+////////////////////////////////////////////////////////////////////////////
 
-	// overwrite curBest
-	curBest.energy = curBestCellE;
-	curBest.basePairs.resize(2);
-	if (E_isNotINF(curBestCellE)) {
-		curBest.basePairs[0] = energy.getBasePair( curBestCellStart.first, curBestCellStart.second );
-		curBest.basePairs[1] = energy.getBasePair( curBestCell->j1, curBestCell->j2 );
+bool
+PredictorMfe2dHeuristic::
+updateNextBestCandidate( NextBestCandidate & c, const E_type minE, const E2dMatrix & matrix ) const
+{
+	// direct cell access
+	const BestInteraction & curCell = matrix(c.i1,c.i2);
+	// check if left side can pair
+	if (E_isINF(curCell.E)) {
+		return false;
 	}
+	// the only interaction stored for this left end
+	c.E = energy.getE( c.i1, curCell.j1, c.i2, curCell.j2, curCell.E );
+	c.j1 = curCell.j1;
+	c.j2 = curCell.j2;
+	// check energy and ensure site is not overlapping
+	return c.E >= minE
+			&& !reportedInteractions.first.overlaps( IndexRange(c.i1,c.j1) )
+			&& !reportedInteractions.second.overlaps( IndexRange(c.i2,c.j2) );
 }
 
 ////////////////////////////////////////////////////////////////////////////
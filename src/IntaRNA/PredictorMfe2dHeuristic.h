@@ -108,6 +108,19 @@ protected:
 	void
 	fillHybridE();
 
+	/**
+	 * Computes the entry hybridE(i1,i2) from the entries of all larger left
+	 * boundaries (i1+w1,i2+w2), i.e. all entries of a row i1 are independent
+	 * of each other and depend only on rows > i1.
+	 *
+	 * @param i1 the left interaction boundary in seq 1
+	 * @param i2 the left interaction boundary in seq 2
+	 * @return the total energy of the best interaction with left boundary
+	 *         (i1,i2) or E_INF if (i1,i2) is no valid left boundary
+	 */
+	E_type
+	fillHybridE_cell( const size_t i1, const size_t i2 );
+
 	/**
 	 * Fills a given interaction (boundaries given) with the according
 	 * hybridizing base pairs.
@@ -131,6 +144,30 @@ protected:
 	void
 	getNextBest( Interaction & curBest );
 
+	/**
+	 * Sets the given candidate to the best interaction with left end
+	 * (c.i1,c.i2) within hybridE (see PredictorMfe::updateNextBestCandidate()).
+	 *
+	 * @param c IN/OUT the candidate to update (left end has to be set)
+	 * @param minE the minimal energy of the candidate
+	 * @return true if a candidate was found; false otherwise
+	 */
+	virtual
+	bool
+	updateNextBestCandidate( NextBestCandidate & c, const E_type minE ) const;
+
+	/**
+	 * Sets the given candidate to the interaction with left end (c.i1,c.i2)
+	 * within the given matrix (see updateNextBestCandidate()).
+	 *
+	 * @param c IN/OUT the candidate to update (left end has to be set)
+	 * @param minE the minimal energy of the candidate
+	 * @param matrix the hybridization energy matrix to get the candidate from
+	 * @return true if a valid candidate was found; false otherwise
+	 */
+	bool
+	updateNextBestCandidate( NextBestCandidate & c, const E_type minE, const E2dMatrix & matrix ) const;
+
 };
 
 } // namespace
@@ -2,6 +2,7 @@
 #include "IntaRNA/PredictorMfe2dHeuristicSeed.h"
 
 #include <stdexcept>
+#include <vector>
 
 namespace IntaRNA {
 
@@ -76,7 +77,7 @@ predict( const IndexRange & r1
 	hybridE.resize( hybridEsize1, hybridEsize2 );
 
 	// temp vars
-	size_t i1,i2,w1,w2;
+	size_t i1,i2;
 
 	// init hybridE matrix
 	bool isValidCell = true;
@@ -99,7 +100,7 @@ predict( const IndexRange & r1
 	} // i1
 
 	// init mfe without seed condition
-	OutputConstraint tmpOutConstraint(1, outConstraint.reportOverlap, outConstraint.maxE, outConstraint.deltaE);
+	OutputConstraint tmpOutConstraint(1, outConstraint.reportOverlap, outConstraint.maxE, outConstraint.deltaE, outConstraint.maxEglobal);
 	initOptima( tmpOutConstraint );
 
 	// compute hybridization energies WITHOUT seed condition
@@ -109,7 +110,7 @@ predict( const IndexRange & r1
 
 	// check if any interaction possible
 	// if not no seed-containing interaction is possible neither
-	if (!(this->mfeInteractions.begin()->energy < tmpOutConstraint.maxE)) {
+	if (!(this->mfeInteractions.begin()->energy < tmpOutConstraint.getMaxE())) {
 		// stop computation since no favorable interaction found
 		reportOptima(tmpOutConstraint);
 		return;
@@ -118,100 +119,138 @@ predict( const IndexRange & r1
 	// init mfe for later updates
 	initOptima( outConstraint );
 
-	// compute entries
-	// current minimal value
-	E_type curE = E_INF, curEtotal = E_INF, curCellEtotal = E_INF;
-	BestInteraction * curCell = NULL;
-	const BestInteraction * rightExt = NULL;
+	// compute entries and update mfe
+	hybridE_seed.resize( hybridE.size1(), hybridE.size2() );
+	fillHybridE_seed();
+
+	// report mfe interaction
+	reportOptima( outConstraint );
+
+}
+
 
+////////////////////////////////////////////////////////////////////////////
+
+void
+PredictorMfe2dHeuristicSeed::
+fillHybridE_seed()
+{
+	// number of threads to compute the cells of a row in parallel
+	const size_t threadsToUse = getThreadsToUse();
+	// total energies of the current row to update the optima in serial order
+	std::vector<E_type> rowEtotal( hybridE_seed.size2(), E_INF );
+
+#if INTARNA_MULITHREADING
+	#pragma omp parallel num_threads( threadsToUse ) if( threadsToUse > 1 )
+#endif
 	// iterate (decreasingly) over all left interaction starts
-	hybridE_seed.resize( hybridE.size1(), hybridE.size2() );
-	for (i1=hybridE_seed.size1(); i1-- > 0;) {
-	for (i2=hybridE_seed.size2(); i2-- > 0;) {
+	for (size_t i1=hybridE_seed.size1(); i1-- > 0;) {
 
-		// check if left side can pair
-		if (E_isINF(hybridE(i1,i2).E)) {
-			continue;
+		// compute all cells of the row (independent of each other)
+#if INTARNA_MULITHREADING
+		#pragma omp for schedule(dynamic,16)
+#endif
+		for (size_t i2=0; i2<hybridE_seed.size2(); i2++) {
+			rowEtotal[i2] = fillHybridE_seed_cell( i1, i2 );
 		}
-		// direct cell access
-		curCell = &(hybridE_seed(i1,i2));
-		// reset temporary variables
-		curEtotal = E_INF;
-		curCellEtotal = E_INF;
-
-		///////////////////////////////////////////////////////////////////
-		// check all extensions of interactions CONTAINING a seed already
-		///////////////////////////////////////////////////////////////////
-
-		// TODO PARALLELIZE THIS DOUBLE LOOP ?!
-		// iterate over all loop sizes w1 (seq1) and w2 (seq2)
-		for (w1=1; w1-1 <= energy.getMaxInternalLoopSize1() && i1+w1<hybridE_seed.size1(); w1++) {
-		for (w2=1; w2-1 <= energy.getMaxInternalLoopSize2() && i2+w2<hybridE_seed.size2(); w2++) {
-			// direct cell access to right side end of loop (seed has to be to the right of it)
-			rightExt = &(hybridE_seed(i1+w1,i2+w2));
-			// check if right side of loop can pair
-			if (E_isINF(rightExt->E)) {
-				continue;
-			}
-			// check if interaction length is within boundary
-			if ( (rightExt->j1 +1 -i1) > energy.getAccessibility1().getMaxLength()
-				|| (rightExt->j2 +1 -i2) > energy.getAccessibility2().getMaxLength() )
-			{
-				continue;
-			}
-			// compute energy for this loop sizes
-			curE = energy.getE_interLeft(i1,i1+w1,i2,i2+w2) + rightExt->E;
-			// check if this combination yields better energy
-			curEtotal = energy.getE(i1,rightExt->j1,i2,rightExt->j2,curE);
-			if ( curEtotal < curCellEtotal )
-			{
-				// update current best for this left boundary
-				// copy right boundary
-				*curCell = *rightExt;
-				// set new energy
-				curCell->E = curE;
-				// store overall energy
-				curCellEtotal = curEtotal;
-			}
-		} // w2
-		} // w1
-
-		///////////////////////////////////////////////////////////////////
-		// check if seed is starting here
-		///////////////////////////////////////////////////////////////////
-
-		// check if seed is possible for this left boundary
-		if ( E_isNotINF( seedHandler.getSeedE(i1,i2) ) ) {
-			// get right extension
-			w1 = seedHandler.getSeedLength1(i1,i2)-1; assert(i1+w1 < hybridE.size1());
-			w2 = seedHandler.getSeedLength2(i1,i2)-1; assert(i2+w2 < hybridE.size2());
-			rightExt = &(hybridE(i1+w1,i2+w2));
-			// get energy of seed interaction with best right extension
-			curE = seedHandler.getSeedE(i1,i2) + rightExt->E;
-			// check if this combination yields better energy
-			curEtotal = energy.getE(i1,rightExt->j1,i2,rightExt->j2,curE);
-			if ( curEtotal < curCellEtotal )
-			{
-				// update current best for this left boundary
-				// copy right boundary
-				*curCell = *rightExt;
-				// set new energy
-				curCell->E = curE;
-				// store total energy
-				curCellEtotal = curEtotal;
+
+		// update mfe if needed (in the order of the serial computation to
+		// ensure identical results for any number of threads)
+#if INTARNA_MULITHREADING
+		#pragma omp single
+#endif
+		for (size_t i2=hybridE_seed.size2(); i2-- > 0;) {
+			// check if left side can pair
+			if (E_isNotINF(hybridE(i1,i2).E)) {
+				// call superclass update routine
+				PredictorMfe2dHeuristic::updateOptima( i1,hybridE_seed(i1,i2).j1, i2,hybridE_seed(i1,i2).j2, rowEtotal[i2], false );
 			}
 		}
 
-		// update mfe if needed (call superclass update routine)
-		PredictorMfe2dHeuristic::updateOptima( i1,curCell->j1, i2,curCell->j2, curCellEtotal, false );
-
-	} // i2
 	} // i1
 
+}
 
-	// report mfe interaction
-	reportOptima( outConstraint );
+////////////////////////////////////////////////////////////////////////////
 
+E_type
+PredictorMfe2dHeuristicSeed::
+fillHybridE_seed_cell( const size_t i1, const size_t i2 )
+{
+	// check if left side can pair
+	if (E_isINF(hybridE(i1,i2).E)) {
+		return E_INF;
+	}
+	// direct cell access
+	BestInteraction * curCell = &(hybridE_seed(i1,i2));
+	// temporary variables
+	E_type curE = E_INF, curEtotal = E_INF, curCellEtotal = E_INF;
+	const BestInteraction * rightExt = NULL;
+	size_t w1, w2;
+
+	///////////////////////////////////////////////////////////////////
+	// check all extensions of interactions CONTAINING a seed already
+	///////////////////////////////////////////////////////////////////
+
+	// iterate over all loop sizes w1 (seq1) and w2 (seq2)
+	for (w1=1; w1-1 <= energy.getMaxInternalLoopSize1() && i1+w1<hybridE_seed.size1(); w1++) {
+	for (w2=1; w2-1 <= energy.getMaxInternalLoopSize2() && i2+w2<hybridE_seed.size2(); w2++) {
+		// direct cell access to right side end of loop (seed has to be to the right of it)
+		rightExt = &(hybridE_seed(i1+w1,i2+w2));
+		// check if right side of loop can pair
+		if (E_isINF(rightExt->E)) {
+			continue;
+		}
+		// check if interaction length is within boundary
+		if ( (rightExt->j1 +1 -i1) > energy.getAccessibility1().getMaxLength()
+			|| (rightExt->j2 +1 -i2) > energy.getAccessibility2().getMaxLength() )
+		{
+			continue;
+		}
+		// compute energy for this loop sizes
+		curE = energy.getE_interLeft(i1,i1+w1,i2,i2+w2) + rightExt->E;
+		// check if this combination yields better energy
+		curEtotal = energy.getE(i1,rightExt->j1,i2,rightExt->j2,curE);
+		if ( curEtotal < curCellEtotal )
+		{
+			// update current best for this left boundary
+			// copy right boundary
+			*curCell = *rightExt;
+			// set new energy
+			curCell->E = curE;
+			// store overall energy
+			curCellEtotal = curEtotal;
+		}
+	} // w2
+	} // w1
+
+	///////////////////////////////////////////////////////////////////
+	// check if seed is starting here
+	///////////////////////////////////////////////////////////////////
+
+	// check if seed is possible for this left boundary
+	if ( E_isNotINF( seedHandler.getSeedE(i1,i2) ) ) {
+		// get right extension
+		w1 = seedHandler.getSeedLength1(i1,i2)-1; assert(i1+w1 < hybridE.size1());
+		w2 = seedHandler.getSeedLength2(i1,i2)-1; assert(i2+w2 < hybridE.size2());
+		rightExt = &(hybridE(i1+w1,i2+w2));
+		// get energy of seed interaction with best right extension
+		curE = seedHandler.getSeedE(i1,i2) + rightExt->E;
+		// check if this combination yields better energy
+		curEtotal = energy.getE(i1,rightExt->j1,i2,rightExt->j2,curE);
+		if ( curEtotal < curCellEtotal )
+		{
+			// update current best for this left boundary
+			// copy right boundary
+			*curCell = *rightExt;
+			// set new energy
+			curCell->E = curE;
+			// store total energy
+			curCellEtotal = curEtotal;
+		}
+	}
+
+	return curCellEtotal;
 }
 
 
@@ -331,7 +370,8 @@ traceBack( Interaction & interaction )
 		assert( !traceNotFound );
 	}
 #if INTARNA_IN_DEBUG_MODE
-	if ( (j2-i2) > 1 ) {
+	// the remaining loop (i1,i2)-(j1,j2) can still contain a bulge in seq2
+	if ( (j2-i2) > energy.getMaxInternalLoopSize2()+1 ) {
 		throw std::runtime_error("PredictorMfe2dHeuristicSeed::traceBack() : trace leaves ji<j2 : "+toString(i2)+"<"+toString(j2));
 	}
 #endif
@@ -356,74 +396,16 @@ void
 PredictorMfe2dHeuristicSeed::
 getNextBest( Interaction & curBest )
 {
+	getNextBestCandidate( curBest, hybridE_seed.size1(), hybridE_seed.size2() );
+}
 
-	const E_type curBestE = curBest.energy;
-
-	// TODO replace index iteration with something based on ranges from reportedInteractions
-
-	// identify cell with next best non-overlapping interaction site
-	// iterate (decreasingly) over all left interaction starts
-	size_t i1,i2;
-	BestInteraction * curBestCell = NULL;
-	E_type curBestCellE = E_INF;
-	Interaction::BasePair curBestCellStart;
-	BestInteraction * curCell = NULL;
-	E_type curCellE = E_INF;
-	IndexRange r1,r2;
-	for (i1=hybridE_seed.size1(); i1-- > 0;) {
-		// ensure interaction site start is not covered
-		if (reportedInteractions.first.covers(i1)) {
-			continue;
-		}
-		for (i2=hybridE_seed.size2(); i2-- > 0;) {
-			// ensure interaction site start is not covered
-			if (reportedInteractions.second.covers(i2)) {
-				continue;
-			}
-			// direct cell access
-			curCell = &(hybridE_seed(i1,i2));
-			// check if left side can pair
-			if (E_isINF(curCell->E))
-			{
-				continue;
-			}
-			// get overall energy of the interaction
-			curCellE = energy.getE(i1,curCell->j1,i2,curCell->j2,curCell->E);
-			// or energy is too low to be considered
-			// or energy is higher than current best found so far
-			if (curCellE < curBestE || curCellE >= curBestCellE )
-			{
-				continue;
-			}
-			// ensure site is not overlapping
-			r1.from = i1;
-			r1.to = curCell->j1;
-			if ( reportedInteractions.first.overlaps( r1 )) {
-				continue;
-			}
-			r2.from = i2;
-			r2.to = curCell->j2;
-			if ( reportedInteractions.second.overlaps( r2 )) {
-				continue;
-			}
-			//// FOUND THE NEXT BETTER SOLUTION
-			// overwrite current best found so far
-			curBestCell = curCell;
-			curBestCellE = curCellE;
-			curBestCellStart.first = i1;
-			curBestCellStart.second = i2;
-
-		} // i2
-	} // i1
-
-	// overwrite curBest
-	curBest.basePairs.resize(2);
-	curBest.energy = curBestCellE;
-	if (E_isNotINF(curBestCellE)) {
-		curBest.basePairs[0] = energy.getBasePair( curBestCellStart.first, curBestCellStart.second );
-		curBest.basePairs[1] = energy.getBasePair( curBestCell->j1, curBestCell->j2 );
-	}
+////////////////////////////////////////////////////////////////////////////
 
+bool
+PredictorMfe2dHeuristicSeed::
+updateNextBestCandidate( NextBestCandidate & c, const E_type minE ) const
+{
+	return PredictorMfe2dHeuristic::updateNextBestCandidate( c, minE, hybridE_seed );
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -88,6 +88,26 @@ protected:
 
 protected:
 
+	/**
+	 * Computes all entries of the hybridE_seed matrix (requires a filled
+	 * hybridE matrix) and updates the optima accordingly
+	 */
+	void
+	fillHybridE_seed();
+
+	/**
+	 * Computes the entry hybridE_seed(i1,i2) from the entries of all larger
+	 * left boundaries, i.e. all entries of a row i1 are independent of each
+	 * other and depend only on rows > i1.
+	 *
+	 * @param i1 the left interaction boundary in seq 1
+	 * @param i2 the left interaction boundary in seq 2
+	 * @return the total energy of the best seed-containing interaction with
+	 *         left boundary (i1,i2) or E_INF if there is none
+	 */
+	E_type
+	fillHybridE_seed_cell( const size_t i1, const size_t i2 );
+
 	/**
 	 * Fills a given interaction (boundaries given) with the according
 	 * hybridizing base pairs.
@@ -113,6 +133,18 @@ protected:
 	void
 	getNextBest( Interaction & curBest );
 
+	/**
+	 * Sets the given candidate to the best interaction with left end
+	 * (c.i1,c.i2) within hybridE_seed (see PredictorMfe::updateNextBestCandidate()).
+	 *
+	 * @param c IN/OUT the candidate to update (left end has to be set)
+	 * @param minE the minimal energy of the candidate
+	 * @return true if a candidate was found; false otherwise
+	 */
+	virtual
+	bool
+	updateNextBestCandidate( NextBestCandidate & c, const E_type minE ) const;
+
 
 };
 
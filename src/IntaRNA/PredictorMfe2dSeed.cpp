@@ -129,13 +129,36 @@ fillHybridE_seed( const size_t j1, const size_t j2, const size_t i1min, const si
 		return;
 	}
 
-	// global vars to avoid reallocation
-	size_t i1,i2,k1,k2,j1c,j2c;
-
 	// get i1/i2 index boundaries for computation
 	const IndexRange i1range( std::max(hybridErange.r1.from,i1min), j1+1-seedHandler.getConstraint().getBasePairs() );
 	const IndexRange i2range( std::max(hybridErange.r2.from,i2min), j2+1-seedHandler.getConstraint().getBasePairs() );
 
+	// run DP kernel specialized for the energy type (if known)
+	if (energyVrna != NULL) {
+		fillHybridE_seed_kernel( InteractionEnergyIdxOffsetTyped<InteractionEnergyVrna>(
+								*energyVrna, energy.getOffset1(), energy.getOffset2() )
+							, j1, j2, i1range, i2range );
+	} else if (energyBasePair != NULL) {
+		fillHybridE_seed_kernel( InteractionEnergyIdxOffsetTyped<InteractionEnergyBasePair>(
+								*energyBasePair, energy.getOffset1(), energy.getOffset2() )
+							, j1, j2, i1range, i2range );
+	} else {
+		fillHybridE_seed_kernel( energy, j1, j2, i1range, i2range );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyAccess >
+void
+PredictorMfe2dSeed::
+fillHybridE_seed_kernel( const EnergyAccess & energy
+			, const size_t j1, const size_t j2
+			, const IndexRange & i1range, const IndexRange & i2range )
+{
+	// global vars to avoid reallocation
+	size_t i1,i2,k1,k2;
+
 	//////////  COMPUTE HYBRIDIZATION ENERGIES (WITH SEED)  ////////////
 
 	// current minimal value
@@ -134,6 +134,22 @@ protected:
 	void
 	fillHybridE_seed( const size_t j1, const size_t j2, const size_t i1min=0, const size_t i2min=0  );
 
+	/**
+	 * DP kernel of fillHybridE_seed() that is specialized for the given
+	 * energy access type to enable inlining.
+	 *
+	 * @param energy the energy access object (with index offset)
+	 * @param j1 end of the interaction within seq 1
+	 * @param j2 end of the interaction within seq 2
+	 * @param i1range the range of i1 values to be computed
+	 * @param i2range the range of i2 values to be computed
+	 */
+	template < class EnergyAccess >
+	void
+	fillHybridE_seed_kernel( const EnergyAccess & energy
+				, const size_t j1, const size_t j2
+				, const IndexRange & i1range, const IndexRange & i2range );
+
 	/**
 	 * Fills a given interaction (boundaries given) with the according
 	 * hybridizing base pairs using hybridE_seed.
@@ -14,6 +14,7 @@ PredictorMfe4d( const InteractionEnergy & energy
 				, PredictionTracker * predTracker )
  : PredictorMfe(energy,output,predTracker)
 	, hybridE( 0,0 )
+	, hybridEArena()
 {
 }
 
@@ -72,6 +73,9 @@ predict( const IndexRange & r1
 
 	size_t maxWidthFori1i2 = 0;
 
+	// current maximal energy of a reported interaction (read once)
+	const E_type maxE = outConstraint.getMaxE();
+
 	bool i1blocked, i1or2blocked, skipw1w2;
 	// initialize 3rd and 4th dimension of the matrix
 	for (size_t i1=0; i1<hybridE.size1(); i1++) {
@@ -96,7 +100,7 @@ predict( const IndexRange & r1
 				&& energy.areComplementary( i1, i2 ))
 			{
 				// create new 2d matrix for different interaction site widths
-				hybridE(i1,i2) = new E2dMatrix(
+				hybridE(i1,i2) = hybridEArena.allocate(
 					/*w1 = */ std::min(energy.getAccessibility1().getMaxLength(), std::min( hybridE.size1()-i1, maxWidthFori1i2) ),
 					/*w2 = */ std::min(energy.getAccessibility2().getMaxLength(), std::min( hybridE.size2()-i2, maxWidthFori1i2) ));
 
@@ -119,20 +123,20 @@ predict( const IndexRange & r1
 						// check all larger windows w1 + w2p (that might need this window for computation)
 						for (size_t w2p=(*hybridE(i1,i2)).size2()-1; largerWindowsINF && w2p>w2; w2p++) {
 							// check if larger window is E_INF
-							largerWindowsINF = (std::numeric_limits<E_type>::max() < (*hybridE(i1,i2))(w1+1,w2p));
+							largerWindowsINF = E_isINF((*hybridE(i1,i2))(w1+1,w2p));
 						}
 						// check all larger windows w2 + w1p (that might need this window for computation)
 						for (size_t w1p=(*hybridE(i1,i2)).size1()-1; largerWindowsINF && w1p>w1; w1p++) {
 							// check if larger window is E_INF
-							largerWindowsINF = (std::numeric_limits<E_type>::max() < (*hybridE(i1,i2))(w1p,w2+1));
+							largerWindowsINF = E_isINF((*hybridE(i1,i2))(w1p,w2+1));
 						}
 
 						// if it holds for all w'>=w: ED1(i1+w1')+ED2(i2+w2')-outConstraint.maxE > -1*(min(w1',w2')*EmaxStacking + Einit + 2*Edangle + 2*Eend)
 						// ie. the ED values exceed the max possible energy gain of an interaction
 						skipw1w2 = skipw1w2
 								|| ( largerWindowsINF &&
-										( -1.0*(std::min(w1,w2)*minStackingEnergy + minInitEnergy + 2.0*minDangleEnergy + 2.0*minEndEnergy)
-											< (energy.getED1(i1,i1+w1) + energy.getED2(i2,i2+w2) - outConstraint.maxE) )
+										( -1.0*((E_type)std::min(w1,w2)*minStackingEnergy + minInitEnergy + 2.0*minDangleEnergy + 2.0*minEndEnergy)
+											< (energy.getED1(i1,i1+w1) + energy.getED2(i2,i2+w2) - maxE) )
 									)
 									;
 					}
@@ -141,6 +145,9 @@ predict( const IndexRange & r1
 						// init with infinity to mark that this cell is not to be computed later on
 						(*hybridE(i1,i2))(w1,w2) = E_INF;
 						debug_count_cells_inf++;
+					} else {
+						// mark as to be computed (has to be < E_INF)
+						(*hybridE(i1,i2))(w1,w2) = E_MAX;
 					}
 
 				}
@@ -180,13 +187,8 @@ void
 PredictorMfe4d::
 clear()
 {
-	// delete 3rd and 4th dimension of the matrix
-	for (E4dMatrix::iterator1 iRows = hybridE.begin1(); iRows != hybridE.end1(); iRows++) {
-		for (E4dMatrix::iterator2 ijEntry = iRows.begin(); ijEntry != iRows.end(); ijEntry++) {
-			// delete 2d matrix for current ij
-			 INTARNA_CLEANUP(*ijEntry);
-		}
-	}
+	// release 3rd and 4th dimension of the matrix (memory kept for reuse)
+	hybridEArena.clear();
 	// clear matrix, free data
 	hybridE.clear();
 }
@@ -196,6 +198,25 @@ clear()
 void
 PredictorMfe4d::
 fillHybridE( )
+{
+	// run DP kernel specialized for the energy type (if known)
+	if (energyVrna != NULL) {
+		fillHybridE_kernel( InteractionEnergyIdxOffsetTyped<InteractionEnergyVrna>(
+								*energyVrna, energy.getOffset1(), energy.getOffset2() ) );
+	} else if (energyBasePair != NULL) {
+		fillHybridE_kernel( InteractionEnergyIdxOffsetTyped<InteractionEnergyBasePair>(
+								*energyBasePair, energy.getOffset1(), energy.getOffset2() ) );
+	} else {
+		fillHybridE_kernel( energy );
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+template < class EnergyAccess >
+void
+PredictorMfe4d::
+fillHybridE_kernel( const EnergyAccess & energy )
 {
 
 	// global vars to avoid reallocation
@@ -261,7 +282,9 @@ fillHybridE( )
 						for (k1=std::min(j1-1,i1+energy.getMaxInternalLoopSize1()+1); k1>i1; k1--) {
 						for (k2=std::min(j2-1,i2+energy.getMaxInternalLoopSize2()+1); k2>i2; k2--) {
 							// check if (k1,k2) are complementary
-							if (hybridE(k1,k2) != NULL && hybridE(k1,k2)->size1() > (j1-k1) && hybridE(k1,k2)->size2() > (j2-k2)) {
+							if (hybridE(k1,k2) != NULL && hybridE(k1,k2)->size1() > (j1-k1) && hybridE(k1,k2)->size2() > (j2-k2)
+									&& E_isNotINF( (*hybridE(k1,k2))(j1-k1,j2-k2) ) )
+							{
 								curMinE = std::min( curMinE,
 										(energy.getE_interLeft(i1,k1,i2,k2)
 												+ (*hybridE(k1,k2))(j1-k1,j2-k2))
@@ -299,6 +322,14 @@ traceBack( Interaction & interaction )
 		return;
 	}
 
+	// check for single interaction (before sanity checks since not valid)
+	if (interaction.basePairs.at(0).first == interaction.basePairs.at(1).first) {
+		// delete second boundary (identical to first)
+		interaction.basePairs.resize(1);
+		// update done
+		return;
+	}
+
 #if INTARNA_IN_DEBUG_MODE
 	// sanity checks
 	if ( ! interaction.isValid() ) {
@@ -309,14 +340,6 @@ traceBack( Interaction & interaction )
 	}
 #endif
 
-	// check for single interaction
-	if (interaction.basePairs.at(0).first == interaction.basePairs.at(1).first) {
-		// delete second boundary (identical to first)
-		interaction.basePairs.resize(1);
-		// update done
-		return;
-	}
-
 	// ensure sorting
 	interaction.sort();
 	// get indices in hybridE for boundary base pairs
@@ -388,80 +411,71 @@ void
 PredictorMfe4d::
 getNextBest( Interaction & curBest )
 {
+	getNextBestCandidate( curBest, hybridE.size1(), hybridE.size2() );
+}
 
-	// store current best energy.second
-	const E_type curBestE = curBest.energy;
+////////////////////////////////////////////////////////////////////////////
 
-	// overwrite energy for update
-	curBest.energy = E_INF;
-	curBest.basePairs.resize(2);
+bool
+PredictorMfe4d::
+updateNextBestCandidate( NextBestCandidate & c, const E_type minE ) const
+{
+	return updateNextBestCandidate( c, minE, hybridE );
+}
 
-	// TODO replace index iteration with something based on ranges from reportedInteractions
+////////////////////////////////////////////////////////////////////////////
 
-	// identify cell with next best non-overlapping interaction site
-	// iterate (decreasingly) over all left interaction starts
-	E2dMatrix * curTable = NULL;
-	IndexRange r1,r2;
+bool
+PredictorMfe4d::
+updateNextBestCandidate( NextBestCandidate & c, const E_type minE, const E4dMatrix & matrix ) const
+{
+	// check if left boundary is complementary
+	const E2dMatrix * curTable = matrix(c.i1,c.i2);
+	if (curTable == NULL) {
+		// interaction not possible: nothing to do, since no storage reserved
+		return false;
+	}
+
+	c.E = E_INF;
+	IndexRange r1(c.i1,c.i1), r2(c.i2,c.i2);
 	E_type curE = E_INF;
-	for (r1.from=hybridE.size1(); r1.from-- > 0;) {
+	// iterate over all right interaction ends (table is indexed by width)
+	for (size_t w1=0; w1<curTable->size1(); w1++) {
+		r1.to = c.i1+w1;
 
-		// ensure interaction site start is not covered
-		if (reportedInteractions.first.covers(r1.from)) {
-			continue;
+		// check of overlapping
+		if (reportedInteractions.first.overlaps(r1)) {
+			// stop since all larger sites will overlap as well
+			break;
 		}
 
-		for (r2.from=hybridE.size2(); r2.from-- > 0;) {
+		for (size_t w2=0; w2<curTable->size2(); w2++) {
+			r2.to = c.i2+w2;
 
-			// ensure interaction site start is not covered
-			if (reportedInteractions.second.covers(r2.from)) {
-				continue;
-			}
-			// check if left boundary is complementary
-			if (hybridE(r1.from,r2.from) == NULL) {
-				// interaction not possible: nothing to do, since no storage reserved
-				continue;
+			// check of overlapping
+			if (reportedInteractions.second.overlaps(r2)) {
+				// stop since all larger sites will overlap as well
+				break;
 			}
 
-			curTable = hybridE(r1.from,r2.from);
-
-			for (r1.to=r1.from; r1.to<curTable->size1(); r1.to++) {
-
-				// check of overlapping
-				if (reportedInteractions.first.overlaps(r1)) {
-					// stop since all larger sites will overlap as well
-					break;;
-				}
-
-				for (r2.to=r2.from; r2.to<curTable->size2(); r2.to++) {
-
-					// check of overlapping
-					if (reportedInteractions.second.overlaps(r2)) {
-						// stop since all larger sites will overlap as well
-						break;;
-					}
+			// get overall energy of entry
+			curE = energy.getE( r1.from, r1.to, r2.from, r2.to, (*curTable)(w1,w2));
 
-					// get overall energy of entry
-					curE = energy.getE( r1.from, r1.to, r2.from, r2.to, (*curTable)(r1.to,r2.to));
-
-					// skip sites with energy too low
-					// or higher than current best found so far
-					if (  curE< curBestE || curE >= curBest.energy ) {
-						continue;
-					}
-
-					//// FOUND THE NEXT BETTER SOLUTION
-					// overwrite current best found so far
-					curBest.energy = curE;
-					curBest.basePairs[0] = energy.getBasePair( r1.from, r2.from );
-					curBest.basePairs[1] = energy.getBasePair( r1.to, r2.to );
-
-				} // j2
-			} // j1
+			// skip sites with energy too low
+			// or higher than current best found so far
+			if (  curE < minE || curE >= c.E ) {
+				continue;
+			}
 
+			// store best candidate
+			c.E = curE;
+			c.j1 = r1.to;
+			c.j2 = r2.to;
 
-		} // i2
-	} // i1
+		} // j2
+	} // j1
 
+	return E_isNotINF(c.E);
 }
 
 
@@ -4,6 +4,7 @@
 
 #include "IntaRNA/PredictorMfe.h"
 #include "IntaRNA/Interaction.h"
+#include "IntaRNA/MatrixArena.h"
 
 #include <boost/numeric/ublas/matrix.hpp>
 
@@ -20,8 +21,11 @@ class PredictorMfe4d: public PredictorMfe {
 
 protected:
 
+	//! memory arena providing the matrices for the different start positions
+	typedef MatrixArena<E_type> E2dMatrixArena;
+
 	//! matrix type to cover the energies for different interaction site widths
-	typedef boost::numeric::ublas::matrix<E_type> E2dMatrix;
+	typedef E2dMatrixArena::Matrix E2dMatrix;
 
 	//! full 4D DP-matrix for computation to hold all start position combinations
 	//! first index = start positions (i1,i2) of (seq1,seq2)
@@ -81,6 +85,10 @@ protected:
 	//! NOTE: hybridE(i1,i2)==NULL if not complementary(seq1[i1],seq2[i2])
 	E4dMatrix hybridE;
 
+	//! memory of all 2d matrices referenced by hybridE (and derived classes),
+	//! kept for reuse among predict() calls
+	E2dMatrixArena hybridEArena;
+
 protected:
 
 	/**
@@ -95,6 +103,16 @@ protected:
 	void
 	fillHybridE( );
 
+	/**
+	 * DP kernel of fillHybridE() that is specialized for the given energy
+	 * access type to enable inlining.
+	 *
+	 * @param energy the energy access object (with index offset)
+	 */
+	template < class EnergyAccess >
+	void
+	fillHybridE_kernel( const EnergyAccess & energy );
+
 	/**
 	 * Fills a given interaction (boundaries given) with the according
 	 * hybridizing base pairs.
@@ -118,6 +136,30 @@ protected:
 	void
 	getNextBest( Interaction & curBest );
 
+	/**
+	 * Sets the given candidate to the best interaction with left end
+	 * (c.i1,c.i2) within hybridE (see PredictorMfe::updateNextBestCandidate()).
+	 *
+	 * @param c IN/OUT the candidate to update (left end has to be set)
+	 * @param minE the minimal energy of the candidate
+	 * @return true if a candidate was found; false otherwise
+	 */
+	virtual
+	bool
+	updateNextBestCandidate( NextBestCandidate & c, const E_type minE ) const;
+
+	/**
+	 * Sets the given candidate to the best interaction with left end
+	 * (c.i1,c.i2) within the given matrix (see updateNextBestCandidate()).
+	 *
+	 * @param c IN/OUT the candidate to update (left end has to be set)
+	 * @param minE the minimal energy of the candidate
+	 * @param matrix the hybridization energy matrix to get the candidate from
+	 * @return true if a candidate was found; false otherwise
+	 */
+	bool
+	updateNextBestCandidate( NextBestCandidate & c, const E_type minE, const E4dMatrix & matrix ) const;
+
 };
 
 } // namespace
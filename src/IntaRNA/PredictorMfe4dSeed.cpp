@@ -91,6 +91,9 @@ predict( const IndexRange & r1
 
 	size_t maxWidthFori1i2 = 0;
 
+	// current maximal energy of a reported interaction (read once)
+	const E_type maxE = outConstraint.getMaxE();
+
 	bool i1blocked, i1or2blocked, skipw1w2;
 	// initialize 3rd and 4th dimension of the matrix
 	for (size_t i1=0; i1<hybridEsize1; i1++) {
@@ -115,10 +118,10 @@ predict( const IndexRange & r1
 				&& energy.areComplementary( i1, i2 ))
 			{
 				// create new 2d matrix for different interaction site widths
-				hybridE(i1,i2) = new E2dMatrix(
+				hybridE(i1,i2) = hybridEArena.allocate(
 					/*w1 = */ std::min(energy.getAccessibility1().getMaxLength(), std::min( hybridEsize1-i1, maxWidthFori1i2) ),
 					/*w2 = */ std::min(energy.getAccessibility2().getMaxLength(), std::min( hybridEsize2-i2, maxWidthFori1i2) ));
-				hybridE_seed(i1,i2) = new E2dMatrix( hybridE(i1,i2)->size1(), hybridE(i1,i2)->size2() );
+				hybridE_seed(i1,i2) = hybridEArena.allocate( hybridE(i1,i2)->size1(), hybridE(i1,i2)->size2() );
 
 				debug_count_cells_nonNull += debug_cellNumber;
 
@@ -139,20 +142,20 @@ predict( const IndexRange & r1
 						// check all larger windows w1 + w2p (that might need this window for computation)
 						for (size_t w2p=(*hybridE(i1,i2)).size2()-1; largerWindowsINF && w2p>w2; w2p++) {
 							// check if larger window is E_INF
-							largerWindowsINF = (std::numeric_limits<E_type>::max() < (*hybridE(i1,i2))(w1+1,w2p));
+							largerWindowsINF = E_isINF((*hybridE(i1,i2))(w1+1,w2p));
 						}
 						// check all larger windows w2 + w1p (that might need this window for computation)
 						for (size_t w1p=(*hybridE(i1,i2)).size1()-1; largerWindowsINF && w1p>w1; w1p++) {
 							// check if larger window is E_INF
-							largerWindowsINF = (std::numeric_limits<E_type>::max() < (*hybridE(i1,i2))(w1p,w2+1));
+							largerWindowsINF = E_isINF((*hybridE(i1,i2))(w1p,w2+1));
 						}
 
 						// if it holds for all w'>=w: ED1(i1+w1')+ED2(i2+w2')-outConstraint.maxE > -1*(min(w1',w2')*EmaxStacking + Einit + 2*Edangle + 2*Eend)
 						// ie. the ED values exceed the max possible energy gain of an interaction
 						skipw1w2 = skipw1w2
 								|| ( largerWindowsINF &&
-										( -1.0*(std::min(w1,w2)*minStackingEnergy + minInitEnergy + 2.0*minDangleEnergy + 2.0*minEndEnergy) <
-											(energy.getED1(i1,i1+w1) + energy.getED2(i2,i2+w2) - outConstraint.maxE))
+										( -1.0*((E_type)std::min(w1,w2)*minStackingEnergy + minInitEnergy + 2.0*minDangleEnergy + 2.0*minEndEnergy) <
+											(energy.getED1(i1,i1+w1) + energy.getED2(i2,i2+w2) - maxE))
 									)
 									;
 					}
@@ -162,6 +165,10 @@ predict( const IndexRange & r1
 						(*hybridE(i1,i2))(w1,w2) = E_INF;
 						(*hybridE_seed(i1,i2))(w1,w2) = E_INF;
 						debug_count_cells_inf++;
+					} else {
+						// mark as to be computed (has to be < E_INF)
+						(*hybridE(i1,i2))(w1,w2) = E_MAX;
+						(*hybridE_seed(i1,i2))(w1,w2) = E_MAX;
 					}
 
 				}
@@ -186,7 +193,7 @@ predict( const IndexRange & r1
 				<<"%)"; }
 
 	// init mfe without seed condition
-	OutputConstraint tmpOutConstraint(1, outConstraint.reportOverlap, outConstraint.maxE, outConstraint.deltaE);
+	OutputConstraint tmpOutConstraint(1, outConstraint.reportOverlap, outConstraint.maxE, outConstraint.deltaE, outConstraint.maxEglobal);
 	initOptima( tmpOutConstraint );
 
 	// fill matrix
@@ -194,7 +201,7 @@ predict( const IndexRange & r1
 
 	// check if any interaction possible
 	// if not no seed-containing interaction is possible neither
-	if (!(this->mfeInteractions.begin()->energy < tmpOutConstraint.maxE)) {
+	if (!(this->mfeInteractions.begin()->energy < tmpOutConstraint.getMaxE())) {
 		// stop computation since no favorable interaction found
 		reportOptima(tmpOutConstraint);
 		return;
@@ -216,17 +223,10 @@ void
 PredictorMfe4dSeed::
 clear()
 {
-	// delete 3rd and 4th dimension of the matrix
-	for (E4dMatrix::iterator1 iRows = hybridE_seed.begin1(); iRows != hybridE_seed.end1(); iRows++) {
-		for (E4dMatrix::iterator2 ijEntry = iRows.begin(); ijEntry != iRows.end(); ijEntry++) {
-			// delete 2d matrix for current ij
-			 INTARNA_CLEANUP(*ijEntry);
-		}
-	}
 	// clear matrix, free data
 	hybridE_seed.clear();
 
-	// clean up super class data structures
+	// clean up super class data structures (including 2d matrices of hybridE_seed)
 	PredictorMfe4d::clear();
 }
 
@@ -485,80 +485,16 @@ void
 PredictorMfe4dSeed::
 getNextBest( Interaction & curBest )
 {
+	getNextBestCandidate( curBest, hybridE_seed.size1(), hybridE_seed.size2() );
+}
 
-	// store current best energy.second
-	const E_type curBestE = curBest.energy;
-
-	// overwrite energy for update
-	curBest.energy = E_INF;
-	curBest.basePairs.resize(2);
-
-	// TODO replace index iteration with something based on ranges from reportedInteractions
-
-	// identify cell with next best non-overlapping interaction site
-	// iterate (decreasingly) over all left interaction starts
-	E2dMatrix * curTable = NULL;
-	IndexRange r1,r2;
-	E_type curE = E_INF;
-	for (r1.from=hybridE_seed.size1(); r1.from-- > 0;) {
-
-		// ensure interaction site start is not covered
-		if (reportedInteractions.first.covers(r1.from)) {
-			continue;
-		}
-
-		for (r2.from=hybridE_seed.size2(); r2.from-- > 0;) {
-
-			// ensure interaction site start is not covered
-			if (reportedInteractions.second.covers(r2.from)) {
-				continue;
-			}
-			// check if left boundary is complementary
-			if (hybridE_seed(r1.from,r2.from) == NULL) {
-				// interaction not possible: nothing to do, since no storage reserved
-				continue;
-			}
-
-			curTable = hybridE_seed(r1.from,r2.from);
-
-			for (r1.to=r1.from; r1.to<curTable->size1(); r1.to++) {
-
-				// check of overlapping
-				if (reportedInteractions.first.overlaps(r1)) {
-					// stop since all larger sites will overlap as well
-					break;;
-				}
-
-				for (r2.to=r2.from; r2.to<curTable->size2(); r2.to++) {
-
-					// check of overlapping
-					if (reportedInteractions.second.overlaps(r2)) {
-						// stop since all larger sites will overlap as well
-						break;;
-					}
-
-					// get overall energy of entry
-					curE = energy.getE( r1.from, r1.to, r2.from, r2.to, (*curTable)(r1.to,r2.to));
-
-					// skip sites with energy too low
-					// or higher than current best found so far
-					if (  curE< curBestE || curE >= curBest.energy ) {
-						continue;
-					}
-
-					//// FOUND THE NEXT BETTER SOLUTION
-					// overwrite current best found so far
-					curBest.energy = curE;
-					curBest.basePairs[0] = energy.getBasePair( r1.from, r2.from );
-					curBest.basePairs[1] = energy.getBasePair( r1.to, r2.to );
-
-				} // j2
-			} // j1
-
-
-		} // i2
-	} // i1
+////////////////////////////////////////////////////////////////////////////
 
+bool
+PredictorMfe4dSeed::
+updateNextBestCandidate( NextBestCandidate & c, const E_type minE ) const
+{
+	return PredictorMfe4d::updateNextBestCandidate( c, minE, hybridE_seed );
 }
 
 
@@ -124,6 +124,18 @@ protected:
 	void
 	getNextBest( Interaction & curBest );
 
+	/**
+	 * Sets the given candidate to the best interaction with left end
+	 * (c.i1,c.i2) within hybridE_seed (see PredictorMfe::updateNextBestCandidate()).
+	 *
+	 * @param c IN/OUT the candidate to update (left end has to be set)
+	 * @param minE the minimal energy of the candidate
+	 * @return true if a candidate was found; false otherwise
+	 */
+	virtual
+	bool
+	updateNextBestCandidate( NextBestCandidate & c, const E_type minE ) const;
+
 };
 
 } // namespace
@@ -212,6 +212,9 @@ SeedConstraint::SeedConstraint(
 	, ranges2(ranges2reversed)
 {
 	if (bp < 2) throw std::runtime_error("SeedConstraint() : base pair number ("+toString(bp)+") < 2");
+	// ranges are checked for each seed candidate
+	this->ranges1.enableDenseLookup();
+	this->ranges2.enableDenseLookup();
 }
 
 /////////////////////////////////////////////////////////////////////////////
@@ -338,7 +341,7 @@ operator<<(std::ostream& out, const SeedConstraint& c)
 			<<", up="<<c.getMaxUnpairedOverall()
 			<<", up1="<<c.getMaxUnpaired1()
 			<<", up2="<<c.getMaxUnpaired2()
-			<<", E="<<c.getMaxE()
+			<<", E="<<E_2_Ekcal(c.getMaxE())
 			<<")";
 	return out;
 }
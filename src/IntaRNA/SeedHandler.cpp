@@ -17,24 +17,129 @@ fillSeed( const size_t i1min, const size_t i1max, const size_t i2min, const size
 	if ( i2max > energy.size2() ) throw std::runtime_error("SeedHandler::fillSeed: i2max("+toString(i2max)+") > energy.size2("+toString(energy.size2())+")");
 #endif
 
-	// TODO : if (umax==0) apply local alignment/exact match search based on sequence only
+	// run DP kernel specialized for the energy type (if known)
+	if (energyVrna != NULL) {
+		return fillSeed_kernel( InteractionEnergyIdxOffsetTyped<InteractionEnergyVrna>( *energyVrna )
+							, i1min, i1max, i2min, i2max );
+	} else if (energyBasePair != NULL) {
+		return fillSeed_kernel( InteractionEnergyIdxOffsetTyped<InteractionEnergyBasePair>( *energyBasePair )
+							, i1min, i1max, i2min, i2max );
+	} else {
+		return fillSeed_kernel( energy, i1min, i1max, i2min, i2max );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
 
-	// resize matrizes
-	seed.resize( i1max-i1min+1, i2max-i2min+1 );
-	seedE_rec.resize( SeedIndex({{ // setup ring-list data for seed computation
-					  (SeedRecMatrix::index)(seed.size1())
-					, (SeedRecMatrix::index)(seed.size2())
+void
+SeedHandler::
+resizeSeedE_rec( const size_t rows, const size_t cols )
+{
+	seedE_rec.resize( SeedIndex({{
+					  (SeedRecMatrix::index)(rows)
+					, (SeedRecMatrix::index)(cols)
 					, (SeedRecMatrix::index)(seedConstraint.getBasePairs()+1-2) // +1 for size and -2 to encode at least 2 bps or more
 					, (SeedRecMatrix::index)(seedConstraint.getMaxUnpaired1()+1) // +1 for size
 					, (SeedRecMatrix::index)(seedConstraint.getMaxUnpaired2()+1) // +1 for size
 				}}));
+	// seed masks cover all seq2 indices of the seed matrix
+	seedMaskBlocks = ComplementarityMask::getBlockNumber( seedSize2 );
+	seedMask.resize( rows * seedConstraint.getBasePairs() * seedMaskBlocks );
+	seedMaskTmp.resize( seedMaskBlocks );
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+/**
+ * Bitwise OR of the right-shifted source blocks into the target blocks, ie.
+ * bit i of the target is set if bit i+shift of the source is set
+ * @param src the blocks to shift
+ * @param dst the blocks to update
+ * @param blocks the number of blocks
+ * @param shift the number of bits to shift
+ */
+inline
+void
+orShiftedRight( const ComplementarityMask::Block * src
+		, ComplementarityMask::Block * dst
+		, const size_t blocks
+		, const size_t shift )
+{
+	const size_t blockShift = shift / ComplementarityMask::BLOCK_BITS;
+	const size_t bitShift = shift % ComplementarityMask::BLOCK_BITS;
+	for (size_t b=0; b+blockShift < blocks; b++) {
+		dst[b] |= src[b+blockShift] >> bitShift;
+		if (bitShift > 0 && b+blockShift+1 < blocks) {
+			dst[b] |= src[b+blockShift+1] << (ComplementarityMask::BLOCK_BITS-bitShift);
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+SeedHandler::
+fillSeedMask( const size_t i1, const size_t i1max )
+{
+	// single base pairs : complementarity of the row
+	energy.getComplementarityMask().getRow( i1+offset1, offset2, offset2+seedSize2-1, getSeedMask(i1,1) );
+	const ComplementarityMask::Block * bpMask = getSeedMask(i1,1);
+
+	// last row that can host the next base pair of a chain
+	const size_t k1max = std::min( i1max, i1+1+seedConstraint.getMaxUnpaired1() );
+
+	// shift-and : a chain of bp base pairs starts with a base pair followed
+	// by a chain of bp-1 base pairs with unpaired stretches in between
+	for (size_t bp=2; bp <= seedConstraint.getBasePairs(); bp++) {
+		// collect all chains of bp-1 base pairs starting in the next rows
+		std::fill( seedMaskTmp.begin(), seedMaskTmp.end(), 0 );
+		for (size_t k1=i1+1; k1<=k1max; k1++) {
+			const ComplementarityMask::Block * subMask = getSeedMask(k1,bp-1);
+			for (size_t b=0; b<seedMaskBlocks; b++) {
+				seedMaskTmp[b] |= subMask[b];
+			}
+		}
+		// shift for all possible unpaired stretches in seq2
+		ComplementarityMask::Block * mask = getSeedMask(i1,bp);
+		std::fill( mask, mask+seedMaskBlocks, 0 );
+		for (size_t u2=0; u2<=seedConstraint.getMaxUnpaired2(); u2++) {
+			orShiftedRight( &(seedMaskTmp[0]), mask, seedMaskBlocks, u2+1 );
+		}
+		// restrict to complementary left base pairs
+		for (size_t b=0; b<seedMaskBlocks; b++) {
+			mask[b] &= bpMask[b];
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+template < class EnergyAccess >
+size_t
+SeedHandler::
+fillSeed_kernel( const EnergyAccess & energy
+		, const size_t i1min, const size_t i1max, const size_t i2min, const size_t i2max)
+{
+
+	// TODO : if (umax==0) apply local alignment/exact match search based on sequence only
+
+	// reset sparse seed storage
+	seed.resize( i1max-i1min+1 );
+	for (SeedMatrix::iterator row = seed.begin(); row != seed.end(); row++) {
+		row->clear();
+	}
+	seedSize2 = i2max-i2min+1;
+	// setup ring-list data for seed computation : the recursion for i1 needs
+	// the rows up to i1+maxUnpaired1+1 only
+	seedE_recOffset2 = 0;
+	resizeSeedE_rec( std::min( seed.size(), seedConstraint.getMaxUnpaired1()+2 ), seedSize2 );
 
 	// store index offset due to restricted matrix size generation
 	offset1 = i1min;
 	offset2 = i2min;
 
 	// temporary variables
-	size_t i1, i2, bpIn, u1, u2, j1, j2, u1p, u2p, k1,k2, u1best, u2best;
+	size_t i1, i2, bpIn, u1, u2, j1, j2, u1best, u2best;
 	E_type curE, bestE;
 
 	size_t seedCountNotInf = 0, seedCount = 0;
@@ -42,16 +147,17 @@ fillSeed( const size_t i1min, const size_t i1max, const size_t i2min, const size
 	// fill for all start indices
 	// in decreasing index order
 	for (i1=i1max+1; i1-- > i1min;) {
+
+		// compute seed chains possible by sequence for this row
+		fillSeedMask( i1-offset1, i1max-offset1 );
+
 	for (i2=i2max+1; i2-- > i2min;) {
 
 		// count seed possibility
 		seedCount++;
 
-		// init according to no seed interaction
-		seed(i1-offset1,i2-offset2) = SeedMatrix::value_type( E_INF, 0 );
-
-		// skip non-complementary left seed boundaries
-		if (!energy.areComplementary(i1,i2)) {
+		// skip left seed boundaries without any (sub)seed possible by sequence
+		if (!isSeedMaskSet( i1-offset1, i2-offset2, 2 )) {
 			continue; // go to next seedE index
 		}
 		// skip left seed boundaries excluded from search
@@ -62,135 +168,197 @@ fillSeed( const size_t i1min, const size_t i1max, const size_t i2min, const size
 			continue; // go to next seedE index
 		}
 
-		// for feasible number of base pairs (bp+1) in increasing order
-		// bp=0 encodes 2 base pairs
-		for (bpIn=0; bpIn<seedE_rec.shape()[2] && (i1+bpIn+1-offset1)<seed.size1() && (i2+bpIn+1-offset2)<seed.size2(); bpIn++) {
-
-			// for feasible unpaired in seq1 in increasing order
-			for (u1=0; u1<seedE_rec.shape()[3] && (i1+bpIn+1+u1-offset1) < seed.size1(); u1++) {
-
-				// get right seed boundaries
-				// check if this index range is to be considered for seed search
-
-			// for feasible unpaired in seq2 in increasing order
-			for (u2=0; u2<seedE_rec.shape()[4] && (u1+u2)<=seedConstraint.getMaxUnpairedOverall() && (i2+bpIn+1+u2-offset2) < seed.size2(); u2++) {
-
-				// get right seed boundaries
-				j1 = i1+bpIn+1+u1;
-				j2 = i2+bpIn+1+u2;
-				// check if this index range is to be considered for seed search
-				bool validSeedSite =
-						(seedConstraint.getRanges1().empty() || seedConstraint.getRanges1().covers(i1,j1))
-						&& (seedConstraint.getRanges2().empty() || seedConstraint.getRanges2().covers(i2,j2));
-
-				// init current seed energy
-				curE = E_INF;
-
-				// check if right boundary is complementary
-				if (validSeedSite && energy.areComplementary(j1,j2)) {
-
-					// base case: only left and right base pair present
-					if (bpIn==0) {
-						// energy for stacking/bulge/interior depending on u1/u2
-						curE = energy.getE_interLeft(i1,j1,i2,j2);
-
-					} else {
-						// split seed recursively into all possible leading interior loops
-						// i1 .. i1+u1p+1 .. j1
-						// i2 .. i2+u2p+1 .. j2
-						for (u1p=1+std::min(u1,energy.getMaxInternalLoopSize1()); u1p-- > 0;) {
-						for (u2p=1+std::min(u2,energy.getMaxInternalLoopSize2()); u2p-- > 0;) {
-
-							k1 = i1+u1p+1;
-							k2 = i2+u2p+1;
-							// check if split pair is complementary
-							// and recursed entry is < E_INF
-							if (! (energy.areComplementary(k1,k2) && E_isNotINF( getSeedE( k1-offset1, k2-offset2, bpIn-1, u1-u1p, u2-u2p ) ) ) ) {
-								continue; // not complementary -> skip
-							}
-
-							// update mfe for split at k1,k2
-							curE = std::min( curE,
-									energy.getE_interLeft(i1,k1,i2,k2)
-									+ getSeedE( k1-offset1, k2-offset2, bpIn-1, u1-u1p, u2-u2p )
-									);
-						} // u2p
-						} // u1p
-					} // more than two base pairs
-
-				} // (j1,j2) complementary
-
-				// store seed energy
-				setSeedE( i1-offset1, i2-offset2, bpIn, u1, u2, curE );
+		// fill recursion data for all (sub)seeds starting at (i1,i2)
+		// and check if full base pair number reached
+		// (only for the base pair numbers possible by sequence)
+		bpIn = fillSeedE_rec( energy, i1, i2, i1max, i2max );
+		// skip seeds impossible by sequence or boundaries
+		if (bpIn == 0 || bpIn != seedE_rec.shape()[2]) {
+			continue;
+		}
+		bpIn--;
+
+		// find best unpaired combination in seed seed for i1,i2,bp
+		u1best = 0;
+		u2best = 0;
+		bestE = E_INF;
+
+		// for feasible unpaired in seq1 in increasing order
+		for (u1=0; u1<seedE_rec.shape()[3] && i1+bpIn+1+u1 <= i1max; u1++) {
+		// for feasible unpaired in seq2 in increasing order
+		for (u2=0; u2<seedE_rec.shape()[4] && (u1+u2)<=seedConstraint.getMaxUnpairedOverall() && i2+bpIn+1+u2 <= i2max; u2++) {
+
+			// get right seed boundaries
+			j1 = i1+bpIn+1+u1;
+			j2 = i2+bpIn+1+u2;
+
+			// skip if ED boundary exceeded
+			if (energy.getED1(i1,j1) > seedConstraint.getMaxED()
+					|| energy.getED2(i2,j2) > seedConstraint.getMaxED() )
+			{
+				continue;
+			}
 
-			} // u2
-			} // u1
+			// get overall interaction energy
+			curE = energy.getE( i1, j1, i2, j2, getSeedE( i1-offset1, i2-offset2, bpIn, u1, u2 ) ) + energy.getE_init();
 
-			// check if full base pair number reached
-			if (bpIn+1==seedE_rec.shape()[2]) {
+			// check if better than what is known so far
+			if ( curE < bestE ) {
+				bestE = curE;
+				u1best = u1;
+				u2best = u2;
+			}
+		} // u2
+		} // u1
+
+		// store best (mfe) seed for all u1/u2 if feasible
+		if (E_isNotINF( bestE ) && bestE <= seedConstraint.getMaxE()) {
+			// store seed's hybridization loop energies only
+			seed[i1-offset1].push_back( SeedData( i2-offset2
+					, getSeedE( i1-offset1, i2-offset2, bpIn, u1best, u2best )
+					, encodeSeedLength(bpIn+2+u1best,bpIn+2+u2best) ) );
+			// count true seed
+			seedCountNotInf++;
+		}
 
-				// find best unpaired combination in seed seed for i1,i2,bp
-				u1best = 0;
-				u2best = 0;
-				bestE = E_INF;
+	} // i2
+		// ensure increasing i2 order within row
+		std::reverse( seed[i1-offset1].begin(), seed[i1-offset1].end() );
+	} // i1
 
-				// for feasible unpaired in seq1 in increasing order
-				for (u1=0; u1<seedE_rec.shape()[3] && (i1+bpIn+1+u1-offset1) < seed.size1(); u1++) {
-				// for feasible unpaired in seq2 in increasing order
-				for (u2=0; u2<seedE_rec.shape()[4] && (u1+u2)<=seedConstraint.getMaxUnpairedOverall() && (i2+bpIn+1+u2-offset2) < seed.size2(); u2++) {
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(2) <<"valid seeds = "<<seedCountNotInf <<" ("<<(seedCountNotInf/seedCount)<<"% of start index combinations)"; }
 
-					// get right seed boundaries
-					j1 = i1+bpIn+1+u1;
-					j2 = i2+bpIn+1+u2;
+	return seedCountNotInf;
+}
 
-					// skip if ED boundary exceeded
-					if (energy.getED1(i1,j1) > seedConstraint.getMaxED()
-							|| energy.getED2(i2,j2) > seedConstraint.getMaxED() )
-					{
-						continue;
-					}
+//////////////////////////////////////////////////////////////////////////
 
-					// get overall interaction energy
-					curE = energy.getE( i1, j1, i2, j2, getSeedE( i1-offset1, i2-offset2, bpIn, u1, u2 ) ) + energy.getE_init();
+template < class EnergyAccess >
+size_t
+SeedHandler::
+fillSeedE_rec( const EnergyAccess & energy
+		, const size_t i1, const size_t i2, const size_t i1max, const size_t i2max )
+{
+	// temporary variables
+	size_t bpIn, u1, u2, j1, j2, u1p, u2p, k1, k2;
+	E_type curE;
+
+	// for feasible number of base pairs (bp+1) in increasing order
+	// bp=0 encodes 2 base pairs; stop if no further chain possible by sequence
+	for (bpIn=0; bpIn<seedE_rec.shape()[2] && i1+bpIn+1 <= i1max && i2+bpIn+1 <= i2max
+					&& isSeedMaskSet( i1-offset1, i2-offset2, bpIn+2 ); bpIn++)
+	{
+
+		// for feasible unpaired in seq1 in increasing order
+		for (u1=0; u1<seedE_rec.shape()[3] && i1+bpIn+1+u1 <= i1max; u1++) {
+
+		// for feasible unpaired in seq2 in increasing order
+		for (u2=0; u2<seedE_rec.shape()[4] && (u1+u2)<=seedConstraint.getMaxUnpairedOverall() && i2+bpIn+1+u2 <= i2max; u2++) {
+
+			// get right seed boundaries
+			j1 = i1+bpIn+1+u1;
+			j2 = i2+bpIn+1+u2;
+			// check if this index range is to be considered for seed search
+			bool validSeedSite =
+					(seedConstraint.getRanges1().empty() || seedConstraint.getRanges1().covers(i1,j1))
+					&& (seedConstraint.getRanges2().empty() || seedConstraint.getRanges2().covers(i2,j2));
+
+			// init current seed energy
+			curE = E_INF;
+
+			// check if right boundary is complementary
+			if (validSeedSite && energy.areComplementary(j1,j2)) {
+
+				// base case: only left and right base pair present
+				if (bpIn==0) {
+					// energy for stacking/bulge/interior depending on u1/u2
+					curE = energy.getE_interLeft(i1,j1,i2,j2);
+
+				} else {
+					// split seed recursively into all possible leading interior loops
+					// i1 .. i1+u1p+1 .. j1
+					// i2 .. i2+u2p+1 .. j2
+					for (u1p=1+std::min(u1,energy.getMaxInternalLoopSize1()); u1p-- > 0;) {
+					for (u2p=1+std::min(u2,energy.getMaxInternalLoopSize2()); u2p-- > 0;) {
+
+						k1 = i1+u1p+1;
+						k2 = i2+u2p+1;
+						// check if a subseed with (bpIn+1) base pairs is possible by
+						// sequence (ie. it was computed) and recursed entry is < E_INF
+						if (! (isSeedMaskSet( k1-offset1, k2-offset2, bpIn+1 ) && E_isNotINF( getSeedE( k1-offset1, k2-offset2, bpIn-1, u1-u1p, u2-u2p ) ) ) ) {
+							continue; // not complementary -> skip
+						}
 
-					// check if better than what is known so far
-					if ( curE < bestE ) {
-						bestE = curE;
-						u1best = u1;
-						u2best = u2;
-					}
-				} // u2
-				} // u1
-
-				// reduce bestE to hybridization energy only (init+loops)
-				if (E_isNotINF( bestE )) {
-					// overwrite all seeds with too high energy -> infeasible start interactions
-					if (bestE > seedConstraint.getMaxE()) {
-						bestE = E_INF;
-					} else {
-						// get seed's hybridization loop energies only
-						bestE = getSeedE( i1-offset1, i2-offset2, bpIn, u1best, u2best );
-						// count true seed
-						seedCountNotInf++;
-					}
-				}
+						// update mfe for split at k1,k2
+						curE = std::min( curE,
+								energy.getE_interLeft(i1,k1,i2,k2)
+								+ getSeedE( k1-offset1, k2-offset2, bpIn-1, u1-u1p, u2-u2p )
+								);
+					} // u2p
+					} // u1p
+				} // more than two base pairs
 
-				// store best (mfe) seed for all u1/u2
-				seed(i1-offset1,i2-offset2) = SeedMatrix::value_type( bestE
-						, E_isINF(bestE)?0:encodeSeedLength(bpIn+2+u1best,bpIn+2+u2best) );
+			} // (j1,j2) complementary
 
-			} // store best seed
+			// store seed energy
+			setSeedE( i1-offset1, i2-offset2, bpIn, u1, u2, curE );
 
-		} // bp
-	} // i2
-	} // i1
+		} // u2
+		} // u1
 
-#if INTARNA_MULITHREADING
-	#pragma omp critical(intarna_omp_logOutput)
+	} // bp
+
+	return bpIn;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+SeedHandler::
+traceBackSeed( Interaction & interaction
+		, const size_t i1
+		, const size_t i2
+		)
+{
+#if INTARNA_IN_DEBUG_MODE
+	if ( i1 < offset1 ) throw std::runtime_error("SeedHandler::traceBackSeed(i1="+toString(i1)+") is out of range (>"+toString(offset1)+")");
+	if ( i1-offset1 >= seed.size() ) throw std::runtime_error("SeedHandler::traceBackSeed(i1="+toString(i1)+") is out of range (<"+toString(seed.size()+offset1)+")");
+	if ( i2 < offset2 ) throw std::runtime_error("SeedHandler::traceBackSeed(i2="+toString(i2)+") is out of range (>"+toString(offset2)+")");
+	if ( i2-offset2 >= seedSize2 ) throw std::runtime_error("SeedHandler::traceBackSeed(i2="+toString(i2)+") is out of range (<"+toString(seedSize2+offset2)+")");
+	if ( E_isINF( getSeedE(i1,i2) ) ) throw std::runtime_error("SeedHandler::traceBackSeed(i1="+toString(i1)+",i2="+toString(i2)+") no seed known (E_INF)");
+	if ( i1+getSeedLength1(i1,i2)-1-offset1 >= seed.size() ) throw std::runtime_error("SeedHandler::traceBackSeed(i1="+toString(i1)+") seed length ("+toString(getSeedLength1(i1,i2))+") exceeds of range (<"+toString(seed.size()+offset1)+")");
+	if ( i2+getSeedLength2(i1,i2)-1-offset2 >= seedSize2 ) throw std::runtime_error("SeedHandler::traceBackSeed(i2="+toString(i2)+") seed length ("+toString(getSeedLength2(i1,i2))+") exceeds of range (<"+toString(seedSize2+offset2)+")");
 #endif
-	{ VLOG(2) <<"valid seeds = "<<seedCountNotInf <<" ("<<(seedCountNotInf/seedCount)<<"% of start index combinations)"; }
 
-	return seedCountNotInf;
+	// get number of base pairs within the seed
+	const size_t seedBps = getConstraint().getBasePairs();
+	// get seed boundaries
+	const size_t j1 = i1+getSeedLength1(i1,i2)-1;
+	const size_t j2 = i2+getSeedLength2(i1,i2)-1;
+
+	// recompute the recursion data for the seed region only since the
+	// ring-list of fillSeed() holds the last rows only
+	seedE_recOffset2 = i2-offset2;
+	resizeSeedE_rec( j1-i1+1, j2-i2+1 );
+	// mark all entries (incl. skipped left sides) as infeasible
+	std::fill( seedE_rec.data(), seedE_rec.data()+seedE_rec.num_elements(), E_INF );
+	for (size_t k1=j1+1; k1-- > i1;) {
+		fillSeedMask( k1-offset1, j1-offset1 );
+	for (size_t k2=j2+1; k2-- > i2;) {
+		if (isSeedMaskSet( k1-offset1, k2-offset2, 2 )) {
+			fillSeedE_rec( energy, k1, k2, j1, j2 );
+		}
+	}
+	}
+
+	// trace back the according seed
+	traceBackSeed( interaction, i1-offset1, i2-offset2
+			, seedBps-2
+			, j1-i1+1-seedBps
+			, j2-i2+1-seedBps );
 }
 
 //////////////////////////////////////////////////////////////////////////
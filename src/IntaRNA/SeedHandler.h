@@ -3,11 +3,16 @@
 #define INTARNA_SEEDHANDLER_H_
 
 #include "IntaRNA/InteractionEnergy.h"
+#include "IntaRNA/ComplementarityMask.h"
+#include "IntaRNA/InteractionEnergyIdxOffsetTyped.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
 #include "IntaRNA/SeedConstraint.h"
 
 #include <boost/multi_array.hpp>
 
-#include <boost/numeric/ublas/matrix.hpp>
+#include <vector>
+#include <algorithm>
 
 namespace IntaRNA {
 
@@ -18,25 +23,55 @@ class SeedHandler
 {
 public:
 
-	// TODO replace with 2D array on sparse matrices since most entries not used
-
 	//! 5D matrix type to hold the mfe energies for seed interactions
 	//! of the ranges i1..(i1+bp+u1-1) with i2..(i2+bp+u2-1), with
 	//! i1,i2 = the start index of the seed in seq1/2
 	//! bp = the number of base pairs within the seed
 	//! bpInbetween = the number of base pairs enclosed by left and right base pair, ie. == (bp-2)
 	//! u1/u2 = the number of unpaired positions within the seed,
-	//! using the index [i1][i2][bpInbetween][u1][u2] or a SeedIndex object
+	//! using the index [i1][i2][bpInbetween][u1][u2] or a SeedIndex object;
+	//! the first dimension is used as a ring buffer, see getSeedE()
 	typedef boost::multi_array<E_type,5> SeedRecMatrix;
 
 	//! defines the seed data {{ i1, i2, bpInbetween, u1, u2 }} to access elements of
 	//! the SeedRecMatrix
 	typedef boost::array<SeedRecMatrix::index, 5> SeedIndex;
 
-	//! matrix to store the seed information for each seed left side (i1,i2);
-	//! it holds both the energy (first) as well as the length of the seed using
-	//! the length combination using encodeSeedLength()
-	typedef boost::numeric::ublas::matrix< std::pair<E_type, size_t> > SeedMatrix;
+	/**
+	 * Information of the mfe seed for a seed left side (i1,i2)
+	 */
+	class SeedData {
+	public:
+		//! the seq2 index of the left-most seed base pair
+		size_t i2;
+		//! the hybridization energy of the seed
+		E_type E;
+		//! the lengths of the seed encoded by encodeSeedLength()
+		size_t length;
+
+		/**
+		 * construction
+		 * @param i2 the seq2 index of the left-most seed base pair
+		 * @param E the hybridization energy of the seed
+		 * @param length the encoded seed lengths
+		 */
+		SeedData( const size_t i2, const E_type E, const size_t length )
+			: i2(i2), E(E), length(length)
+		{}
+
+		/**
+		 * ordering by seq2 index
+		 * @param d the seed data to compare to
+		 * @return i2 < d.i2
+		 */
+		bool operator < ( const SeedData & d ) const {
+			return i2 < d.i2;
+		}
+	};
+
+	//! sparse matrix to store the seed information of valid seeds only:
+	//! for each seed left side i1 the data of all seeds (i1,i2) sorted by i2
+	typedef std::vector< std::vector< SeedData > > SeedMatrix;
 
 
 public:
@@ -137,24 +172,99 @@ protected:
 	//! the used energy function
 	const InteractionEnergy& energy;
 
+	//! the energy function if it is of type InteractionEnergyVrna (otherwise
+	//! NULL) to run the seed DP kernel specialized for this energy type
+	const InteractionEnergyVrna * const energyVrna;
+
+	//! the energy function if it is of type InteractionEnergyBasePair
+	//! (otherwise NULL) to run the seed DP kernel specialized for this type
+	const InteractionEnergyBasePair * const energyBasePair;
+
 	//! the seed constraint to be applied
 	const SeedConstraint & seedConstraint;
 
 	//! the recursion data for the computation of a seed interaction
 	//! i1..(i1+bpInbetween+u1-1) with i2..(i2+bpInbetween+u2-1)
-	//! using the indexing [i1][i2][bpInbetween][u1][u2]
+	//! using the indexing [i1 % rows][i2-seedE_recOffset2][bpInbetween][u1][u2],
+	//! ie. only the rows needed by the recursion are stored
 	SeedRecMatrix seedE_rec;
 
-	//! the seed mfe information for seeds starting at (i1,i2)
-	//! TODO replace with sparse data structure
+	//! the first (offset corrected) seq2 index covered by seedE_rec
+	size_t seedE_recOffset2;
+
+	//! bit masks of the seed chains possible by sequence only: for the rows
+	//! of seedE_rec and each number of base pairs b (1..bp), bit i2 is set
+	//! if a chain of b complementary base pairs with seed-conform unpaired
+	//! stretches might start at (i1,i2), using the indexing
+	//! [((i1 % rows)*bp + b-1)*seedMaskBlocks + i2/BLOCK_BITS]
+	std::vector< ComplementarityMask::Block > seedMask;
+
+	//! the number of blocks per row of seedMask
+	size_t seedMaskBlocks;
+
+	//! temporary blocks for the computation of seedMask
+	std::vector< ComplementarityMask::Block > seedMaskTmp;
+
+	//! the seed mfe information for valid seeds starting at (i1,i2)
 	SeedMatrix seed;
 
+	//! the number of seq2 indices covered by seed
+	size_t seedSize2;
+
 	//! offset for seq1 indices for the current (restricted) matrices
 	size_t offset1;
 
 	//! offset for seq2 indices for the current (restricted) matrices
 	size_t offset2;
 
+	/**
+	 * Provides the mfe seed information for the given seed left side
+	 * @param i1 the seed left end in seq 1 (index including offset)
+	 * @param i2 the seed left end in seq 2 (index including offset)
+	 * @return the seed data or NULL if no valid seed starts at (i1,i2)
+	 */
+	const SeedData *
+	getSeedData( const size_t i1, const size_t i2 ) const;
+
+	/**
+	 * Resizes the recursion data (seedE_rec) and the according seed masks.
+	 * @param rows the number of seq1 rows to be stored (ring buffer size)
+	 * @param cols the number of seq2 indices to be stored
+	 */
+	void
+	resizeSeedE_rec( const size_t rows, const size_t cols );
+
+	/**
+	 * Computes the seed masks of row i1 (see seedMask) using the
+	 * complementarity of i1 and the seed masks of the successive rows, which
+	 * have to be computed already.
+	 *
+	 * @param i1 the seed left end in seq 1 (index including offset)
+	 * @param i1max the last row in seq 1 to be considered (index including offset)
+	 */
+	void
+	fillSeedMask( const size_t i1, const size_t i1max );
+
+	/**
+	 * Access to the seed mask of a row
+	 * @param i1 the seed left end in seq 1 (index including offset)
+	 * @param bp the number of base pairs of the chain (1..bp)
+	 * @return the first block of the row's seed mask
+	 */
+	ComplementarityMask::Block *
+	getSeedMask( const size_t i1, const size_t bp );
+
+	/**
+	 * Checks whether or not a seed chain is possible by sequence only
+	 * @param i1 the seed left end in seq 1 (index including offset)
+	 * @param i2 the seed left end in seq 2 (index including offset)
+	 * @param bp the number of base pairs of the chain (1..bp)
+	 * @return true if a chain of bp base pairs might start at (i1,i2);
+	 *         false if no such chain is possible
+	 */
+	bool
+	isSeedMaskSet( const size_t i1, const size_t i2, const size_t bp ) const;
+
 	/**
 	 * Provides the seed energy during recursion.
 	 *
@@ -189,6 +299,40 @@ protected:
 	void
 	setSeedE( const size_t i1, const size_t i2, const size_t bpInbetween, const size_t u1, const size_t u2, const E_type E );
 
+	/**
+	 * DP kernel of fillSeed() that is specialized for the given energy
+	 * access type to enable inlining.
+	 *
+	 * @param energy the energy access object (without index offset)
+	 * @param i1min the first index of seq1 that might interact
+	 * @param i1max the last index of seq1 that might interact
+	 * @param i2min the first index of seq2 that might interact
+	 * @param i2max the last index of seq2 that might interact
+	 * @return the number of potential seed interactions
+	 */
+	template < class EnergyAccess >
+	size_t
+	fillSeed_kernel( const EnergyAccess & energy
+			, const size_t i1min, const size_t i1max, const size_t i2min, const size_t i2max );
+
+	/**
+	 * Fills the recursion data of all (sub)seeds with left-most base pair
+	 * (i1,i2) that end at or before (i1max,i2max). All entries for left-most
+	 * base pairs (k1,k2) with k1>i1 and k2>i2 needed by the recursion have
+	 * to be filled already.
+	 *
+	 * @param energy the energy access object (without index offset)
+	 * @param i1 the seed left end in seq 1
+	 * @param i2 the seed left end in seq 2
+	 * @param i1max the last index of seq1 that might interact
+	 * @param i2max the last index of seq2 that might interact
+	 * @return the number of base pair levels (bpInbetween+1) filled
+	 */
+	template < class EnergyAccess >
+	size_t
+	fillSeedE_rec( const EnergyAccess & energy
+			, const size_t i1, const size_t i2, const size_t i1max, const size_t i2max );
+
 	/**
 	 * Encodes the seed lengths into one number
 	 * @param l1 the length of the seed in seq1
@@ -248,9 +392,16 @@ SeedHandler::SeedHandler(
 		)
 	:
 		energy(energy)
+		, energyVrna( dynamic_cast<const InteractionEnergyVrna*>(&energy) )
+		, energyBasePair( dynamic_cast<const InteractionEnergyBasePair*>(&energy) )
 		, seedConstraint(seedConstraint)
 		, seedE_rec( SeedIndex({{ 0,0,0,0,0 }}))
+		, seedE_recOffset2(0)
+		, seedMask()
+		, seedMaskBlocks(0)
+		, seedMaskTmp()
 		, seed()
+		, seedSize2(0)
 		, offset1(0)
 		, offset2(0)
 {
@@ -286,31 +437,22 @@ getInteractionEnergy() const
 //////////////////////////////////////////////////////////////////////////
 
 inline
-void
+const SeedHandler::SeedData *
 SeedHandler::
-traceBackSeed( Interaction & interaction
-		, const size_t i1
-		, const size_t i2
-		)
+getSeedData( const size_t i1, const size_t i2 ) const
 {
 #if INTARNA_IN_DEBUG_MODE
-	if ( i1 < offset1 ) throw std::runtime_error("SeedHandler::traceBackSeed(i1="+toString(i1)+") is out of range (>"+toString(offset1)+")");
-	if ( i1-offset1 >= seed.size1() ) throw std::runtime_error("SeedHandler::traceBackSeed(i1="+toString(i1)+") is out of range (<"+toString(seed.size1()+offset1)+")");
-	if ( i2 < offset2 ) throw std::runtime_error("SeedHandler::traceBackSeed(i2="+toString(i2)+") is out of range (>"+toString(offset2)+")");
-	if ( i2-offset2 >= seed.size2() ) throw std::runtime_error("SeedHandler::traceBackSeed(i2="+toString(i2)+") is out of range (<"+toString(seed.size2()+offset2)+")");
-	if ( E_isINF( getSeedE(i1,i2) ) ) throw std::runtime_error("SeedHandler::traceBackSeed(i1="+toString(i1)+",i2="+toString(i2)+") no seed known (E_INF)");
-	if ( i1+getSeedLength1(i1,i2)-1-offset1 >= seed.size1() ) throw std::runtime_error("SeedHandler::traceBackSeed(i1="+toString(i1)+") seed length ("+toString(getSeedLength1(i1,i2))+") exceeds of range (<"+toString(seed.size1()+offset1)+")");
-	if ( i2+getSeedLength2(i1,i2)-1-offset2 >= seed.size2() ) throw std::runtime_error("SeedHandler::traceBackSeed(i2="+toString(i2)+") seed length ("+toString(getSeedLength2(i1,i2))+") exceeds of range (<"+toString(seed.size2()+offset2)+")");
+	if ( i1 < offset1 || i1-offset1 >= seed.size() ) throw std::runtime_error("SeedHandler::getSeedData(i1="+toString(i1)+") is out of range");
+	if ( i2 < offset2 || i2-offset2 >= seedSize2 ) throw std::runtime_error("SeedHandler::getSeedData(i2="+toString(i2)+") is out of range");
 #endif
-
-	// get number of base pairs within the seed
-	const size_t seedBps = getConstraint().getBasePairs();
-
-	// trace back the according seed
-	traceBackSeed( interaction, i1-offset1, i2-offset2
-			, seedBps-2
-			, getSeedLength1(i1,i2)-seedBps
-			, getSeedLength2(i1,i2)-seedBps );
+	const std::vector< SeedData > & row = seed[i1-offset1];
+	// quick check
+	if (row.empty()) {
+		return NULL;
+	}
+	// binary search for i2
+	std::vector< SeedData >::const_iterator d = std::lower_bound( row.begin(), row.end(), SeedData(i2-offset2, E_INF, 0) );
+	return (d == row.end() || d->i2 != i2-offset2) ? NULL : &(*d);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -320,7 +462,8 @@ E_type
 SeedHandler::
 getSeedE( const size_t i1, const size_t i2 ) const
 {
-	return seed(i1-offset1,i2-offset2).first;
+	const SeedData * d = getSeedData(i1,i2);
+	return d == NULL ? E_INF : d->E;
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -330,7 +473,8 @@ size_t
 SeedHandler::
 getSeedLength1( const size_t i1, const size_t i2 ) const
 {
-	return decodeSeedLength1(seed(i1-offset1,i2-offset2).second);
+	const SeedData * d = getSeedData(i1,i2);
+	return d == NULL ? 0 : decodeSeedLength1(d->length);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -340,7 +484,8 @@ size_t
 SeedHandler::
 getSeedLength2( const size_t i1, const size_t i2 ) const
 {
-	return decodeSeedLength2(seed(i1-offset1,i2-offset2).second);
+	const SeedData * d = getSeedData(i1,i2);
+	return d == NULL ? 0 : decodeSeedLength2(d->length);
 }
 
 //////////////////////////////////////////////////////////////////////////
@@ -350,10 +495,9 @@ E_type
 SeedHandler::
 getSeedE( const size_t i1, const size_t i2, const size_t bpInbetween, const size_t u1, const size_t u2 )
 {
-//	return seedE_rec[i1][i2][bpInbetween][u1][u2];
 	return seedE_rec( SeedIndex({{
-		  (SeedRecMatrix::index) i1
-		, (SeedRecMatrix::index) i2
+		  (SeedRecMatrix::index) (i1 % seedE_rec.shape()[0])
+		, (SeedRecMatrix::index) (i2 - seedE_recOffset2)
 		, (SeedRecMatrix::index) bpInbetween
 		, (SeedRecMatrix::index) u1
 		, (SeedRecMatrix::index) u2 }}) );
@@ -361,15 +505,38 @@ getSeedE( const size_t i1, const size_t i2, const size_t bpInbetween, const size
 
 //////////////////////////////////////////////////////////////////////////
 
+inline
+ComplementarityMask::Block *
+SeedHandler::
+getSeedMask( const size_t i1, const size_t bp )
+{
+	return &(seedMask[ ((i1 % seedE_rec.shape()[0])*seedConstraint.getBasePairs() + bp-1)*seedMaskBlocks ]);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+bool
+SeedHandler::
+isSeedMaskSet( const size_t i1, const size_t i2, const size_t bp ) const
+{
+	const size_t idx = ((i1 % seedE_rec.shape()[0])*seedConstraint.getBasePairs() + bp-1)*seedMaskBlocks + i2/ComplementarityMask::BLOCK_BITS;
+#if INTARNA_IN_DEBUG_MODE
+	if ( idx >= seedMask.size() ) throw std::runtime_error("SeedHandler::isSeedMaskSet("+toString(i1)+","+toString(i2)+","+toString(bp)+") is out of range");
+#endif
+	return (seedMask[idx] >> (i2 % ComplementarityMask::BLOCK_BITS)) & 1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
 inline
 void
 SeedHandler::
 setSeedE( const size_t i1, const size_t i2, const size_t bpInbetween, const size_t u1, const size_t u2, const E_type E )
 {
-//	seedE_rec[i1][i2][bpInbetween][u1][u2] = E;
 	seedE_rec( SeedIndex({{
-		  (SeedRecMatrix::index) i1
-		, (SeedRecMatrix::index) i2
+		  (SeedRecMatrix::index) (i1 % seedE_rec.shape()[0])
+		, (SeedRecMatrix::index) (i2 - seedE_recOffset2)
 		, (SeedRecMatrix::index) bpInbetween
 		, (SeedRecMatrix::index) u1
 		, (SeedRecMatrix::index) u2 }}) ) = E;
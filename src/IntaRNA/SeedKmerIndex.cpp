@@ -0,0 +1,213 @@
+#include "IntaRNA/SeedKmerIndex.h"
+
+#include <algorithm>
+#include <limits>
+#include <stdexcept>
+
+namespace IntaRNA {
+
+//////////////////////////////////////////////////////////////////////////
+
+const size_t SeedKmerIndex::MAX_K;
+
+//////////////////////////////////////////////////////////////////////////
+
+size_t
+SeedKmerIndex::
+getHelixLength( const size_t bp
+			, const size_t maxUnpairedOverall
+			, const size_t maxUnpaired1
+			, const size_t maxUnpaired2 )
+{
+	if (bp < 2) throw std::runtime_error("SeedKmerIndex::getHelixLength() : bp < 2");
+	// maximal number of interior loops (each has at least one unpaired base)
+	const size_t loops = std::min( bp-1, std::min( maxUnpairedOverall, maxUnpaired1+maxUnpaired2 ) );
+	// the remaining stackings are split into at most loops+1 helices
+	const size_t stackings = bp-1-loops;
+	// the longest helix has at least ceil(stackings/(loops+1)) stackings
+	return 1 + (stackings + loops) / (loops+1);
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+SeedKmerIndex::
+SeedKmerIndex( const std::vector< RnaSequence > & sequences, const size_t k )
+ :	k(k)
+	, seqStart(sequences.size()+1,0)
+	, bucketStart()
+	, positions()
+	, complementary(4)
+{
+	if (k < 1 || k > MAX_K) throw std::runtime_error("SeedKmerIndex : k="+toString(k)+" not in [1,"+toString(MAX_K)+"]");
+
+	// get complementary nucleotides according to the base pair model
+	const RnaSequence nucleotides("nucleotides","ACGU");
+	for (size_t q=0; q<4; q++) {
+		for (size_t t=0; t<4; t++) {
+			if (RnaSequence::areComplementary( nucleotides, nucleotides, q, t )) {
+				complementary[q].push_back(t);
+			}
+		}
+	}
+
+	// get sequence offsets within the concatenation
+	for (size_t s=0; s<sequences.size(); s++) {
+		seqStart[s+1] = seqStart[s] + sequences.at(s).size();
+	}
+	if (seqStart.back() > (size_t)std::numeric_limits<Position>::max()) {
+		throw std::runtime_error("SeedKmerIndex : overall sequence length "+toString(seqStart.back())+" exceeds index limit");
+	}
+
+	const size_t kmerNumber = ((size_t)1) << (2*k);
+	const size_t kmerMask = kmerNumber-1;
+	bucketStart.resize( kmerNumber+1, 0 );
+
+	// two passes : count k-mer occurrences, then store positions
+	for (size_t pass=0; pass<2; pass++) {
+		for (size_t s=0; s<sequences.size(); s++) {
+			const std::string & seq = sequences.at(s).asString();
+			size_t code = 0, validLength = 0;
+			for (size_t i=0; i<seq.size(); i++) {
+				const size_t nt = getNucleotideCode( seq.at(i) );
+				// restart k-mer behind ambiguous nucleotides
+				if (nt > 3) {
+					validLength = 0;
+					continue;
+				}
+				code = ((code << 2) | nt) & kmerMask;
+				if (++validLength >= k) {
+					if (pass == 0) {
+						bucketStart[code+1]++;
+					} else {
+						positions[ bucketStart[code]++ ] = (Position)(seqStart[s] + i+1-k);
+					}
+				}
+			}
+		}
+		if (pass == 0) {
+			// prefix sums
+			for (size_t c=0; c<kmerNumber; c++) {
+				bucketStart[c+1] += bucketStart[c];
+			}
+			positions.resize( bucketStart[kmerNumber] );
+		} else {
+			// restore bucket starts (shifted during filling)
+			for (size_t c=kmerNumber; c>0; c--) {
+				bucketStart[c] = bucketStart[c-1];
+			}
+			bucketStart[0] = 0;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+SeedKmerIndex::
+~SeedKmerIndex()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+SeedKmerIndex::
+collectHits( const std::vector< size_t > & queryKmer
+		, const size_t x
+		, const size_t targetCode
+		, std::vector< Position > & hits ) const
+{
+	// lookup of full k-mer
+	if (x == k) {
+		hits.insert( hits.end(), positions.begin()+bucketStart[targetCode], positions.begin()+bucketStart[targetCode+1] );
+		return;
+	}
+	// target position x pairs with query position k-1-x
+	const std::vector< size_t > & targetNts = complementary.at( queryKmer.at(k-1-x) );
+	for (size_t t=0; t<targetNts.size(); t++) {
+		collectHits( queryKmer, x+1, (targetCode << 2) | targetNts[t], hits );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+SeedKmerIndex::
+getHits( const RnaSequence & query
+		, const IndexRangeList & queryRanges
+		, std::vector< std::vector<size_t> > & hits ) const
+{
+	std::vector< Position > globalHits;
+
+	// check all query k-mers
+	const std::string & seq = query.asString();
+	std::vector< size_t > queryKmer(k);
+	for (size_t j=0; j+k <= seq.size(); j++) {
+		// check query range
+		if (!queryRanges.empty() && !queryRanges.covers(j,j+k-1)) {
+			continue;
+		}
+		bool isAmbiguous = false;
+		for (size_t x=0; !isAmbiguous && x<k; x++) {
+			queryKmer[x] = getNucleotideCode( seq.at(j+x) );
+			isAmbiguous = queryKmer[x] > 3;
+		}
+		if (!isAmbiguous) {
+			collectHits( queryKmer, 0, 0, globalHits );
+		}
+	}
+
+	// sort and remove duplicates
+	std::sort( globalHits.begin(), globalHits.end() );
+	globalHits.erase( std::unique( globalHits.begin(), globalHits.end() ), globalHits.end() );
+
+	// map to sequences
+	hits.assign( size(), std::vector<size_t>() );
+	size_t s = 0;
+	for (std::vector< Position >::const_iterator h = globalHits.begin(); h != globalHits.end(); h++) {
+		while ((size_t)*h >= seqStart[s+1]) {
+			s++;
+		}
+		hits[s].push_back( (size_t)*h - seqStart[s] );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+void
+SeedKmerIndex::
+getWindows( const RnaSequence & query
+		, const IndexRangeList & queryRanges
+		, const size_t flank
+		, std::vector< IndexRangeList > & windows ) const
+{
+	std::vector< std::vector<size_t> > hits;
+	getHits( query, queryRanges, hits );
+
+	windows.assign( size(), IndexRangeList() );
+	for (size_t s=0; s<hits.size(); s++) {
+		const size_t lastPos = seqStart[s+1]-seqStart[s]-1;
+		IndexRange window;
+		bool isOpen = false;
+		for (std::vector<size_t>::const_iterator h = hits[s].begin(); h != hits[s].end(); h++) {
+			const size_t from = (*h > flank) ? *h-flank : 0;
+			const size_t to = std::min( lastPos, *h+k-1+flank );
+			// extend current window if overlapping or adjacent
+			if (isOpen && from <= window.to+1) {
+				window.to = std::max( window.to, to );
+			} else {
+				if (isOpen) {
+					windows[s].push_back( window );
+				}
+				window = IndexRange( from, to );
+				isOpen = true;
+			}
+		}
+		if (isOpen) {
+			windows[s].push_back( window );
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
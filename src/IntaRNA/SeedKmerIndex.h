@@ -0,0 +1,227 @@
+
+#ifndef INTARNA_SEEDKMERINDEX_H_
+#define INTARNA_SEEDKMERINDEX_H_
+
+#include "IntaRNA/general.h"
+#include "IntaRNA/RnaSequence.h"
+#include "IntaRNA/IndexRangeList.h"
+
+#include <boost/cstdint.hpp>
+
+#include <vector>
+
+namespace IntaRNA {
+
+/**
+ * K-mer index of a set of (target) sequences to identify the regions that
+ * can host a seed interaction with a given (query) sequence.
+ *
+ * Any seed with bp base pairs and at most maxUnpaired unpaired bases contains
+ * a stacked helix of getHelixLength() consecutive base pairs. Thus, each seed
+ * site of a target covers a k-mer (k <= helix length) that is complementary
+ * (including GU pairs) to a k-mer of the query. The index stores for each
+ * k-mer all its occurrences in all targets (ignoring k-mers with ambiguous
+ * nucleotides) such that the seed sites of a query are found by a lookup of
+ * the complementary words of each query k-mer.
+ *
+ * The index is a bucket array over all 4^k k-mers pointing into one array of
+ * sequence positions, ie. it needs O(4^k + sum of target lengths) memory.
+ *
+ * @author Martin Mann
+ *
+ */
+class SeedKmerIndex
+{
+public:
+
+	//! maximal k-mer length supported by the index
+	static const size_t MAX_K = 10;
+
+	/**
+	 * Provides the number of consecutive base pairs (stacked helix) that is
+	 * present within any seed of the given constraints.
+	 *
+	 * @param bp the number of base pairs of a seed (>=2)
+	 * @param maxUnpairedOverall the maximal (summed) number of unpaired bases
+	 *        within both sequences
+	 * @param maxUnpaired1 the maximal number of unpaired bases within seq1
+	 * @param maxUnpaired2 the maximal number of unpaired bases within seq2
+	 * @return the minimal length of the longest stacked helix of any seed
+	 */
+	static
+	size_t
+	getHelixLength( const size_t bp
+				, const size_t maxUnpairedOverall
+				, const size_t maxUnpaired1
+				, const size_t maxUnpaired2 );
+
+public:
+
+	/**
+	 * Construction of the index of all k-mers of the given sequences
+	 * @param sequences the sequences to index
+	 * @param k the k-mer length to use (in [1,MAX_K])
+	 */
+	SeedKmerIndex( const std::vector< RnaSequence > & sequences, const size_t k );
+
+	/**
+	 * destruction
+	 */
+	virtual ~SeedKmerIndex();
+
+	/**
+	 * Access to the k-mer length of the index
+	 * @return the k-mer length
+	 */
+	size_t
+	getK() const;
+
+	/**
+	 * Number of indexed sequences
+	 * @return the number of sequences
+	 */
+	size_t
+	size() const;
+
+	/**
+	 * Number of k-mer occurrences stored within the index
+	 * @return the number of indexed positions
+	 */
+	size_t
+	getPositionNumber() const;
+
+	/**
+	 * Identifies all positions of the indexed sequences that start a k-mer
+	 * complementary to a k-mer of the query, ie. the target k-mer t[i..i+k-1]
+	 * forms a stacked helix with the query k-mer q[j..j+k-1] via the base
+	 * pairs (t[i+x],q[j+k-1-x]).
+	 *
+	 * @param query the query sequence
+	 * @param queryRanges the query regions the k-mers have to be located in
+	 *        (0-based; all positions if empty)
+	 * @param hits OUT : for each indexed sequence the sorted start positions
+	 *        of all complementary k-mers
+	 */
+	void
+	getHits( const RnaSequence & query
+			, const IndexRangeList & queryRanges
+			, std::vector< std::vector<size_t> > & hits ) const;
+
+	/**
+	 * Provides the windows of the indexed sequences around all hits
+	 * (see getHits()), ie. each complementary k-mer is extended by flank
+	 * positions upstream and downstream and overlapping windows are merged.
+	 *
+	 * @param query the query sequence
+	 * @param queryRanges the query regions the k-mers have to be located in
+	 *        (0-based; all positions if empty)
+	 * @param flank the number of positions to add on both sides of a hit
+	 * @param windows OUT : for each indexed sequence the sorted, non-overlapping
+	 *        windows around the hits (empty if no hit)
+	 */
+	void
+	getWindows( const RnaSequence & query
+			, const IndexRangeList & queryRanges
+			, const size_t flank
+			, std::vector< IndexRangeList > & windows ) const;
+
+protected:
+
+	//! the type to store a position within the concatenation of all sequences
+	typedef boost::uint32_t Position;
+
+	//! the k-mer length
+	const size_t k;
+
+	//! the start of each sequence within the concatenation of all sequences
+	//! (plus the overall length as last entry)
+	std::vector< size_t > seqStart;
+
+	//! for each k-mer code the first entry within positions
+	//! (plus the overall number of positions as last entry)
+	std::vector< Position > bucketStart;
+
+	//! the positions of all k-mers in k-mer code order
+	std::vector< Position > positions;
+
+	//! for each query nucleotide code the complementary target nucleotide
+	//! codes (2-bit encoding, see getNucleotideCode())
+	std::vector< std::vector< size_t > > complementary;
+
+	/**
+	 * Provides the 2-bit encoding of a nucleotide
+	 * @param nucleotide the nucleotide character
+	 * @return the code in [0,3] or 4 for ambiguous nucleotides
+	 */
+	static
+	size_t
+	getNucleotideCode( const char nucleotide );
+
+	/**
+	 * Recursively enumerates all target k-mers complementary to the given
+	 * query k-mer and collects the according positions.
+	 *
+	 * @param queryKmer the 2-bit codes of the query k-mer
+	 * @param x the number of target nucleotides already fixed
+	 * @param targetCode the code of the target nucleotides fixed so far
+	 * @param hits the global positions of all hits
+	 */
+	void
+	collectHits( const std::vector< size_t > & queryKmer
+			, const size_t x
+			, const size_t targetCode
+			, std::vector< Position > & hits ) const;
+
+};
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+SeedKmerIndex::
+getK() const
+{
+	return k;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+SeedKmerIndex::
+size() const
+{
+	return seqStart.size()-1;
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+SeedKmerIndex::
+getPositionNumber() const
+{
+	return positions.size();
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+SeedKmerIndex::
+getNucleotideCode( const char nucleotide )
+{
+	switch (nucleotide) {
+	case 'A' : return 0;
+	case 'C' : return 1;
+	case 'G' : return 2;
+	case 'U' : return 3;
+	default : return 4;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_SEEDKMERINDEX_H_ */
@@ -0,0 +1,226 @@
+
+#include "IntaRNA/VectorizedEnergyMin.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// check if x86 vector instructions can be compiled and dispatched at runtime
+#if defined(__GNUC__) && ( defined(__x86_64__) || defined(__i386__) )
+	#define INTARNA_VECTORIZED_X86 1
+	#include <immintrin.h>
+#else
+	#define INTARNA_VECTORIZED_X86 0
+#endif
+
+namespace IntaRNA {
+
+//////////////////////////////////////////////////////////////////////
+
+namespace {
+
+//////////////////////////////////////////////////////////////////////
+
+/**
+ * Portable implementation of VectorizedEnergyMin::getMinSum()
+ */
+E_type
+minSum_scalar( const E_type * e1, const E_type * e2, const size_t n, const E_type curMin )
+{
+	E_type minE = curMin;
+	for (size_t k=0; k<n; k++) {
+		minE = std::min( minE, e1[k] + e2[k] );
+	}
+	return minE;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+#if INTARNA_VECTORIZED_X86
+
+/**
+ * SSE4.1 implementation of VectorizedEnergyMin::getMinSum()
+ */
+__attribute__((target("sse4.1")))
+E_type
+minSum_sse41( const E_type * e1, const E_type * e2, const size_t n, const E_type curMin )
+{
+	size_t k = 0;
+	E_type minE = curMin;
+	if (n >= 4) {
+#if INTARNA_INTEGER_ENERGY
+		__m128i minV = _mm_set1_epi32( curMin );
+		for ( ; k+4 <= n; k+=4) {
+			minV = _mm_min_epi32( minV, _mm_add_epi32(
+						_mm_loadu_si128( reinterpret_cast<const __m128i*>(e1+k) )
+						, _mm_loadu_si128( reinterpret_cast<const __m128i*>(e2+k) ) ) );
+		}
+		// horizontal minimum
+		minV = _mm_min_epi32( minV, _mm_shuffle_epi32( minV, _MM_SHUFFLE(1,0,3,2) ) );
+		minV = _mm_min_epi32( minV, _mm_shuffle_epi32( minV, _MM_SHUFFLE(2,3,0,1) ) );
+		minE = _mm_cvtsi128_si32( minV );
+#else
+		__m128 minV = _mm_set1_ps( curMin );
+		for ( ; k+4 <= n; k+=4) {
+			minV = _mm_min_ps( minV, _mm_add_ps( _mm_loadu_ps(e1+k), _mm_loadu_ps(e2+k) ) );
+		}
+		// horizontal minimum
+		minV = _mm_min_ps( minV, _mm_shuffle_ps( minV, minV, _MM_SHUFFLE(1,0,3,2) ) );
+		minV = _mm_min_ps( minV, _mm_shuffle_ps( minV, minV, _MM_SHUFFLE(2,3,0,1) ) );
+		minE = _mm_cvtss_f32( minV );
+#endif
+	}
+	// handle remaining elements
+	return minSum_scalar( e1+k, e2+k, n-k, minE );
+}
+
+//////////////////////////////////////////////////////////////////////
+
+/**
+ * AVX2 implementation of VectorizedEnergyMin::getMinSum()
+ */
+__attribute__((target("avx2")))
+E_type
+minSum_avx2( const E_type * e1, const E_type * e2, const size_t n, const E_type curMin )
+{
+	size_t k = 0;
+	E_type minE = curMin;
+	if (n >= 8) {
+#if INTARNA_INTEGER_ENERGY
+		__m256i minV = _mm256_set1_epi32( curMin );
+		for ( ; k+8 <= n; k+=8) {
+			minV = _mm256_min_epi32( minV, _mm256_add_epi32(
+						_mm256_loadu_si256( reinterpret_cast<const __m256i*>(e1+k) )
+						, _mm256_loadu_si256( reinterpret_cast<const __m256i*>(e2+k) ) ) );
+		}
+		// horizontal minimum
+		__m128i minV4 = _mm_min_epi32( _mm256_castsi256_si128( minV ), _mm256_extracti128_si256( minV, 1 ) );
+		minV4 = _mm_min_epi32( minV4, _mm_shuffle_epi32( minV4, _MM_SHUFFLE(1,0,3,2) ) );
+		minV4 = _mm_min_epi32( minV4, _mm_shuffle_epi32( minV4, _MM_SHUFFLE(2,3,0,1) ) );
+		minE = _mm_cvtsi128_si32( minV4 );
+#else
+		__m256 minV = _mm256_set1_ps( curMin );
+		for ( ; k+8 <= n; k+=8) {
+			minV = _mm256_min_ps( minV, _mm256_add_ps( _mm256_loadu_ps(e1+k), _mm256_loadu_ps(e2+k) ) );
+		}
+		// horizontal minimum
+		__m128 minV4 = _mm_min_ps( _mm256_castps256_ps128( minV ), _mm256_extractf128_ps( minV, 1 ) );
+		minV4 = _mm_min_ps( minV4, _mm_shuffle_ps( minV4, minV4, _MM_SHUFFLE(1,0,3,2) ) );
+		minV4 = _mm_min_ps( minV4, _mm_shuffle_ps( minV4, minV4, _MM_SHUFFLE(2,3,0,1) ) );
+		minE = _mm_cvtss_f32( minV4 );
+#endif
+	}
+	// handle remaining elements (at most 7) within AVX code
+	for ( ; k<n; k++) {
+		minE = std::min( minE, e1[k] + e2[k] );
+	}
+	// avoid AVX-SSE transition penalties within the calling (non-AVX) code
+	_mm256_zeroupper();
+	return minE;
+}
+
+#endif // INTARNA_VECTORIZED_X86
+
+//////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////
+
+const VectorizedEnergyMin::MinSumFunction
+VectorizedEnergyMin::minSumSelected = VectorizedEnergyMin::selectMinSum();
+
+//////////////////////////////////////////////////////////////////////
+
+bool
+VectorizedEnergyMin::
+isSupported( const InstructionSet instructionSet )
+{
+	switch( instructionSet ) {
+	case SCALAR :
+		return true;
+#if INTARNA_VECTORIZED_X86
+	case SSE41 :
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("sse4.1");
+	case AVX2 :
+		__builtin_cpu_init();
+		return __builtin_cpu_supports("avx2");
+#endif
+	default :
+		return false;
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
+VectorizedEnergyMin::MinSumFunction
+VectorizedEnergyMin::
+selectMinSum()
+{
+#if INTARNA_VECTORIZED_X86
+	if (isSupported(AVX2)) {
+		return &minSum_avx2;
+	}
+	if (isSupported(SSE41)) {
+		return &minSum_sse41;
+	}
+#endif
+	return &minSum_scalar;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+VectorizedEnergyMin::InstructionSet
+VectorizedEnergyMin::
+getInstructionSet()
+{
+#if INTARNA_VECTORIZED_X86
+	if (minSumSelected == &minSum_avx2) {
+		return AVX2;
+	}
+	if (minSumSelected == &minSum_sse41) {
+		return SSE41;
+	}
+#endif
+	return SCALAR;
+}
+
+//////////////////////////////////////////////////////////////////////
+
+E_type
+VectorizedEnergyMin::
+getMinSum( const InstructionSet instructionSet
+		, const E_type * e1, const E_type * e2, const size_t n, const E_type curMin )
+{
+	if (!isSupported(instructionSet)) {
+		throw std::runtime_error("VectorizedEnergyMin::getMinSum() : instruction set "
+				+getName(instructionSet)+" not supported");
+	}
+	switch( instructionSet ) {
+#if INTARNA_VECTORIZED_X86
+	case AVX2 :
+		return minSum_avx2( e1, e2, n, curMin );
+	case SSE41 :
+		return minSum_sse41( e1, e2, n, curMin );
+#endif
+	default :
+		return minSum_scalar( e1, e2, n, curMin );
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
+std::string
+VectorizedEnergyMin::
+getName( const InstructionSet instructionSet )
+{
+	switch( instructionSet ) {
+	case AVX2 : return "AVX2";
+	case SSE41 : return "SSE4.1";
+	default : return "scalar";
+	}
+}
+
+//////////////////////////////////////////////////////////////////////
+
+} // namespace
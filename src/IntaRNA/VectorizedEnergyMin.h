@@ -0,0 +1,126 @@
+
+#ifndef INTARNA_VECTORIZEDENERGYMIN_H_
+#define INTARNA_VECTORIZEDENERGYMIN_H_
+
+#include "IntaRNA/general.h"
+
+#include <string>
+
+namespace IntaRNA {
+
+/**
+ * Vectorized computation of min_k( e1[k] + e2[k] ) over energy arrays as
+ * needed within the inner loops of the dynamic programming recursions.
+ *
+ * The best implementation available is selected once at runtime based on the
+ * instruction sets supported by the CPU (AVX2, SSE4.1 or a scalar fallback).
+ * All implementations are free of branches on the values, i.e. E_INF entries
+ * are handled by the arithmetic only: the result of a sum involving E_INF is
+ * still detected by E_isINF() (up to two E_INF summands).
+ *
+ * @author Martin Mann
+ *
+ */
+class VectorizedEnergyMin
+{
+public:
+
+	//! the available implementations
+	enum InstructionSet {
+		SCALAR = 0, //!< portable implementation
+		SSE41 = 1, //!< SSE4.1 based implementation (4 energies at once)
+		AVX2 = 2 //!< AVX2 based implementation (8 energies at once)
+	};
+
+	/**
+	 * Computes min( curMin, min_k( e1[k] + e2[k] ) ) for k in [0,n) using
+	 * the best implementation supported by the CPU.
+	 *
+	 * @param e1 the first energy array of length n
+	 * @param e2 the second energy array of length n
+	 * @param n the number of elements to consider
+	 * @param curMin the current minimum to be updated
+	 * @return the updated minimum
+	 */
+	static
+	E_type
+	getMinSum( const E_type * e1, const E_type * e2, const size_t n, const E_type curMin );
+
+	/**
+	 * Computes min( curMin, min_k( e1[k] + e2[k] ) ) for k in [0,n) using
+	 * the given implementation.
+	 *
+	 * NOTE: the given instruction set has to be supported by the CPU,
+	 * see isSupported().
+	 *
+	 * @param instructionSet the implementation to use
+	 * @param e1 the first energy array of length n
+	 * @param e2 the second energy array of length n
+	 * @param n the number of elements to consider
+	 * @param curMin the current minimum to be updated
+	 * @return the updated minimum
+	 */
+	static
+	E_type
+	getMinSum( const InstructionSet instructionSet
+			, const E_type * e1, const E_type * e2, const size_t n, const E_type curMin );
+
+	/**
+	 * Checks whether or not the given implementation is supported by the CPU
+	 * @param instructionSet the implementation of interest
+	 * @return true if the implementation can be used; false otherwise
+	 */
+	static
+	bool
+	isSupported( const InstructionSet instructionSet );
+
+	/**
+	 * Provides the implementation used by getMinSum()
+	 * @return the selected instruction set
+	 */
+	static
+	InstructionSet
+	getInstructionSet();
+
+	/**
+	 * Provides the name of an implementation
+	 * @param instructionSet the implementation of interest
+	 * @return the name of the instruction set
+	 */
+	static
+	std::string
+	getName( const InstructionSet instructionSet );
+
+protected:
+
+	//! function type of the implementations
+	typedef E_type (*MinSumFunction)( const E_type *, const E_type *, const size_t, const E_type );
+
+	//! the implementation selected for getMinSum()
+	static const MinSumFunction minSumSelected;
+
+	/**
+	 * Selects the best implementation supported by the CPU
+	 * @return the selected implementation
+	 */
+	static
+	MinSumFunction
+	selectMinSum();
+
+};
+
+//////////////////////////////////////////////////////////////////////
+
+inline
+E_type
+VectorizedEnergyMin::
+getMinSum( const E_type * e1, const E_type * e2, const size_t n, const E_type curMin )
+{
+	return (*minSumSelected)( e1, e2, n, curMin );
+}
+
+//////////////////////////////////////////////////////////////////////
+
+} // namespace
+
+#endif /* INTARNA_VECTORIZEDENERGYMIN_H_ */
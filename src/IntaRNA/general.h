@@ -79,40 +79,73 @@
 ////////////////  GLOBAL TYPEDEFS  //////////////////////
 
 #include <cmath>
+#include <boost/cstdint.hpp>
 
 namespace IntaRNA {
 
-	//! type for energy values (energy + accessibility [ED])
+#if INTARNA_INTEGER_ENERGY
+	//! type for energy values (energy + accessibility [ED]) in dcal/mol
+	typedef boost::int32_t E_type;
+#else
+	//! type for energy values (energy + accessibility [ED]) in kcal/mol
 	typedef float E_type;
+#endif
+
+	//! type for energy values in kcal/mol independent of the internal
+	//! energy representation E_type (used for input, output and RT)
+	typedef float Ekcal_type;
 
 	//! type for temperature values
-	typedef E_type T_type;
+	typedef Ekcal_type T_type;
+
+	//! type for partition functions, Boltzmann weights and probabilities
+	typedef float Z_type;
 
 } // namespace
 
 #ifdef E_precisionEpsilon
 	#error E_precisionEpsilon already defined
 #endif
+#if INTARNA_INTEGER_ENERGY
+	//! the delta difference range to consider two energies equivalent
+	#define E_precisionEpsilon 0
+#else
 	//! the delta difference range to consider two energies equivalent
-#define E_precisionEpsilon 1000.0*std::numeric_limits<E_type>::epsilon()
+	#define E_precisionEpsilon 1000.0*std::numeric_limits<E_type>::epsilon()
+#endif
 
 #ifdef E_equal
 	#error E_equal already defined
 #endif
+#if INTARNA_INTEGER_ENERGY
+	//! check if two energies are equal (exact for integers)
+	#define E_equal( e1, e2 ) ( (e1) == (e2) )
+#else
 	//! check if two energies are equal according to some epsilon
-#define E_equal( e1, e2 ) ( std::abs((e1)-(e2)) < E_precisionEpsilon)
+	#define E_equal( e1, e2 ) ( std::abs((e1)-(e2)) < E_precisionEpsilon)
+#endif
 
 #ifdef E_isNotINF
 	#error E_isNotINF already defined
 #endif
+#if INTARNA_INTEGER_ENERGY
+	//! check if a given energy is NOT set to E_INF (or a sum involving E_INF)
+	#define E_isNotINF( e ) ( (IntaRNA::E_INF/2) >= (e) )
+#else
 	//! check if a given energy is NOT set to E_INF
-#define E_isNotINF( e ) ( std::numeric_limits<E_type>::max() >= e )
+	#define E_isNotINF( e ) ( std::numeric_limits<E_type>::max() >= e )
+#endif
 
 #ifdef E_isINF
 	#error E_isINF already defined
 #endif
+#if INTARNA_INTEGER_ENERGY
+	//! check if a given energy is set to E_INF (or a sum involving E_INF)
+	#define E_isINF( e ) ( (IntaRNA::E_INF/2) < (e) )
+#else
 	//! check if a given energy is set to E_INF
-#define E_isINF( e ) (  std::numeric_limits<E_type>::max() < e )
+	#define E_isINF( e ) (  std::numeric_limits<E_type>::max() < e )
+#endif
 
 
 ////////////////  GLOBAL CONSTANTS  /////////////////////
@@ -121,7 +154,85 @@ namespace IntaRNA {
 
 namespace IntaRNA {
 
+#if INTARNA_INTEGER_ENERGY
+	//! integer infinity sentinel : the sum of up to 7 E_INF values plus
+	//! any finite energy does not overflow and is still detected by E_isINF
+	const E_type E_INF = std::numeric_limits<E_type>::max() / 8;
+#else
 	const E_type E_INF = std::numeric_limits<E_type>::infinity();
+#endif
+
+#if INTARNA_INTEGER_ENERGY
+	//! largest energy value that is not considered to be E_INF
+	const E_type E_MAX = E_INF / 2;
+#else
+	//! largest energy value that is not considered to be E_INF
+	const E_type E_MAX = std::numeric_limits<E_type>::max();
+#endif
+
+} // namespace
+
+
+////////////////  ENERGY UNIT CONVERSION  ///////////////
+
+namespace IntaRNA {
+
+/**
+ * Converts an energy given in kcal/mol into the internal energy
+ * representation E_type.
+ * @param e the energy in kcal/mol (infinite values are mapped to E_INF)
+ * @return the according E_type value
+ */
+inline
+E_type
+Ekcal_2_E( const double e )
+{
+#if INTARNA_INTEGER_ENERGY
+	// saturate at infinity
+	if ( !(std::abs(e)*100.0 < (double)(E_INF/2)) ) {
+		return e > 0 ? E_INF : -E_INF;
+	}
+	return (E_type)std::floor( e*100.0 + 0.5 );
+#else
+	return (E_type)e;
+#endif
+}
+
+/**
+ * Converts an energy given in dcal/mol (VRNA's integer representation) into
+ * the internal energy representation E_type.
+ * @param e the energy in dcal/mol
+ * @return the according E_type value
+ */
+inline
+E_type
+Edcal_2_E( const int e )
+{
+#if INTARNA_INTEGER_ENERGY
+	return (E_type)e;
+#else
+	return (E_type)e / (E_type)100.0;
+#endif
+}
+
+/**
+ * Converts an energy of the internal representation E_type into kcal/mol.
+ * @param e the energy to convert
+ * @return the according energy in kcal/mol (infinity for E_INF)
+ */
+inline
+Ekcal_type
+E_2_Ekcal( const E_type e )
+{
+#if INTARNA_INTEGER_ENERGY
+	if (E_isINF(e)) {
+		return std::numeric_limits<Ekcal_type>::infinity();
+	}
+	return (Ekcal_type)e / (Ekcal_type)100.0;
+#else
+	return e;
+#endif
+}
 
 } // namespace
 
@@ -6,6 +6,7 @@
 #include <cmath>
 #include <stdexcept>
 #include <fstream>
+#include <sstream>
 
 #if INTARNA_MULITHREADING
 	#include <omp.h>
@@ -21,10 +22,14 @@
 #include "IntaRNA/AccessibilityConstraint.h"
 
 #include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/AccessibilityFromCache.h"
 #include "IntaRNA/AccessibilityFromStream.h"
 #include "IntaRNA/AccessibilityVrna.h"
 #include "IntaRNA/AccessibilityBasePair.h"
 
+#include "IntaRNA/FastaFileMapped.h"
+#include "IntaRNA/SeedKmerIndex.h"
+
 #include "IntaRNA/InteractionEnergyBasePair.h"
 #include "IntaRNA/InteractionEnergyVrna.h"
 
@@ -42,10 +47,15 @@
 #include "IntaRNA/PredictionTrackerPairMinE.h"
 #include "IntaRNA/PredictionTrackerProfileMinE.h"
 
+#include "IntaRNA/OutputHandlerBinary.h"
 #include "IntaRNA/OutputHandlerCsv.h"
 #include "IntaRNA/OutputHandlerIntaRNA1.h"
 #include "IntaRNA/OutputHandlerText.h"
 
+extern "C" {
+	#include <ViennaRNA/vrna_config.h>
+}
+
 
 using namespace IntaRNA;
 
@@ -93,6 +103,15 @@ CommandLineParsing::CommandLineParsing()
 	tIntLoopMax( 0, 30, 16),
 	tRegionString(""),
 	tRegion(),
+	tStream( 0, 99999, 0),
+	tPrefilter( 0, 99999, 0),
+	tPrefilterRegion(),
+	tSubset(""),
+	targetStream(NULL),
+	targetFasta(NULL),
+	targetFastaSelection(),
+	targetFastaNext(0),
+	targetNumberOffset(0),
 
 	noSeedRequired(false),
 	seedBP(2,20,7),
@@ -111,19 +130,23 @@ CommandLineParsing::CommandLineParsing()
 	predMode( "HME", 'H'),
 #if INTARNA_MULITHREADING
 	threads( 1, omp_get_max_threads(), 1),
+	outOrderWindow( 0, 1000000, 0),
 #endif
+	accCache(""),
 
 	energy("BV",'V'),
 	energyFile(""),
+	energyFileContent(""),
 
 	out(),
 	outPrefix2streamName(),
 	outStream(&(std::cout)),
-	outMode( "NDC1O", 'N' ),
+	outMode( "NDC1OB", 'N' ),
 	outNumber( 0, 1000, 1),
 	outOverlap( "NTQB", 'Q' ),
 	outDeltaE( 0.0, 100.0, 100.0),
 	outMaxE( -999.0, +999.0, 0.0),
+	outTopK( 0, 1000000, 0),
 	outCsvCols(outCsvCols_default),
 
 	vrnaHandler()
@@ -202,7 +225,7 @@ CommandLineParsing::CommandLineParsing()
 		("qRegion"
 			, value<std::string>(&(qRegionString))
 				->notifier(boost::bind(&CommandLineParsing::validate_qRegion,this,_1))
-			, std::string("interaction site : query regions to be considered for interaction prediction. Either given as BED file (for multi-sequence FASTA input) or in the format 'from1-to1,from2-to2,..' assuming indexing starts with 1").c_str())
+			, std::string("interaction site : query regions to be considered for interaction prediction. Either given as BED file (for multi-sequence FASTA input; regions are assigned via the first word of the sequence IDs, overlapping regions are merged, and sequences without regions are skipped) or in the format 'from1-to1,from2-to2,..' assuming indexing starts with 1").c_str())
 		;
 
 	////  TARGET SEQUENCE OPTIONS  ////////////////////////////////////
@@ -267,7 +290,34 @@ CommandLineParsing::CommandLineParsing()
 		("tRegion"
 			, value<std::string>(&(tRegionString))
 				->notifier(boost::bind(&CommandLineParsing::validate_tRegion,this,_1))
-			, std::string("interaction site : target regions to be considered for interaction prediction. Either given as BED file (for multi-sequence FASTA input) or in the format 'from1-to1,from2-to2,..' assuming indexing starts with 1").c_str())
+			, std::string("interaction site : target regions to be considered for interaction prediction. Either given as BED file (for multi-sequence FASTA input; regions are assigned via the first word of the sequence IDs, overlapping regions are merged, and sequences without regions are skipped) or in the format 'from1-to1,from2-to2,..' assuming indexing starts with 1").c_str())
+		("tStream"
+			, value<int>(&(tStream.val))
+				->default_value(tStream.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_tStream,this,_1))
+			, std::string("if >0, the target sequences are read from the FASTA input in chunks of the given number of sequences;"
+					" each chunk is processed and discarded before the next one is read,"
+					" which restricts the memory consumption for very large target sets"
+					" (should be a multiple of the number of --threads)."
+					" Not supported in combination with --tAccConstr, --tRegion range encoding, --seedTRange, or --tAccFile=STDIN"
+					" (arg in range ["+toString(tStream.min)+","+toString(tStream.max)+"]; 0 reads all sequences at once)").c_str())
+		("tPrefilter"
+			, value<int>(&(tPrefilter.val))
+				->default_value(tPrefilter.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_tPrefilter,this,_1))
+			, std::string("if >0, a k-mer index of all target sequences is used to identify the sites"
+					" that can form a seed with the query (including GU pairs and seed unpaired bases);"
+					" predictions are restricted to windows around these sites extended by the given"
+					" number of positions upstream and downstream (should be at least the maximal"
+					" interaction length, see --tIntLenMax). Targets without seed site are skipped."
+					" Not supported in combination with --noSeed"
+					" (arg in range ["+toString(tPrefilter.min)+","+toString(tPrefilter.max)+"]; 0 disables the prefilter)").c_str())
+		("tSubset"
+			, value<std::string>(&(tSubset))
+			, std::string("the IDs of the target sequences to be read from the FASTA file (--target),"
+					" either given as comma-separated list or as file with one ID per line."
+					" An ID is the first word of the sequence's ID line."
+					" A samtools-style index (FASTA file name + '.fai') is used for direct access if present").c_str())
 		;
 
 	////  SEED OPTIONS  ////////////////////////////////////
@@ -304,13 +354,13 @@ CommandLineParsing::CommandLineParsing()
 			, std::string("maximal number of unpaired bases within the target's seed region"
 					" (arg in range ["+toString(seedTMaxUP.min)+","+toString(seedTMaxUP.max)+"]); if -1 the value of seedMaxUP is used.").c_str())
 		("seedMaxE"
-			, value<E_type>(&(seedMaxE.val))
+			, value<Ekcal_type>(&(seedMaxE.val))
 				->default_value(seedMaxE.def)
 				->notifier(boost::bind(&CommandLineParsing::validate_seedMaxE,this,_1))
 			, std::string("maximal energy a seed region may have"
 					" (arg in range ["+toString(seedMaxE.min)+","+toString(seedMaxE.max)+"]).").c_str())
 		("seedMinPu"
-			, value<E_type>(&(seedMinPu.val))
+			, value<Z_type>(&(seedMinPu.val))
 				->default_value(seedMinPu.def)
 				->notifier(boost::bind(&CommandLineParsing::validate_seedMinPu,this,_1))
 			, std::string("minimal unpaired probability (per sequence) a seed region may have"
@@ -398,7 +448,8 @@ CommandLineParsing::CommandLineParsing()
 					"\n 'D' detailed output (ASCII char + energy/position details),"
 					"\n 'C' CSV output (see --outCsvCols),"
 					"\n '1' backward compatible IntaRNA v1.* normal output,"
-					"\n 'O' backward compatible IntaRNA v1.* detailed output (former -o)"
+					"\n 'O' backward compatible IntaRNA v1.* detailed output (former -o),"
+					"\n 'B' binary compressed output (convert to CSV via IntaRNAbin2csv)"
 					).c_str())
 	    ("outNumber,n"
 			, value<int>(&(outNumber.val))
@@ -430,6 +481,15 @@ CommandLineParsing::CommandLineParsing()
 				->notifier(boost::bind(&CommandLineParsing::validate_outDeltaE,this,_1))
 			, std::string("suboptimal output : only interactions with E <= (minE+deltaE) are reported"
 					" (arg in range ["+toString(outDeltaE.min)+","+toString(outDeltaE.max)+"])").c_str())
+	    ("outTopK"
+			, value<int>(&(outTopK.val))
+				->default_value(outTopK.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_outTopK,this,_1))
+			, std::string("if >0, only the given number of interactions with lowest energy over all query-target combinations"
+					" are reported (sorted by energy), where each combination contributes at most --outNumber interactions."
+					" The energy of the currently K-th best interaction is used to prune the remaining predictions."
+					" If 0, the output is done for each combination individually."
+					" (arg in range ["+toString(outTopK.min)+","+toString(outTopK.max)+"])").c_str())
 		("outCsvCols"
 			, value<std::string>(&(outCsvCols))
 				->default_value(outCsvCols,"see text")
@@ -452,14 +512,35 @@ CommandLineParsing::CommandLineParsing()
 				->default_value(threads.def)
 				->notifier(boost::bind(&CommandLineParsing::validate_threads,this,_1))
 			, std::string("maximal number of threads to be used for parallel computation of query-target combinations."
+					" If only a single combination is to be computed, the threads are used within the prediction (modes H and M)."
 					" Note, the number of threads multiplies the required memory used for computation!"
 					" (arg in range ["+toString(threads.min)+","+toString(threads.max)+"])").c_str())
+	    ("outOrderWindow"
+			, value<int>(&(outOrderWindow.val))
+				->default_value(outOrderWindow.def)
+				->notifier(boost::bind(&CommandLineParsing::validate_outOrderWindow,this,_1))
+			, std::string("output : if >0, the output of all query-target combinations is written in input order"
+					" (identical to --threads=1) while they are computed in parallel."
+					" The value gives the maximal number of combinations computed ahead of the first combination not written yet"
+					" and thus bounds the memory needed to buffer their output."
+					" If 0, the output is written in the order of computation."
+					" (arg in range ["+toString(outOrderWindow.min)+","+toString(outOrderWindow.max)+"])").c_str())
 #endif
 	    ("version", "print version")
 	    ("help,h", "show the help page for basic parameters")
 	    ("fullhelp", "show the extended help page for all available parameters")
 	    ;
 	opts_cmdline_short.add(opts_general);
+	opts_general.add_options()
+		("accCache"
+			, value<std::string>(&(accCache))
+				->notifier(boost::bind(&CommandLineParsing::validate_accCache,this,_1))
+			, std::string("directory of a binary accessibility cache :"
+					" VRNA-based accessibilities (--qAcc/--tAcc = C) are loaded from"
+					" the cache if available or stored after computation otherwise."
+					" Cache entries are specific for the sequence, the Vienna RNA package"
+					" version, energy parameters, temperature, and the accessibility parameters.").c_str())
+		;
 
 	////  GENERAL OPTIONS  ////////////////////////////////////
 
@@ -478,6 +559,10 @@ CommandLineParsing::~CommandLineParsing() {
 	deleteOutputStream( outStream );
 	outStream = & std::cout;
 
+	// reset streamed target input
+	targetStream = NULL;
+	 INTARNA_CLEANUP(targetFasta);
+
 }
 
 ////////////////////////////////////////////////////////////////////////////
@@ -571,7 +656,28 @@ parse(int argc, char** argv)
 
 			// parse the sequences
 			parseSequences("query",queryArg,query);
-			parseSequences("target",targetArg,target);
+			if (tStream.val > 0 && !RnaSequence::isValidSequenceIUPAC(targetArg)) {
+				// streamed input : check for unsupported per-sequence settings
+				if (vm.count("tAccConstr") > 0 || boost::regex_match( tRegionString, IndexRangeList::regex, boost::match_perl ) || !seedTRange.empty() || boost::iequals(tAccFile,"STDIN")) {
+					throw error("--tStream not supported in combination with --tAccConstr, --tRegion range encoding, --seedTRange, or --tAccFile=STDIN");
+				}
+				// setup input and parse first chunk only
+				if (boost::iequals(targetArg,"STDIN")) {
+					if (!tSubset.empty()) {
+						throw error("--tSubset requires FASTA file input for --target");
+					}
+					targetStream = &(std::cin);
+				} else {
+					targetFasta = new FastaFileMapped( targetArg );
+					parseFastaSelection( "target", *targetFasta, tSubset, targetFastaSelection );
+				}
+				readTargetChunk();
+				if (validateSequenceNumber("target", target, 1, tStream.val)) {
+					validateSequenceAlphabet("target", target);
+				}
+			} else {
+				parseSequences("target",targetArg,target,tSubset);
+			}
 
 			// valide accessibility input from file (requires parsed sequences)
 			validate_qAccFile( qAccFile );
@@ -589,6 +695,9 @@ parse(int argc, char** argv)
 				if (seedMinPu.val != seedMinPu.def) LOG(INFO) <<"no seed constraint wanted, but seedMinPu provided (will be ignored)";
 				if (!seedQRange.empty()) LOG(INFO) <<"no seed constraint wanted, but seedQRange provided (will be ignored)";
 				if (!seedTRange.empty()) LOG(INFO) <<"no seed constraint wanted, but seedTRange provided (will be ignored)";
+				if (tPrefilter.val != tPrefilter.def) {
+					throw error("--tPrefilter not supported in combination with --noSeed");
+				}
 			} else {
 				// check query search ranges
 				if (!seedQRange.empty()) {
@@ -625,6 +734,7 @@ parse(int argc, char** argv)
 			// parse regions to be used for interaction prediction
 			parseRegion( "qRegion", qRegionString, query, qRegion );
 			parseRegion( "tRegion", tRegionString, target, tRegion );
+			prefilterTargetRegions();
 
 			// check qAccConstr - query sequence compatibility
 			if (vm.count("qAccConstr") > 0) {
@@ -736,12 +846,12 @@ parse(int argc, char** argv)
 
 #if INTARNA_MULITHREADING
 			// check if multi-threading
-			if (threads.val > 1 && getTargetSequences().size() > 1) {
+			if (threads.val > 1) {
 				// warn if >= 4D space prediction enabled
 				if (pred.val != 'S' || predMode.val == 'E') {
 					LOG(WARNING) <<"Multi-threading enabled in high-mem-prediction mode : ensure you have enough memory available!";
 				}
-				if (outMode.val == '1' || outMode.val == 'O') {
+				if ((getTargetSequences().size() > 1 || isTargetStreamed()) && (outMode.val == '1' || outMode.val == 'O')) {
 					throw std::runtime_error("Multi-threading not supported for IntaRNA v1 output");
 				}
 			}
@@ -762,6 +872,14 @@ parse(int argc, char** argv)
 	// setup new VRNA handler with the given arguments
 	if ( energy.val == 'V') {
 		vrnaHandler = VrnaHandler( temperature.val, (energyFile.size() > 0 ? & energyFile : NULL) );
+
+		// store energy parameters for the identification of cached accessibilities
+		if (!accCache.empty() && !energyFile.empty()) {
+			std::ifstream energyFileStream( energyFile.c_str() );
+			std::stringstream energyFileData;
+			energyFileData <<energyFileStream.rdbuf();
+			energyFileContent = energyFileData.str();
+		}
 	}
 
 
@@ -974,7 +1092,30 @@ parseRegion( const std::string & argName, const std::string & value, const RnaSe
 	}
 	// might be BED file input
 	if ( validateFile( value ) ) {
-		INTARNA_NOT_IMPLEMENTED("BED file input for index range list not implemented");
+		const RegionIndex & regionIndex = parseRegionBed( argName, value );
+		// ensure range list size sufficient
+		rangeList.resize( sequences.size() );
+		for (size_t s=0; s<sequences.size(); s++) {
+			IndexRangeList & r = rangeList[s];
+			// clear old data if any
+			r.clear();
+			// get regions via sequence name (first word of ID)
+			const std::string & id = sequences.at(s).getId();
+			auto regions = regionIndex.find( id.substr( 0, id.find_first_of(" \t") ) );
+			// no regions = no prediction for this sequence
+			if (regions == regionIndex.end()) {
+				continue;
+			}
+			// copy regions within the sequence
+			const size_t lastPos = sequences.at(s).size()-1;
+			BOOST_FOREACH( const IndexRange & region, regions->second ) {
+				if (region.from > lastPos) {
+					LOG(WARNING) <<argName <<" : region "<<(region.from+1)<<"-"<<(region.to+1)<<" exceeds the length of sequence '"<<id<<"' and is ignored";
+					break;
+				}
+				r.push_back( IndexRange( region.from, std::min( region.to, lastPos ) ) );
+			}
+		}
 		return;
 	}
 	assert(false) /*should never happen*/;
@@ -982,6 +1123,73 @@ parseRegion( const std::string & argName, const std::string & value, const RnaSe
 
 ////////////////////////////////////////////////////////////////////////////
 
+const CommandLineParsing::RegionIndex &
+CommandLineParsing::
+parseRegionBed( const std::string & argName, const std::string & fileName )
+{
+	// check if already parsed
+	auto parsed = regionFile2index.find( fileName );
+	if (parsed != regionFile2index.end()) {
+		return parsed->second;
+	}
+
+	// collect all regions per sequence name
+	std::unordered_map< std::string, std::vector< IndexRange > > name2regions;
+	std::ifstream bedFile( fileName );
+	std::string line;
+	size_t lineNumber = 0;
+	while( std::getline( bedFile, line ) ) {
+		lineNumber++;
+		// ignore empty, comment, and header lines
+		if ( line.empty() || line[0] == '#'
+			|| boost::starts_with( line, "track" ) || boost::starts_with( line, "browser" ) )
+		{
+			continue;
+		}
+		// parse tab-separated columns : NAME START END [...]
+		std::vector< std::string > cols;
+		boost::split( cols, line, boost::is_any_of("\t") );
+		try {
+			if (cols.size() < 3) {
+				throw std::runtime_error("less than 3 columns");
+			}
+			const size_t start = boost::lexical_cast<size_t>( boost::trim_copy(cols.at(1)) );
+			const size_t end = boost::lexical_cast<size_t>( boost::trim_copy(cols.at(2)) );
+			if (start >= end) {
+				throw std::runtime_error("empty region");
+			}
+			// BED coordinates are 0-based with exclusive end
+			name2regions[ boost::trim_copy(cols.at(0)) ].push_back( IndexRange( start, end-1 ) );
+		} catch (std::exception & ex) {
+			throw std::runtime_error(argName+" : BED file '"+fileName+"' line "+toString(lineNumber)+" : could not parse region ("+ex.what()+")");
+		}
+	}
+
+	// sort and merge overlapping/adjacent regions of each sequence
+	RegionIndex & regionIndex = regionFile2index[fileName];
+	for (auto n2r = name2regions.begin(); n2r != name2regions.end(); n2r++) {
+		std::vector< IndexRange > & regions = n2r->second;
+		std::sort( regions.begin(), regions.end() );
+		IndexRange merged = regions.at(0);
+		IndexRangeList & rangeList = regionIndex[n2r->first];
+		for (size_t i=1; i<regions.size(); i++) {
+			if (regions.at(i).from <= merged.to+1) {
+				// extend current region
+				merged.to = std::max( merged.to, regions.at(i).to );
+			} else {
+				// store and start new region
+				rangeList.push_back( merged );
+				merged = regions.at(i);
+			}
+		}
+		rangeList.push_back( merged );
+	}
+
+	return regionIndex;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 const CommandLineParsing::RnaSequenceVec &
 CommandLineParsing::
 getQuerySequences() const
@@ -1002,6 +1210,144 @@ getTargetSequences() const
 
 ////////////////////////////////////////////////////////////////////////////
 
+bool
+CommandLineParsing::
+parseNextTargetChunk()
+{
+	checkIfParsed();
+	// replace current chunk if there is input left
+	if (!readTargetChunk()) {
+		return false;
+	}
+	if (validateSequenceNumber("target", target, 1, tStream.val)
+		&& validateSequenceAlphabet("target", target))
+	{
+		// check for minimal sequence length (>=seedBP)
+		if (!noSeedRequired) {
+			for( size_t i=0; i<target.size(); i++) {
+				if (target.at(i).size() < seedBP.val) {
+					throw std::runtime_error("length of target sequence "+toString(targetNumberOffset+i+1)+" is below minimal number of seed base pairs (seedBP="+toString(seedBP.val)+")");
+				}
+			}
+		}
+		// valide accessibility input from file
+		validate_tAccFile( tAccFile );
+		// setup full regions
+		parseRegion( "tRegion", tRegionString, target, tRegion );
+		prefilterTargetRegions();
+		// generate empty constraint
+		tAccConstr = std::string(target.at(0).size(),'.');
+	}
+
+	if (parsingCode != ReturnCode::KEEP_GOING) {
+		throw std::runtime_error("parsing of target sequence chunk starting with sequence "+toString(targetNumberOffset+1)+" failed");
+	}
+	return true;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+prefilterTargetRegions()
+{
+	tPrefilterRegion.clear();
+	if (tPrefilter.val <= 0 || parsingCode != ReturnCode::KEEP_GOING) {
+		return;
+	}
+
+	// k-mer length = stacked helix present in any seed (target = seq1)
+	const size_t k = std::min( SeedKmerIndex::MAX_K, SeedKmerIndex::getHelixLength( seedBP.val, seedMaxUP.val
+			, seedTMaxUP.val<0 ? seedMaxUP.val : seedTMaxUP.val
+			, seedQMaxUP.val<0 ? seedMaxUP.val : seedQMaxUP.val ) );
+
+	VLOG(1) <<"indexing "<<k<<"-mers of "<<target.size()<<" target sequence(s) for seed prefiltering...";
+	const SeedKmerIndex index( target, k );
+
+	tPrefilterRegion.resize( query.size() );
+	size_t rangesAll = 0, rangesSkipped = 0, windows = 0, lengthAll = 0, lengthKept = 0;
+	std::vector< IndexRangeList > hitWindows;
+	for (size_t q=0; q<query.size(); q++) {
+		// get windows around seed hits of this query within all targets
+		index.getWindows( query.at(q), qRegion.at(q), (size_t)tPrefilter.val, hitWindows );
+		// intersect with the target regions
+		tPrefilterRegion[q].resize( target.size() );
+		for (size_t t=0; t<target.size(); t++) {
+			IndexRangeList & kept = tPrefilterRegion[q][t];
+			IndexRangeList::const_iterator w = hitWindows.at(t).begin();
+			BOOST_FOREACH( const IndexRange & r, tRegion.at(t) ) {
+				const size_t rangeEnd = std::min( r.to, target.at(t).size()-1 );
+				const size_t keptBefore = kept.size();
+				// skip windows left of the range
+				while (w != hitWindows.at(t).end() && w->to < r.from) {
+					w++;
+				}
+				// add all overlaps with the range
+				for (IndexRangeList::const_iterator w2 = w; w2 != hitWindows.at(t).end() && w2->from <= rangeEnd; w2++) {
+					kept.push_back( IndexRange( std::max( r.from, w2->from ), std::min( rangeEnd, w2->to ) ) );
+					lengthKept += kept.rbegin()->to - kept.rbegin()->from + 1;
+				}
+				// statistics
+				rangesAll++;
+				lengthAll += rangeEnd - r.from + 1;
+				if (kept.size() == keptBefore) {
+					rangesSkipped++;
+				}
+			}
+			windows += kept.size();
+		}
+	}
+
+	LOG(INFO) <<"seed prefilter ("<<k<<"-mers) : "<<rangesSkipped<<" of "<<rangesAll
+			<<" target region(s) skipped; "<<windows<<" window(s) kept covering "
+			<<lengthKept<<" of "<<lengthAll<<" target positions"
+			<<" ("<<(lengthAll == 0 ? 0 : (100*(lengthAll-lengthKept)/lengthAll))<<"% skipped)";
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CommandLineParsing::
+readTargetChunk()
+{
+	// mapped FASTA file input
+	if (targetFasta != NULL) {
+		if (targetFastaNext >= targetFastaSelection.size()) {
+			return false;
+		}
+		targetNumberOffset += target.size();
+		target.clear();
+		while( target.size() < (size_t)tStream.val && targetFastaNext < targetFastaSelection.size() ) {
+			target.push_back( targetFasta->getSequence( targetFastaSelection.at(targetFastaNext++) ) );
+		}
+		return true;
+	}
+	// stream input
+	if (targetStream != NULL) {
+		*targetStream >> std::ws;
+		if (targetStream->eof()) {
+			return false;
+		}
+		targetNumberOffset += target.size();
+		target.clear();
+		parseSequencesFasta("target", *targetStream, target, tStream.val);
+		return true;
+	}
+	return false;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+bool
+CommandLineParsing::
+isQueryAccessibilityFromStdin() const
+{
+	checkIfParsed();
+	return (qAcc.val == 'E' || qAcc.val == 'P') && boost::iequals(qAccFile,"STDIN");
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 Accessibility*
 CommandLineParsing::
 getQueryAccessibility( const size_t sequenceNumber ) const
@@ -1072,13 +1418,14 @@ getQueryAccessibility( const size_t sequenceNumber ) const
     						);
 
 		case 'V' : // VRNA-based accessibilities
-			return new AccessibilityVrna(
+			return getVrnaAccessibility(
 							seq
 							, std::min( qIntLenMax.val == 0 ? seq.size() : qIntLenMax.val
 										, qAccW.val == 0 ? seq.size() : qAccW.val )
-							, &accConstraint
-							, vrnaHandler
+							, accConstraint
+							, qAccConstr
 							, qAccW.val
+							, qAccL.val
 							);
 		default :
 			INTARNA_NOT_IMPLEMENTED("query accessibility computation not implemented for energy = '"+toString(energy.val)+"'. Disable via --qAcc=N.");
@@ -1160,13 +1507,14 @@ getTargetAccessibility( const size_t sequenceNumber ) const
 								);
 
 		case 'V' : // VRNA-based accessibilities
-			return new AccessibilityVrna(
+			return getVrnaAccessibility(
 								seq
 								, std::min( tIntLenMax.val == 0 ? seq.size() : tIntLenMax.val
 										, tAccW.val == 0 ? seq.size() : tAccW.val )
-								, &accConstraint
-								, vrnaHandler
+								, accConstraint
+								, tAccConstr
 								, tAccW.val
+								, tAccL.val
 								);
 		default :
 			INTARNA_NOT_IMPLEMENTED("target accessibility computation not implemented for energy = '"+toString(energy.val)+"'. Disable via --tAcc=N.");
@@ -1179,9 +1527,59 @@ getTargetAccessibility( const size_t sequenceNumber ) const
 
 ////////////////////////////////////////////////////////////////////////////
 
+Accessibility*
+CommandLineParsing::
+getVrnaAccessibility( const RnaSequence & seq
+					, const size_t maxLength
+					, const AccessibilityConstraint & accConstraint
+					, const std::string & accConstrString
+					, const int plFoldW
+					, const int plFoldL ) const
+{
+	// no caching
+	if (accCache.empty()) {
+		return new AccessibilityVrna( seq, maxLength, &accConstraint, vrnaHandler, plFoldW );
+	}
+
+	// key of all data the ED values depend on
+	std::stringstream key;
+	key <<"seq="<<seq.asString()
+		<<";VRNA="<<VRNA_VERSION
+		<<";T="<<temperature.val
+		<<";energyFile="<<energyFileContent
+		<<";W="<<plFoldW
+		<<";L="<<plFoldL
+		<<";maxLength="<<maxLength
+		<<";constraint="<<accConstrString;
+	const std::string cacheFile = AccessibilityFromCache::getCacheFileName( accCache, key.str() );
+
+	// check if available
+	const size_t accMaxLength = (maxLength==0 ? seq.size() : std::min(maxLength,seq.size()));
+	if (AccessibilityFromCache::isValidCache( cacheFile, key.str(), seq.size(), accMaxLength )) {
+		return new AccessibilityFromCache( seq, maxLength, &accConstraint, cacheFile, key.str() );
+	}
+
+	// compute and store in cache
+	Accessibility * acc = new AccessibilityVrna( seq, maxLength, &accConstraint, vrnaHandler, plFoldW );
+	try {
+		AccessibilityFromCache::writeCache( *acc, cacheFile, key.str() );
+	} catch (std::exception & ex) {
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ LOG(WARNING) <<"accessibility cache not updated : "<<ex.what(); }
+	}
+	return acc;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 InteractionEnergy*
 CommandLineParsing::
-getEnergyHandler( const Accessibility& accTarget, const ReverseAccessibility& accQuery ) const
+getEnergyHandler( const Accessibility& accTarget
+				, const ReverseAccessibility& accQuery
+				, const InteractionEnergyVrna::EsMatrix * esTarget
+				, const InteractionEnergyVrna::EsMatrix * esQuery ) const
 {
 	checkIfParsed();
 
@@ -1190,7 +1588,7 @@ getEnergyHandler( const Accessibility& accTarget, const ReverseAccessibility& ac
 
 	switch( energy.val ) {
 	case 'B' : return new InteractionEnergyBasePair( accTarget, accQuery, tIntLoopMax.val, qIntLoopMax.val, initES );
-	case 'V' : return new InteractionEnergyVrna( accTarget, accQuery, vrnaHandler, tIntLoopMax.val, qIntLoopMax.val, initES );
+	case 'V' : return new InteractionEnergyVrna( accTarget, accQuery, vrnaHandler, tIntLoopMax.val, qIntLoopMax.val, initES, esTarget, esQuery );
 	default :
 		INTARNA_NOT_IMPLEMENTED("CommandLineParsing::getEnergyHandler : energy = '"+toString(energy.val)+"' is not supported");
 	}
@@ -1200,9 +1598,27 @@ getEnergyHandler( const Accessibility& accTarget, const ReverseAccessibility& ac
 
 ////////////////////////////////////////////////////////////////////////////
 
+InteractionEnergyVrna::EsMatrix *
+CommandLineParsing::
+getEsValues( const Accessibility& acc ) const
+{
+	checkIfParsed();
+
+	// check whether ES values are needed (for multi-site predictions)
+	if (energy.val != 'V' || std::string("M").find(pred.val) == std::string::npos) {
+		return NULL;
+	}
+
+	InteractionEnergyVrna::EsMatrix * esValues = new InteractionEnergyVrna::EsMatrix();
+	InteractionEnergyVrna::computeES( acc, vrnaHandler, *esValues );
+	return esValues;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 OutputConstraint
 CommandLineParsing::
-getOutputConstraint()  const
+getOutputConstraint( const E_type * maxEglobal )  const
 {
 	checkIfParsed();
 	OutputConstraint::ReportOverlap overlap = OutputConstraint::ReportOverlap::OVERLAP_BOTH;
@@ -1216,8 +1632,9 @@ getOutputConstraint()  const
 	return OutputConstraint(
 			  outNumber.val
 			, overlap
-			, static_cast<E_type>(outMaxE.val)
-			, static_cast<E_type>(outDeltaE.val)
+			, Ekcal_2_E(outMaxE.val)
+			, Ekcal_2_E(outDeltaE.val)
+			, maxEglobal
 			);
 }
 
@@ -1227,11 +1644,19 @@ void
 CommandLineParsing::
 parseSequences(const std::string & paramName,
 					const std::string& paramArg,
-					RnaSequenceVec& sequences )
+					RnaSequenceVec& sequences,
+					const std::string & idSubset )
 {
 	// clear sequence container
 	sequences.clear();
 
+	// subset selection only for file input
+	if (!idSubset.empty() && (boost::iequals(paramArg,"STDIN") || RnaSequence::isValidSequenceIUPAC(paramArg))) {
+		LOG(ERROR) <<"ID subset selection for "<<paramName<<" requires FASTA file input";
+		updateParsingCode( ReturnCode::STOP_PARSING_ERROR );
+		return;
+	}
+
 	// read FASTA from STDIN stream
 	if (boost::iequals(paramArg,"STDIN")) {
 		parseSequencesFasta(paramName, std::cin, sequences);
@@ -1241,21 +1666,25 @@ parseSequences(const std::string & paramName,
 		sequences.push_back(RnaSequence(paramName,paramArg));
 	} else
 	{
-		// open file handle
-		std::ifstream infile(paramArg);
+		// check file
+		if (!validateFile( paramArg )) {
+			LOG(ERROR) <<"FASTA parsing of "<<paramName<<" : could not open FASTA file  '"<<paramArg<<"'";
+			updateParsingCode( ReturnCode::STOP_PARSING_ERROR );
+			return;
+		}
 		try {
-			if(!infile.good()){
-				LOG(ERROR) <<"FASTA parsing of "<<paramName<<" : could not open FASTA file  '"<<paramArg<<"'";
-				updateParsingCode( ReturnCode::STOP_PARSING_ERROR );
-			} else {
-				parseSequencesFasta(paramName, infile, sequences);
+			// map file and construct the selected sequences directly
+			FastaFileMapped fasta( paramArg );
+			std::vector<size_t> selection;
+			parseFastaSelection( paramName, fasta, idSubset, selection );
+			sequences.reserve( selection.size() );
+			BOOST_FOREACH( const size_t i, selection ) {
+				sequences.push_back( fasta.getSequence( i ) );
 			}
 		} catch (std::exception & ex) {
 			LOG(ERROR) <<"error while FASTA parsing of "<<paramName<<" : "<<ex.what();
 			updateParsingCode( ReturnCode::STOP_PARSING_ERROR );
 		}
-		// close stream
-		infile.close();
 	}
 
 	// holds current validation status to supress checks once a validation failed
@@ -1269,20 +1698,77 @@ parseSequences(const std::string & paramName,
 }
 
 
+////////////////////////////////////////////////////////////////////////////
+
+void
+CommandLineParsing::
+parseFastaSelection( const std::string & paramName,
+					const FastaFileMapped & fasta,
+					const std::string & idSubset,
+					std::vector<size_t> & selection )
+{
+	selection.clear();
+	if (idSubset.empty()) {
+		// select all sequences
+		selection.resize( fasta.size() );
+		for (size_t i=0; i<fasta.size(); i++) {
+			selection[i] = i;
+		}
+	} else {
+		// get IDs either from file (one per line) or from comma-separated list
+		std::vector<std::string> ids;
+		if (boost::filesystem::is_regular_file( idSubset )) {
+			std::ifstream idFile( idSubset );
+			std::string id;
+			while( idFile >> id ) {
+				ids.push_back( id );
+			}
+		} else {
+			boost::split( ids, idSubset, boost::is_any_of(","), boost::token_compress_on );
+		}
+		// get index of each ID
+		BOOST_FOREACH( const std::string & id, ids ) {
+			if (id.empty()) {
+				continue;
+			}
+			const size_t i = fasta.getIndex( id );
+			if (i == fasta.size()) {
+				LOG(ERROR) <<"FASTA parsing of "<<paramName<<" : no sequence for ID '"<<id<<"' found";
+				updateParsingCode( ReturnCode::STOP_PARSING_ERROR );
+			} else {
+				selection.push_back( i );
+			}
+		}
+	}
+	// check if data complete
+	BOOST_FOREACH( const size_t i, selection ) {
+		if (fasta.getLength( i ) == 0) {
+			LOG(ERROR) <<"FASTA parsing of "<<paramName<<" : no sequence for ID '"<<fasta.getId( i )<<"'";
+			updateParsingCode( ReturnCode::STOP_PARSING_ERROR );
+		}
+	}
+}
+
 ////////////////////////////////////////////////////////////////////////////
 
 void
 CommandLineParsing::
 parseSequencesFasta( const std::string & paramName,
 					std::istream& input,
-					RnaSequenceVec& sequences)
+					RnaSequenceVec& sequences,
+					const size_t maxNumber )
 {
 	// temporary variables
 	std::string line, name, sequence;
 	int trimStart = 0;
 
 	// read linewise
-	while( std::getline( input, line ) ) {
+	// (if maxNumber>0 : until the last sequence to parse is complete, i.e.
+	//  the next ID line is ahead)
+	while( !( maxNumber > 0 && sequences.size()+1 >= maxNumber
+				&& !name.empty() && !sequence.empty() && input.peek() == '>' )
+			&& std::getline( input, line ) )
+	{
 		// ignore empty lines
 		if( line.empty() ) {
 			continue;
@@ -1401,6 +1887,17 @@ getTemperature() const {
 
 ////////////////////////////////////////////////////////////////////////////
 
+bool
+CommandLineParsing::
+isPredictionTrackingEnabled() const
+{
+	return !outPrefix2streamName.at(OutPrefixCode::OP_tMinE).empty()
+			|| !outPrefix2streamName.at(OutPrefixCode::OP_qMinE).empty()
+			|| !outPrefix2streamName.at(OutPrefixCode::OP_pMinE).empty();
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 Predictor*
 CommandLineParsing::
 getPredictor( const InteractionEnergy & energy, OutputHandler & output ) const
@@ -1542,27 +2039,57 @@ initOutputHandler()
 		getOutputStream()
 		<<OutputHandlerCsv::getHeader( OutputHandlerCsv::string2list( outCsvCols ) )
 		; break;
+	case 'B' :
+		getOutputStream()
+		<<OutputHandlerBinary::getFileHeader()
+		; break;
 	}
 
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
+std::string
+CommandLineParsing::
+getOutputSeparator() const
+{
+	switch (outMode.val) {
+	case '1' :
+	case 'O' :
+		return OutputHandlerIntaRNA1::getSeparator();
+	default :
+		return "";
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 OutputHandler*
 CommandLineParsing::
 getOutputHandler( const InteractionEnergy & energy ) const
+{
+	return getOutputHandler( energy, getOutputStream() );
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+OutputHandler*
+CommandLineParsing::
+getOutputHandler( const InteractionEnergy & energy, std::ostream & out ) const
 {
 	switch (outMode.val) {
 	case 'N' :
-		return new OutputHandlerText( getOutputStream(), energy, 10, false );
+		return new OutputHandlerText( out, energy, 10, false );
 	case 'D' :
-		return new OutputHandlerText( getOutputStream(), energy, 10, true );
+		return new OutputHandlerText( out, energy, 10, true );
 	case 'C' :
-		return new OutputHandlerCsv( getOutputStream(), energy, OutputHandlerCsv::string2list( outCsvCols ));
+		return new OutputHandlerCsv( out, energy, OutputHandlerCsv::string2list( outCsvCols ));
 	case '1' :
-		return new OutputHandlerIntaRNA1( getOutputStream(), energy, false );
+		return new OutputHandlerIntaRNA1( out, energy, false );
 	case 'O' :
-		return new OutputHandlerIntaRNA1( getOutputStream(), energy, true );
+		return new OutputHandlerIntaRNA1( out, energy, true );
+	case 'B' :
+		return new OutputHandlerBinary( out, energy );
 	default :
 		INTARNA_NOT_IMPLEMENTED("Output mode "+toString(outMode.val)+" not implemented yet");
 	}
@@ -1583,6 +2110,10 @@ const SeedConstraint &
 CommandLineParsing::
 getSeedConstraint( const InteractionEnergy & energy ) const
 {
+	// ensure single initialization if called from within parallel predictions
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_seedConstraintInit)
+#endif
 	if (seedConstraint == NULL) {
 		// setup according to user data
 		seedConstraint = new SeedConstraint(
@@ -1590,7 +2121,7 @@ getSeedConstraint( const InteractionEnergy & energy ) const
 							, seedMaxUP.val
 							, seedTMaxUP.val<0 ? seedMaxUP.val : seedTMaxUP.val
 							, seedQMaxUP.val<0 ? seedMaxUP.val : seedQMaxUP.val
-							, seedMaxE.val
+							, Ekcal_2_E(seedMaxE.val)
 							, (seedMinPu.val>0 ? std::min<E_type>(Accessibility::ED_UPPER_BOUND, energy.getE( seedMinPu.val )) : Accessibility::ED_UPPER_BOUND) // transform unpaired prob to ED value
 							// shift ranges to start counting with 0
 							, IndexRangeList( seedTRange ).shift(-1,energy.size1()-1)
@@ -1609,8 +2140,6 @@ getQueryRanges( const size_t sequenceNumber ) const
 #if INTARNA_IN_DEBUG_MODE
 	if (sequenceNumber>=qRegion.size())
 		throw std::runtime_error("CommandLineParsing::getQueryRanges("+toString(sequenceNumber)+") out of bounds");
-	if (qRegion.at(sequenceNumber).empty())
-		throw std::runtime_error("CommandLineParsing::getQueryRanges("+toString(sequenceNumber)+") is empty");
 #endif
 	return qRegion.at(sequenceNumber);
 }
@@ -1624,14 +2153,29 @@ getTargetRanges( const size_t sequenceNumber ) const
 #if INTARNA_IN_DEBUG_MODE
 	if (sequenceNumber>=tRegion.size())
 		throw std::runtime_error("CommandLineParsing::getTargetRanges("+toString(sequenceNumber)+") out of bounds");
-	if (tRegion.at(sequenceNumber).empty())
-		throw std::runtime_error("CommandLineParsing::getTargetRanges("+toString(sequenceNumber)+") is empty");
 #endif
 	return tRegion.at(sequenceNumber);
 }
 
 ////////////////////////////////////////////////////////////////////////////
 
+const IndexRangeList&
+CommandLineParsing::
+getTargetRanges( const size_t targetNumber, const size_t queryNumber ) const
+{
+	// no prefiltering
+	if (tPrefilterRegion.empty()) {
+		return getTargetRanges( targetNumber );
+	}
+#if INTARNA_IN_DEBUG_MODE
+	if (queryNumber>=tPrefilterRegion.size() || targetNumber>=tPrefilterRegion.at(queryNumber).size())
+		throw std::runtime_error("CommandLineParsing::getTargetRanges("+toString(targetNumber)+","+toString(queryNumber)+") out of bounds");
+#endif
+	return tPrefilterRegion.at(queryNumber).at(targetNumber);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 void
 CommandLineParsing::
 writeAccessibility( const Accessibility& acc, const std::string & fileOrStream, const bool writeED ) const
@@ -4,16 +4,21 @@
 
 #include "IntaRNA/general.h"
 #include "IntaRNA/RnaSequence.h"
+#include "IntaRNA/FastaFileMapped.h"
 
 #include <boost/regex.hpp>
 #include <boost/program_options.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/filesystem.hpp>
 
 #include <iostream>
 #include <cstdarg>
+#include <map>
+#include <unordered_map>
 
 #include "IntaRNA/Accessibility.h"
 #include "IntaRNA/InteractionEnergy.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
 #include "IntaRNA/OutputHandler.h"
 #include "IntaRNA/Predictor.h"
 #include "IntaRNA/SeedConstraint.h"
@@ -32,6 +37,8 @@ public:
 	typedef std::vector< RnaSequence > RnaSequenceVec;
 	//! type for a list of ranges for the sequences
 	typedef std::vector<IndexRangeList> IndexRangeListVec;
+	//! type for the (merged) ranges of each sequence name read from BED file
+	typedef std::unordered_map< std::string, IndexRangeList > RegionIndex;
 
 	//! different exit codes for parsing
 	enum ReturnCode {
@@ -79,6 +86,31 @@ public:
 	 */
 	const RnaSequenceVec& getTargetSequences() const;
 
+	/**
+	 * Whether or not the target sequences are read chunk-wise from the input
+	 * (see --tStream), i.e. getTargetSequences() provides only the current
+	 * chunk and parseNextTargetChunk() has to be called to proceed.
+	 * @return true if the target input is streamed; false otherwise
+	 */
+	bool isTargetStreamed() const;
+
+	/**
+	 * Replaces the target sequences (and their regions) by the next chunk of
+	 * sequences read from the target input if streamed.
+	 * Throws a std::runtime_error if the parsing of the chunk failed.
+	 * @return true if a new chunk was parsed; false if the input is exhausted
+	 *         or not streamed
+	 */
+	bool parseNextTargetChunk();
+
+	/**
+	 * Provides the number of target sequences of all chunks preceding the
+	 * current chunk, i.e. the overall index of the first sequence returned by
+	 * getTargetSequences().
+	 * @return the index offset of the current target chunk
+	 */
+	size_t getTargetNumberOffset() const;
+
 	/**
 	 * Returns a newly allocated Accessibility object for the given query
 	 * sequence according to the user defined parameters.
@@ -88,6 +120,13 @@ public:
 	 */
 	Accessibility* getQueryAccessibility( const size_t sequenceNumber ) const;
 
+	/**
+	 * Whether or not the query accessibilities are read from STDIN, i.e.
+	 * getQueryAccessibility() has to be called in the order of the queries.
+	 * @return true if query accessibilities are parsed from STDIN
+	 */
+	bool isQueryAccessibilityFromStdin() const;
+
 	/**
 	 * Returns a newly allocated Accessibility object for the given target
 	 * sequence according to the user defined parameters.
@@ -102,7 +141,8 @@ public:
 	 * according sequence number.
 	 * @param sequenceNumber the number of the sequence within the vector
 	 *         returned by getQuerySequences()
-	 * @return the range list for the according sequence.
+	 * @return the range list for the according sequence, which is empty if
+	 *         no region was given for the sequence in BED input.
 	 */
 	const IndexRangeList& getQueryRanges( const size_t sequenceNumber ) const;
 
@@ -111,19 +151,53 @@ public:
 	 * according sequence number.
 	 * @param sequenceNumber the number of the sequence within the vector
 	 *         returned by getTargetSequences()
-	 * @return the range list for the according sequence.
+	 * @return the range list for the according sequence, which is empty if
+	 *         no region was given for the sequence in BED input.
 	 */
 	const IndexRangeList& getTargetRanges( const size_t sequenceNumber ) const;
 
+	/**
+	 * Access to the ranges to screen for interactions for the target with the
+	 * according sequence number in combination with the given query. If the
+	 * target prefilter is enabled (see --tPrefilter), only the windows of
+	 * the target ranges around seed hits of the query are provided.
+	 * @param targetNumber the number of the sequence within the vector
+	 *         returned by getTargetSequences()
+	 * @param queryNumber the number of the sequence within the vector
+	 *         returned by getQuerySequences()
+	 * @return the range list for the according target, which is empty if
+	 *         no region was given for the sequence in BED input or if no
+	 *         seed hit was found by the prefilter
+	 */
+	const IndexRangeList& getTargetRanges( const size_t targetNumber, const size_t queryNumber ) const;
+
 	/**
 	 * Returns a newly allocated Energy object according to the user defined
 	 * parameters.
 	 * @param accTarget the accessibility object of the target sequence
 	 * @param accQuery the (reversed) accessibility object of the query sequence
+	 * @param esTarget if not NULL, the ES values of the target provided by
+	 *         getEsValues(accTarget) to be used instead of a recomputation
+	 * @param esQuery if not NULL, the ES values of the query provided by
+	 *         getEsValues(accQuery) to be used instead of a recomputation
 	 * @return the newly allocated Energy object to be deleted by the calling
 	 * function or NULL in error case
 	 */
-	InteractionEnergy* getEnergyHandler( const Accessibility& accTarget, const ReverseAccessibility& accQuery ) const;
+	InteractionEnergy* getEnergyHandler( const Accessibility& accTarget
+								, const ReverseAccessibility& accQuery
+								, const InteractionEnergyVrna::EsMatrix * esTarget = NULL
+								, const InteractionEnergyVrna::EsMatrix * esQuery = NULL ) const;
+
+	/**
+	 * Computes the ES values for the given accessibility object if they are
+	 * needed by the energy handlers provided by getEnergyHandler(). Since ES
+	 * values depend on a single sequence only, they can be shared among all
+	 * energy handlers for this sequence.
+	 * @param acc the accessibility object (reversed for query sequences)
+	 * @return the newly allocated ES values to be deleted by the calling
+	 * function or NULL if no ES values are needed
+	 */
+	InteractionEnergyVrna::EsMatrix * getEsValues( const Accessibility& acc ) const;
 
 	/**
 	 * Provides a newly allocated output handler according to the user request.
@@ -135,6 +209,18 @@ public:
 	 */
 	OutputHandler* getOutputHandler(const InteractionEnergy & energy) const;
 
+	/**
+	 * Provides a newly allocated output handler according to the user request
+	 * that writes to the given stream.
+	 *
+	 * @param energy the energy handler used for interaction computation
+	 * @param out the stream to write to
+	 *
+	 * @return the newly allocated OutputHandler object to be deleted by the
+	 * calling function
+	 */
+	OutputHandler* getOutputHandler(const InteractionEnergy & energy, std::ostream & out) const;
+
 	/**
 	 * Provides a newly allocated predictor according to the user defined
 	 * parameters
@@ -146,6 +232,16 @@ public:
 	Predictor* getPredictor( const InteractionEnergy & energy
 			, OutputHandler & output ) const;
 
+	/**
+	 * Whether or not the predictors provided by getPredictor() track
+	 * additional data (e.g. minE profiles) over all predict() calls of a
+	 * target-query combination. If so, all index ranges of a combination have
+	 * to be processed by the same predictor.
+	 *
+	 * @return true if prediction tracking is enabled; false otherwise
+	 */
+	bool isPredictionTrackingEnabled() const;
+
 
 	/**
 	 * Provides the seed constraint according to the user settings
@@ -162,9 +258,28 @@ public:
 
 	/**
 	 * The constraints to be applied to the interaction output generation
+	 * @param maxEglobal optional global (decreasing) upper bound of the
+	 *        energy of reported interactions or NULL
 	 * @return the output constraints to be applied
 	 */
-	OutputConstraint getOutputConstraint() const;
+	OutputConstraint getOutputConstraint( const E_type * maxEglobal = NULL ) const;
+
+	/**
+	 * Number of interactions to be reported over all query-target
+	 * combinations, i.e. the global top-K output.
+	 * @return the number of globally best interactions to be reported or
+	 * 0 if the output is done for each combination individually
+	 */
+	size_t
+	getOutTopK() const;
+
+	/**
+	 * The separator to be written between the outputs of interactions that
+	 * were formatted by different output handlers.
+	 * @return the separator (IntaRNA v1 output) or an empty string
+	 */
+	std::string
+	getOutputSeparator() const;
 
 	/**
 	 * The stream to write the interaction output to
@@ -192,6 +307,16 @@ public:
 	 */
 	size_t
 	getThreads() const;
+
+	/**
+	 * Maximal number of query-target-combinations that are computed ahead of
+	 * the first combination whose output was not written yet, if the output
+	 * is to be written in input order.
+	 * @return the window size for ordered output or 0 if the output is
+	 * written in order of computation
+	 */
+	size_t
+	getOutOrderWindow() const;
 #endif
 
 protected:
@@ -382,6 +507,27 @@ protected:
 	std::string tRegionString;
 	//! the list of interaction intervals for each target sequence
 	IndexRangeListVec tRegion;
+	//! the region index for each parsed BED file
+	std::map< std::string, RegionIndex > regionFile2index;
+	//! number of target sequences to be read and processed at once (0 = all)
+	NumberParameter<int> tStream;
+	//! flank size of the target windows around seed hits of the k-mer
+	//! prefilter (0 = no prefilter)
+	NumberParameter<int> tPrefilter;
+	//! for each query the list of prefiltered interaction intervals for each target
+	std::vector< IndexRangeListVec > tPrefilterRegion;
+	//! the IDs of the target sequences to be read from file (empty = all)
+	std::string tSubset;
+	//! the input stream target sequences are read from chunk-wise or NULL
+	std::istream * targetStream;
+	//! the mapped FASTA file target sequences are read from chunk-wise or NULL
+	FastaFileMapped * targetFasta;
+	//! the indices of the sequences within targetFasta to be processed
+	std::vector<size_t> targetFastaSelection;
+	//! the index within targetFastaSelection of the next target to be read
+	size_t targetFastaNext;
+	//! number of target sequences of all chunks preceding the current one
+	size_t targetNumberOffset;
 
 	//! whether or not a seed is to be required for an interaction or not
 	bool noSeedRequired;
@@ -394,9 +540,9 @@ protected:
 	//! max unpaired in target's seed
 	NumberParameter<int> seedTMaxUP;
 	//! max energy of a seed to be considered
-	NumberParameter<E_type> seedMaxE;
+	NumberParameter<Ekcal_type> seedMaxE;
 	//! minimal unpaired probability (per sequence) of a seed to be considered
-	NumberParameter<E_type> seedMinPu;
+	NumberParameter<Z_type> seedMinPu;
 	//! intervals in query for seed search
 	std::string seedQRange;
 	//! intervals in target for seed search
@@ -414,12 +560,18 @@ protected:
 #if INTARNA_MULITHREADING
 	//! number of threads = number of parallel predictors running
 	NumberParameter<int> threads;
+	//! window size of the reorder buffer for ordered output (0 = disabled)
+	NumberParameter<int> outOrderWindow;
 #endif
+	//! the directory of the binary accessibility cache (empty if disabled)
+	std::string accCache;
 
 	//! the selected energy model
 	CharParameter energy;
 	//! the provided energy parameter file of the VRNA package
 	std::string energyFile;
+	//! the content of the provided energy parameter file (for cache keys)
+	std::string energyFileContent;
 
 	//! where to write the output to and for each in what format
 //	std::string out;
@@ -438,6 +590,8 @@ protected:
 	NumberParameter<double> outDeltaE;
 	//! max E allowed to report an interaction
 	NumberParameter<double> outMaxE;
+	//! number of globally best interactions to report (0 = disabled)
+	NumberParameter<int> outTopK;
 	//! the CSV column selection
 	std::string outCsvCols;
 	//! the CSV column selection
@@ -565,6 +719,18 @@ protected:
 	 */
 	void validate_tRegion(const std::string & value);
 
+	/**
+	 * Validates the tStream argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_tStream(const int & value);
+
+	/**
+	 * Validates the tPrefilter argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_tPrefilter(const int & value);
+
 	/**
 	 * Validates the seedBP argument.
 	 * @param value the argument value to validate
@@ -593,13 +759,13 @@ protected:
 	 * Validates the seedMaxE argument.
 	 * @param value the argument value to validate
 	 */
-	void validate_seedMaxE(const E_type & value);
+	void validate_seedMaxE(const Ekcal_type & value);
 
 	/**
 	 * Validates the seedMinPu argument.
 	 * @param value the argument value to validate
 	 */
-	void validate_seedMinPu(const E_type & value);
+	void validate_seedMinPu(const Z_type & value);
 
 	/**
 	 * Validates the seedQRange argument.
@@ -682,6 +848,12 @@ protected:
 	 */
 	void validate_outMaxE(const double & value);
 
+	/**
+	 * Validates the outTopK argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_outTopK(const int & value);
+
 	/**
 	 * Validates the outCsvCols argument.
 	 * @param value the argument value to validate
@@ -694,8 +866,20 @@ protected:
 	 * @param value the argument value to validate
 	 */
 	void validate_threads( const int & value);
+
+	/**
+	 * Validates the outOrderWindow argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_outOrderWindow( const int & value);
 #endif
 
+	/**
+	 * Validates the accCache argument.
+	 * @param value the argument value to validate
+	 */
+	void validate_accCache( const std::string & value);
+
 	////////////  GENERIC TESTS  /////////////////
 
 	/**
@@ -753,15 +937,61 @@ protected:
 	void validate_structureConstraintArgument(const std::string& argument, const std::string & value);
 
 
+	/**
+	 * Provides a VRNA-based accessibility object for the given sequence.
+	 * If an accessibility cache is used, the data is loaded from the cache
+	 * if available or the cache is filled after computation otherwise.
+	 *
+	 * @param seq the sequence to get the accessibility for
+	 * @param maxLength the maximal length of accessible regions
+	 * @param accConstraint the accessibility constraint to apply
+	 * @param accConstrString the string encoding of the constraint
+	 * @param plFoldW the sliding window size for the computation
+	 * @param plFoldL the maximal base pair span for the computation
+	 * @return the newly allocated accessibility object
+	 */
+	Accessibility* getVrnaAccessibility( const RnaSequence & seq
+					, const size_t maxLength
+					, const AccessibilityConstraint & accConstraint
+					, const std::string & accConstrString
+					, const int plFoldW
+					, const int plFoldL ) const;
+
 	/**
 	 * Parses the parameter value and returns all parsed sequences.
 	 * @param paramName the name of the parameter (for exception handling)
 	 * @param paramArg the given argument for the parameter
 	 * @param sequences the container to fill
+	 * @param idSubset if not empty, the IDs of the sequences to be read from
+	 *        file (see parseFastaSelection())
 	 */
 	void parseSequences(const std::string & paramName,
 					const std::string& paramArg,
-					RnaSequenceVec& sequences );
+					RnaSequenceVec& sequences,
+					const std::string & idSubset = "" );
+
+	/**
+	 * Identifies the sequences of a FASTA file to be used.
+	 * @param paramName the name of the parameter (for exception handling)
+	 * @param fasta the FASTA file to select from
+	 * @param idSubset the IDs of the sequences to select, either as
+	 *        comma-separated list or the name of a file with one ID per line;
+	 *        if empty, all sequences are selected
+	 * @param selection the container to fill with the indices of the selected
+	 *        sequences within fasta
+	 */
+	void parseFastaSelection( const std::string & paramName,
+					const FastaFileMapped & fasta,
+					const std::string & idSubset,
+					std::vector<size_t> & selection );
+
+	/**
+	 * Replaces the target sequences by the next chunk of streamed sequences
+	 * (without validation).
+	 * @return true if a new chunk was read; false if the input is exhausted
+	 *         or not streamed
+	 */
+	bool readTargetChunk();
 
 	/**
 	 * Parses the parameter input stream from FASTA format and returns all
@@ -769,10 +999,13 @@ protected:
 	 * @param paramName the name of the parameter (for exception handling)
 	 * @param input the input stream from where to read the FASTA data
 	 * @param sequences the container to fill
+	 * @param maxNumber if >0, the parsing stops after the given number of
+	 *        sequences was added (the input is positioned at the next ID line)
 	 */
 	void parseSequencesFasta( const std::string & paramName,
 					std::istream& input,
-					RnaSequenceVec& sequences);
+					RnaSequenceVec& sequences,
+					const size_t maxNumber = 0 );
 
 	/**
 	 * Checks whether or not a sequence container holds a specific number of
@@ -841,6 +1074,27 @@ protected:
 				, const RnaSequenceVec & sequences
 				, IndexRangeListVec & rangeList );
 
+	/**
+	 * Restricts the target regions for each query to the windows around
+	 * potential seed sites identified via a k-mer index of all targets
+	 * (see --tPrefilter) and stores them in tPrefilterRegion.
+	 * Does nothing if the prefilter is disabled.
+	 */
+	void
+	prefilterTargetRegions();
+
+	/**
+	 * Parses a BED file and provides for each sequence name the sorted list
+	 * of its regions, where overlapping or adjacent regions are merged.
+	 * The parsed index is stored in regionFile2index for reuse.
+	 * @param argName the name of the argument the @p fileName is for
+	 * @param fileName the BED file to be parsed
+	 * @return the region index of the file
+	 */
+	const RegionIndex &
+	parseRegionBed( const std::string & argName
+				, const std::string & fileName );
+
 	/**
 	 * Checks whether or not any command line argument were parsed. Throws a
 	 * std::runtime_error if not.
@@ -1114,7 +1368,7 @@ void CommandLineParsing::validate_tAccFile(const std::string & value)
 	if (!value.empty()) {
 		// if not STDIN
 		if ( boost::iequals(value,"STDIN") ) {
-			if (getTargetSequences().size()>1) {
+			if (getTargetSequences().size()>1 || isTargetStreamed()) {
 				LOG(ERROR) <<"reading target accessibilities for multiple sequences from '"<<value<<"' is not supported";
 				updateParsingCode(ReturnCode::STOP_PARSING_ERROR);
 			} else {
@@ -1142,6 +1396,22 @@ void CommandLineParsing::validate_tRegion(const std::string & value) {
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+void CommandLineParsing::validate_tStream(const int & value) {
+	// forward check to general method
+	validate_numberArgument("tStream", tStream, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void CommandLineParsing::validate_tPrefilter(const int & value) {
+	// forward check to general method
+	validate_numberArgument("tPrefilter", tPrefilter, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 inline
 void CommandLineParsing::validate_seedBP(const int & value) {
 	// forward check to general method
@@ -1175,7 +1445,7 @@ void CommandLineParsing::validate_seedTMaxUP(const int & value) {
 ////////////////////////////////////////////////////////////////////////////
 
 inline
-void CommandLineParsing::validate_seedMaxE(const E_type & value) {
+void CommandLineParsing::validate_seedMaxE(const Ekcal_type & value) {
 	// forward check to general method
 	validate_numberArgument("seedMaxE", seedMaxE, value);
 }
@@ -1183,7 +1453,7 @@ void CommandLineParsing::validate_seedMaxE(const E_type & value) {
 ////////////////////////////////////////////////////////////////////////////
 
 inline
-void CommandLineParsing::validate_seedMinPu(const E_type & value) {
+void CommandLineParsing::validate_seedMinPu(const Z_type & value) {
 	// forward check to general method
 	validate_numberArgument("seedMinPu", seedMinPu, value);
 }
@@ -1358,6 +1628,14 @@ void CommandLineParsing::validate_outNumber(const int & value) {
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+void CommandLineParsing::validate_outTopK(const int & value) {
+	// forward check to general method
+	validate_numberArgument("outTopK", outTopK, value);
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 inline
 void CommandLineParsing::validate_outOverlap(const char & value) {
 	// forward check to general method
@@ -1389,10 +1667,31 @@ void CommandLineParsing::validate_threads(const int & value)
 	// forward check to general method
 	validate_numberArgument("threads", threads, value);
 }
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+void CommandLineParsing::validate_outOrderWindow(const int & value)
+{
+	// forward check to general method
+	validate_numberArgument("outOrderWindow", outOrderWindow, value);
+}
 #endif
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+void CommandLineParsing::validate_accCache(const std::string & value)
+{
+	// check if directory exists
+	if (!value.empty() && !boost::filesystem::is_directory( value )) {
+		LOG(ERROR) <<"accCache : '" <<value <<"' is no existing directory";
+		updateParsingCode(ReturnCode::STOP_PARSING_ERROR);
+	}
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 inline
 void
 CommandLineParsing::
@@ -1441,6 +1740,36 @@ writeTargetAccessibility( const Accessibility & acc ) const
 
 ////////////////////////////////////////////////////////////////////////////
 
+inline
+bool
+CommandLineParsing::
+isTargetStreamed() const
+{
+	return targetStream != NULL || targetFasta != NULL;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+CommandLineParsing::
+getTargetNumberOffset() const
+{
+	return targetNumberOffset;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+CommandLineParsing::
+getOutTopK() const
+{
+	return outTopK.val;
+}
+
+////////////////////////////////////////////////////////////////////////////
+
 #if INTARNA_MULITHREADING
 inline
 size_t
@@ -1449,6 +1778,16 @@ getThreads() const
 {
 	return threads.val;
 }
+
+////////////////////////////////////////////////////////////////////////////
+
+inline
+size_t
+CommandLineParsing::
+getOutOrderWindow() const
+{
+	return outOrderWindow.val;
+}
 #endif
 
 ////////////////////////////////////////////////////////////////////////////
@@ -1470,14 +1809,14 @@ getFullFilename( const std::string & fileName, const RnaSequence * target, const
 	std::string prefix = "";
 	// generate target only
 	if (target != NULL && query == NULL) {
-		if (getTargetSequences().size() > 1) {
+		if (getTargetSequences().size() > 1 || isTargetStreamed()) {
 			prefix += "s";
 //			prefix += "t";
 			// search for index of the target sequence
 			for (size_t t = 0; t < getTargetSequences().size(); t++) {
 				if (getTargetSequences().at(t) == *target) {
-					// indexing starts with 1
-					prefix += toString(t+1);
+					// indexing starts with 1 (over all target chunks)
+					prefix += toString(getTargetNumberOffset()+t+1);
 					break;
 				}
 			}
@@ -1500,13 +1839,13 @@ getFullFilename( const std::string & fileName, const RnaSequence * target, const
 	} else
 	// generate combined part
 	{
-		if (getQuerySequences().size() > 1 || getTargetSequences().size() > 1) {
+		if (getQuerySequences().size() > 1 || getTargetSequences().size() > 1 || isTargetStreamed()) {
 			prefix += "t";
 			// search for index of the target sequence
 			for (size_t t = 0; t < getTargetSequences().size(); t++) {
 				if (getTargetSequences().at(t) == *target) {
-					// indexing starts with 1
-					prefix += toString(t+1);
+					// indexing starts with 1 (over all target chunks)
+					prefix += toString(getTargetNumberOffset()+t+1);
 					break;
 				}
 			}
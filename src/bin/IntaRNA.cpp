@@ -3,6 +3,7 @@
 
 #include <iostream>
 #include <exception>
+#include <vector>
 
 #if INTARNA_MULITHREADING
 	#include <omp.h>
@@ -15,15 +16,419 @@
 #include "IntaRNA/RnaSequence.h"
 #include "IntaRNA/Accessibility.h"
 #include "IntaRNA/InteractionEnergy.h"
+#include "IntaRNA/InteractionEnergyVrna.h"
 #include "IntaRNA/Predictor.h"
 #include "IntaRNA/OutputHandler.h"
 #include "IntaRNA/OutputHandlerIntaRNA1.h"
+#include "IntaRNA/OutputHandlerTopK.h"
+#include "IntaRNA/OutputReorderBuffer.h"
+#include "IntaRNA/OutputTopK.h"
 
 // initialize logging for binary
 INITIALIZE_EASYLOGGINGPP
 
 using namespace IntaRNA;
 
+/////////////////////////////////////////////////////////////////////
+/**
+ * Describes a single prediction task, i.e. a target-query combination
+ * and the index ranges to be considered within both sequences.
+ */
+struct PredictionTask {
+
+	//! index of the target sequence
+	size_t targetNumber;
+	//! index of the query sequence
+	size_t queryNumber;
+	//! the target range to predict for or NULL if all ranges are to be used
+	const IndexRange * tRange;
+	//! the query range to predict for or NULL if all ranges are to be used
+	const IndexRange * qRange;
+
+	/**
+	 * construction
+	 * @param targetNumber index of the target sequence
+	 * @param queryNumber index of the query sequence
+	 * @param tRange the target range or NULL for all ranges
+	 * @param qRange the query range or NULL for all ranges
+	 */
+	PredictionTask( const size_t targetNumber
+					, const size_t queryNumber
+					, const IndexRange * tRange
+					, const IndexRange * qRange )
+	 : targetNumber(targetNumber)
+		, queryNumber(queryNumber)
+		, tRange(tRange)
+		, qRange(qRange)
+	{}
+};
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Computes the accessibility of the given query and provides it in reversed
+ * indexing as needed for the interaction prediction.
+ *
+ * @param parameters the parsed program parameters
+ * @param queryNumber index of the query sequence
+ * @return the reversed query accessibility (to be deleted by the caller
+ *         together with its origin)
+ */
+ReverseAccessibility *
+computeQueryAccessibility( const CommandLineParsing & parameters, const size_t queryNumber )
+{
+#if INTARNA_MULITHREADING
+	#pragma omp critical(intarna_omp_logOutput)
+#endif
+	{ VLOG(1) <<"computing accessibility for query '"<<parameters.getQuerySequences().at(queryNumber).getId()<<"'..."; }
+
+	// get accessibility handler
+	Accessibility * queryAccOrig = parameters.getQueryAccessibility(queryNumber);
+	INTARNA_CHECK_NOT_NULL(queryAccOrig,"query initialization failed");
+
+	// check if we have to warn about ambiguity
+	if (queryAccOrig->getSequence().isAmbiguous()) {
+#if INTARNA_MULITHREADING
+		#pragma omp critical(intarna_omp_logOutput)
+#endif
+		{ LOG(INFO) <<"Sequence '"<<queryAccOrig->getSequence().getId()
+				<<"' contains ambiguous nucleotide encodings. These positions are ignored for interaction computation."; }
+	}
+
+	// reverse indexing of query sequence for the computation
+	return new ReverseAccessibility(*queryAccOrig);
+}
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Runs the prediction tasks of all target-query-range combinations for the
+ * target sequences currently provided by the parameters (all targets or the
+ * current chunk if targets are streamed).
+ *
+ * @param parameters the parsed program parameters
+ * @param reportedInteractions number of already reported interactions
+ *        (to be updated)
+ * @param queryAcc the query accessibilities shared among all chunks
+ *        (computed by the first task that needs them)
+ * @param queryES the query ES values shared among all chunks
+ * @param topK the global top-K output or NULL if not used
+ * @param queryAccLock (multithreading only) one lock per query to compute
+ *        its accessibility only once
+ * @param threadAborted (multithreading only) whether or not a thread was
+ *        aborted due to an exception (to be updated)
+ * @param exceptionPtrDuringOmp (multithreading only) the exception raised
+ *        within the aborted thread
+ * @param exceptionInfoDuringOmp (multithreading only) information on the
+ *        exception raised within the aborted thread
+ */
+void
+predictTargetChunk( const CommandLineParsing & parameters
+		, size_t & reportedInteractions
+		, std::vector< ReverseAccessibility * > & queryAcc
+		, std::vector< InteractionEnergyVrna::EsMatrix * > & queryES
+		, OutputTopK * topK
+#if INTARNA_MULITHREADING
+		, std::vector< omp_lock_t > & queryAccLock
+		, bool & threadAborted
+		, std::exception_ptr & exceptionPtrDuringOmp
+		, std::stringstream & exceptionInfoDuringOmp
+#endif
+		)
+{
+	// flatten all target-query-range combinations into one list of
+	// prediction tasks to enable a balanced parallelization independently
+	// of the number of targets, queries and ranges
+	// NOTE: if prediction tracking is enabled, all ranges of a target-query
+	// combination have to be handled by the same predictor (one task)
+	const bool splitRanges = !parameters.isPredictionTrackingEnabled();
+	std::vector< PredictionTask > tasks;
+	// number of not finished tasks per target to trigger accessibility cleanup
+	std::vector< size_t > targetTasksOpen( parameters.getTargetSequences().size(), 0 );
+	for ( size_t targetNumber = 0; targetNumber < parameters.getTargetSequences().size(); ++targetNumber ) {
+	for ( size_t queryNumber = 0; queryNumber < parameters.getQuerySequences().size(); ++queryNumber ) {
+		// skip combinations without regions to predict for (BED region input or
+		// no seed site found by the target prefilter)
+		if (parameters.getTargetRanges(targetNumber,queryNumber).empty() || parameters.getQueryRanges(queryNumber).empty()) {
+			continue;
+		}
+		if (splitRanges) {
+			BOOST_FOREACH(const IndexRange & tRange, parameters.getTargetRanges(targetNumber,queryNumber)) {
+			BOOST_FOREACH(const IndexRange & qRange, parameters.getQueryRanges(queryNumber)) {
+				tasks.push_back( PredictionTask( targetNumber, queryNumber, &tRange, &qRange ) );
+			}
+			}
+		} else {
+			tasks.push_back( PredictionTask( targetNumber, queryNumber, NULL, NULL ) );
+		}
+		targetTasksOpen[targetNumber] += (splitRanges ? parameters.getTargetRanges(targetNumber,queryNumber).size()*parameters.getQueryRanges(queryNumber).size() : 1);
+	}
+	}
+
+	// storage of target accessibilities shared by all according tasks (init NULL)
+	// computed by the first task that needs it and deleted by the last one
+	// NOTE: since tasks are ordered by target, only the accessibilities of
+	// the targets currently processed by some thread are kept in memory
+	std::vector< Accessibility * > targetAcc( parameters.getTargetSequences().size(), NULL );
+	// according ES values (if needed) with the same life time (init NULL)
+	std::vector< InteractionEnergyVrna::EsMatrix * > targetES( targetAcc.size(), NULL );
+
+#if INTARNA_MULITHREADING
+	// one lock per target to compute its accessibility only once
+	std::vector< omp_lock_t > targetAccLock( targetAcc.size() );
+	for (size_t t=0; t<targetAccLock.size(); t++) {
+		omp_init_lock( &(targetAccLock[t]) );
+	}
+	// if requested, the output of the tasks is written in task order
+	// (identical to serial computation) using a bounded reorder buffer
+	OutputReorderBuffer * orderedOutput = NULL;
+	if (parameters.getOutOrderWindow() > 0 && parameters.getThreads() > 1 && tasks.size() > 1 && topK == NULL) {
+		orderedOutput = new OutputReorderBuffer( parameters.getOutputStream(), parameters.getOutOrderWindow() );
+	}
+	// run all prediction tasks in parallel; tasks are dynamically assigned
+	// to idle threads to balance the workload
+	# pragma omp parallel for schedule(dynamic,1) num_threads( parameters.getThreads() ) shared(tasks,targetAcc,targetES,targetAccLock,targetTasksOpen,queryAcc,queryES,queryAccLock,reportedInteractions,exceptionPtrDuringOmp,exceptionInfoDuringOmp,orderedOutput,topK) if(tasks.size() > 1)
+#endif
+	for ( size_t taskNumber = 0; taskNumber < tasks.size(); ++taskNumber )
+	{
+		const size_t targetNumber = tasks.at(taskNumber).targetNumber;
+		const size_t queryNumber = tasks.at(taskNumber).queryNumber;
+#if INTARNA_MULITHREADING
+		#pragma omp flush (threadAborted)
+		// explicit try-catch-block due to missing OMP exception forwarding
+		if (!threadAborted && (orderedOutput == NULL || orderedOutput->waitForSlot( taskNumber ))) {
+			try {
+				// ensure query accessibility is computed only once
+				// (done first such that the threads working on the same
+				// target compute their queries while the target is computed)
+				omp_set_lock( &(queryAccLock[queryNumber]) );
+				try {
+#endif
+					if (queryAcc.at(queryNumber) == NULL) {
+						queryAcc[queryNumber] = computeQueryAccessibility( parameters, queryNumber );
+						queryES[queryNumber] = parameters.getEsValues( *(queryAcc.at(queryNumber)) );
+					}
+#if INTARNA_MULITHREADING
+				} catch (...) {
+					// release lock to avoid dead locks of other threads
+					omp_unset_lock( &(queryAccLock[queryNumber]) );
+					throw;
+				}
+				omp_unset_lock( &(queryAccLock[queryNumber]) );
+
+				// ensure target accessibility is computed only once
+				omp_set_lock( &(targetAccLock[targetNumber]) );
+				try {
+#endif
+					if (targetAcc.at(targetNumber) == NULL) {
+#if INTARNA_MULITHREADING
+						#pragma omp critical(intarna_omp_logOutput)
+#endif
+						{ VLOG(1) <<"computing accessibility for target '"<<parameters.getTargetSequences().at(targetNumber).getId()<<"'..."; }
+
+						targetAcc[targetNumber] = parameters.getTargetAccessibility(targetNumber);
+						INTARNA_CHECK_NOT_NULL(targetAcc.at(targetNumber),"target initialization failed");
+
+						// check if we have to warn about ambiguity
+						if (targetAcc.at(targetNumber)->getSequence().isAmbiguous()) {
+#if INTARNA_MULITHREADING
+							#pragma omp critical(intarna_omp_logOutput)
+#endif
+							{ LOG(INFO) <<"Sequence '"<<targetAcc.at(targetNumber)->getSequence().getId()
+									<<"' contains ambiguous IUPAC nucleotide encodings. These positions are ignored for interaction computation and replaced by 'N'.";}
+						}
+
+						// ES values if needed
+						targetES[targetNumber] = parameters.getEsValues( *(targetAcc.at(targetNumber)) );
+					}
+#if INTARNA_MULITHREADING
+				} catch (...) {
+					// release lock to avoid dead locks of other threads
+					omp_unset_lock( &(targetAccLock[targetNumber]) );
+					throw;
+				}
+				omp_unset_lock( &(targetAccLock[targetNumber]) );
+#endif
+
+				// sanity check
+				assert( queryAcc.at(queryNumber) != NULL );
+
+				// get energy computation handler for both sequences
+				InteractionEnergy* energy = parameters.getEnergyHandler( *(targetAcc.at(targetNumber)), *(queryAcc.at(queryNumber)), targetES.at(targetNumber), queryES.at(queryNumber) );
+				INTARNA_CHECK_NOT_NULL(energy,"energy initialization failed");
+
+				// whether or not the output is to be written in task order
+				bool isOrderedOutput = false;
+#if INTARNA_MULITHREADING
+				isOrderedOutput = (orderedOutput != NULL);
+#endif
+				// task-local output stream if the output is to be reordered
+				std::stringstream taskOut;
+				taskOut.copyfmt( parameters.getOutputStream() );
+
+				// get output/storage handler
+				// (candidates for the global top-K output are collected only)
+				OutputHandlerTopK * topKoutput = (topK == NULL) ? NULL : new OutputHandlerTopK( *topK );
+				OutputHandler * output = (topKoutput != NULL)
+						? topKoutput
+						: (isOrderedOutput
+							? parameters.getOutputHandler( *energy, taskOut )
+							: parameters.getOutputHandler( *energy ));
+				INTARNA_CHECK_NOT_NULL(output,"output handler initialization failed");
+
+				// check if we have to add separator for IntaRNA v1 output
+				// (done by the reorder buffer for ordered output)
+				const bool isOutputIntaRNA1 = dynamic_cast<OutputHandlerIntaRNA1*>(output) != NULL;
+				if (!isOrderedOutput && reportedInteractions > 0 && isOutputIntaRNA1) {
+					dynamic_cast<OutputHandlerIntaRNA1*>(output)->addSeparator( true );
+				}
+
+				// get interaction prediction handler
+				Predictor * predictor = parameters.getPredictor( *energy, *output );
+				INTARNA_CHECK_NOT_NULL(predictor,"predictor initialization failed");
+#if INTARNA_MULITHREADING
+				// enable parallel computation within the prediction if not
+				// already running in parallel (i.e. for a single task)
+				predictor->setThreads( parameters.getThreads() );
+#endif
+
+				// run prediction for all range combinations of this task
+				BOOST_FOREACH(const IndexRange & tRange, parameters.getTargetRanges(targetNumber,queryNumber)) {
+				BOOST_FOREACH(const IndexRange & qRange, parameters.getQueryRanges(queryNumber)) {
+
+					// skip ranges not covered by this task
+					if ( (tasks.at(taskNumber).tRange != NULL && tasks.at(taskNumber).tRange != &tRange)
+						|| (tasks.at(taskNumber).qRange != NULL && tasks.at(taskNumber).qRange != &qRange) )
+					{
+						continue;
+					}
+
+#if INTARNA_MULITHREADING
+					#pragma omp critical(intarna_omp_logOutput)
+#endif
+					{ VLOG(1) <<"predicting interactions for"
+							<<" target "<<targetAcc.at(targetNumber)->getSequence().getId()
+							<<" (range " <<tRange<<")"
+							<<" and"
+							<<" query "<<queryAcc.at(queryNumber)->getSequence().getId()
+							<<" (range " <<qRange<<")"
+							<<"..."; }
+
+					predictor->predict(	  tRange
+										, queryAcc.at(queryNumber)->getReversedIndexRange(qRange)
+										, parameters.getOutputConstraint( topK == NULL ? NULL : topK->getMaxEbound() )
+										);
+
+				} // target ranges
+				} // query ranges
+
+#if INTARNA_MULITHREADING
+				#pragma omp atomic update
+#endif
+				reportedInteractions += output->reported();
+#if INTARNA_MULITHREADING
+				// number of interactions of this task for the ordered output
+				const size_t taskReported = output->reported();
+#endif
+
+				// format and store candidates for the global top-K output
+				// (needs the sequences and energy handler of this task)
+				if (topKoutput != NULL) {
+					BOOST_FOREACH( const Interaction & candidate, topKoutput->getCandidates() ) {
+						// skip if not among the best interactions anymore
+						if (!(candidate.energy < topK->getMaxE())) {
+							continue;
+						}
+						std::stringstream candidateOut;
+						candidateOut.copyfmt( parameters.getOutputStream() );
+						{
+							OutputHandler * candidateOutput = parameters.getOutputHandler( *energy, candidateOut );
+							INTARNA_CHECK_NOT_NULL(candidateOutput,"output handler initialization failed");
+							candidateOutput->add( candidate );
+							// ensure output is flushed
+							 INTARNA_CLEANUP(candidateOutput);
+						}
+						topK->add( candidate.energy, candidateOut.str() );
+					}
+				}
+
+				// garbage collection
+				 INTARNA_CLEANUP(predictor);
+				 INTARNA_CLEANUP(output);
+				 INTARNA_CLEANUP(energy);
+
+#if INTARNA_MULITHREADING
+				// write output in task order (output handler is flushed)
+				if (isOrderedOutput) {
+					orderedOutput->add( taskNumber, taskOut.str(), taskReported
+							, (isOutputIntaRNA1 ? OutputHandlerIntaRNA1::getSeparator() : "") );
+				}
+#endif
+
+				// check if this was the last task for this target
+				size_t openTasks = 0;
+#if INTARNA_MULITHREADING
+				#pragma omp atomic capture
+#endif
+				openTasks = --(targetTasksOpen[targetNumber]);
+				if (openTasks == 0) {
+					// write accessibility to file if needed
+					parameters.writeTargetAccessibility( *(targetAcc.at(targetNumber)) );
+					// garbage collection
+					 INTARNA_CLEANUP(targetES[targetNumber]);
+					 INTARNA_CLEANUP(targetAcc[targetNumber]);
+				}
+
+#if INTARNA_MULITHREADING
+			////////////////////// exception handling ///////////////////////////
+			} catch (std::exception & e) {
+				// ensure exception handling for first failed thread only
+				#pragma omp critical(intarna_omp_exception)
+				{
+					if (!threadAborted) {
+						// store exception information
+						exceptionPtrDuringOmp = std::make_exception_ptr(e);
+						exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<(parameters.getTargetNumberOffset()+targetNumber) <<" #query " <<queryNumber <<" : "<<e.what();
+						// trigger abortion of all threads
+						threadAborted = true;
+						#pragma omp flush (threadAborted)
+						if (orderedOutput != NULL) {
+							orderedOutput->abort();
+						}
+					}
+				} // omp critical(intarna_omp_exception)
+			} catch (...) {
+				// ensure exception handling for first failed thread only
+				#pragma omp critical(intarna_omp_exception)
+				{
+					if (!threadAborted) {
+						// store exception information
+						exceptionPtrDuringOmp = std::current_exception();
+						exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<(parameters.getTargetNumberOffset()+targetNumber) <<" #query " <<queryNumber;
+						// trigger abortion of all threads
+						threadAborted = true;
+						#pragma omp flush (threadAborted)
+						if (orderedOutput != NULL) {
+							orderedOutput->abort();
+						}
+					}
+				} // omp critical(intarna_omp_exception)
+			}
+		} // if not threadAborted
+#endif
+	} // for tasks
+
+	// garbage collection of target accessibilities left due to abortion
+	for (size_t targetNumber=0; targetNumber < targetAcc.size(); targetNumber++) {
+		 INTARNA_CLEANUP(targetES[targetNumber]);
+		 INTARNA_CLEANUP(targetAcc[targetNumber]);
+	}
+#if INTARNA_MULITHREADING
+	 INTARNA_CLEANUP(orderedOutput);
+	for (size_t t=0; t<targetAccLock.size(); t++) {
+		omp_destroy_lock( &(targetAccLock[t]) );
+	}
+#endif
+}
+
 /////////////////////////////////////////////////////////////////////
 /**
  * program main entry
@@ -63,204 +468,67 @@ int main(int argc, char **argv){
 
 		// storage to avoid accessibility recomputation (init NULL)
 		std::vector< ReverseAccessibility * > queryAcc(parameters.getQuerySequences().size(), NULL);
-
-		// compute all query accessibilities to enable parallelization
-		// do serially since not all VRNA routines are threadsafe
-		for (size_t qi=0; qi<queryAcc.size(); qi++) {
-			// get accessibility handler
-			VLOG(1) <<"computing accessibility for query '"<<parameters.getQuerySequences().at(qi).getId()<<"'...";
-			Accessibility * queryAccOrig = parameters.getQueryAccessibility(qi);
-			INTARNA_CHECK_NOT_NULL(queryAccOrig,"query initialization failed");
-			// reverse indexing of target sequence for the computation
-			queryAcc[qi] = new ReverseAccessibility(*queryAccOrig);
-
-			// check if we have to warn about ambiguity
-			if (queryAccOrig->getSequence().isAmbiguous()) {
-				LOG(INFO) <<"Sequence '"<<queryAccOrig->getSequence().getId()
-						<<"' contains ambiguous nucleotide encodings. These positions are ignored for interaction computation.";
+		// according ES values (if needed) shared by all tasks of a query (init NULL)
+		std::vector< InteractionEnergyVrna::EsMatrix * > queryES(queryAcc.size(), NULL);
+
+		// query accessibilities read from STDIN have to be parsed in input order
+		// and are thus computed serially beforehand; all others are computed
+		// by the first prediction task that needs them
+		if (parameters.isQueryAccessibilityFromStdin()) {
+			for (size_t qi=0; qi<queryAcc.size(); qi++) {
+				queryAcc[qi] = computeQueryAccessibility( parameters, qi );
+				queryES[qi] = parameters.getEsValues( *(queryAcc.at(qi)) );
 			}
 		}
 
-		// check which loop to parallelize
-		const bool parallelizeTargetLoop = parameters.getTargetSequences().size() > 1;
-		const bool parallelizeQueryLoop = !parallelizeTargetLoop && parameters.getQuerySequences().size() > 1;
-
+		// if requested, only the globally best interactions over all tasks are
+		// reported; their energy bound is used to prune the predictions
+		OutputTopK * topK = NULL;
+		if (parameters.getOutTopK() > 0) {
+			topK = new OutputTopK( parameters.getOutTopK() );
+		}
 
-		// run prediction for all pairs of sequences
-		// first: iterate over all target sequences
 #if INTARNA_MULITHREADING
+		// one lock per query to compute its accessibility only once
+		std::vector< omp_lock_t > queryAccLock( queryAcc.size() );
+		for (size_t q=0; q<queryAccLock.size(); q++) {
+			omp_init_lock( &(queryAccLock[q]) );
+		}
 		// OMP shared variables to enable exception forwarding from within OMP parallelized for loop
 		bool threadAborted = false;
 		std::exception_ptr exceptionPtrDuringOmp = NULL;
 		std::stringstream exceptionInfoDuringOmp;
-		// parallelize this loop if possible; if not -> parallelize the query-loop
-		# pragma omp parallel for schedule(dynamic) num_threads( parameters.getThreads() ) shared(queryAcc,reportedInteractions,exceptionPtrDuringOmp,exceptionInfoDuringOmp) if(parallelizeTargetLoop)
 #endif
-		for ( size_t targetNumber = 0; targetNumber < parameters.getTargetSequences().size(); ++targetNumber )
-		{
-#if INTARNA_MULITHREADING
-			#pragma omp flush (threadAborted)
-			// explicit try-catch-block due to missing OMP exception forwarding
-			if (!threadAborted) {
-				try {
-					// get target accessibility handler
-					#pragma omp critical(intarna_omp_logOutput)
-#endif
-					{ VLOG(1) <<"computing accessibility for target '"<<parameters.getTargetSequences().at(targetNumber).getId()<<"'..."; }
-
-					// VRNA not completely threadsafe ...
-					Accessibility * targetAcc = parameters.getTargetAccessibility(targetNumber);
-					INTARNA_CHECK_NOT_NULL(targetAcc,"target initialization failed");
-
-					// check if we have to warn about ambiguity
-					if (targetAcc->getSequence().isAmbiguous()) {
-#if INTARNA_MULITHREADING
-						#pragma omp critical(intarna_omp_logOutput)
-#endif
-						{ LOG(INFO) <<"Sequence '"<<targetAcc->getSequence().getId()
-								<<"' contains ambiguous IUPAC nucleotide encodings. These positions are ignored for interaction computation and replaced by 'N'.";}
-					}
-
-					// second: iterate over all query sequences
-#if INTARNA_MULITHREADING
-					// this parallelization should only be enabled if the outer target-loop is not parallelized
-					# pragma omp parallel for schedule(dynamic) num_threads( parameters.getThreads() ) shared(queryAcc,reportedInteractions,exceptionPtrDuringOmp,exceptionInfoDuringOmp,targetAcc,targetNumber) if(parallelizeQueryLoop)
-#endif
-					for ( size_t queryNumber = 0; queryNumber < parameters.getQuerySequences().size(); ++queryNumber )
-					{
-#if INTARNA_MULITHREADING
-						#pragma omp flush (threadAborted)
-						// explicit try-catch-block due to missing OMP exception forwarding
-						if (!threadAborted) {
-							try {
-#endif
-								// sanity check
-								assert( queryAcc.at(queryNumber) != NULL );
-
-								// get energy computation handler for both sequences
-								InteractionEnergy* energy = parameters.getEnergyHandler( *targetAcc, *(queryAcc.at(queryNumber)) );
-								INTARNA_CHECK_NOT_NULL(energy,"energy initialization failed");
-
-								// get output/storage handler
-								OutputHandler * output = parameters.getOutputHandler( *energy );
-								INTARNA_CHECK_NOT_NULL(output,"output handler initialization failed");
-
-								// check if we have to add separator for IntaRNA v1 output
-								if (reportedInteractions > 0 && dynamic_cast<OutputHandlerIntaRNA1*>(output) != NULL) {
-									dynamic_cast<OutputHandlerIntaRNA1*>(output)->addSeparator( true );
-								}
-
-								// get interaction prediction handler
-								Predictor * predictor = parameters.getPredictor( *energy, *output );
-								INTARNA_CHECK_NOT_NULL(predictor,"predictor initialization failed");
-
-								// run prediction for all range combinations
-								BOOST_FOREACH(const IndexRange & tRange, parameters.getTargetRanges(targetNumber)) {
-								BOOST_FOREACH(const IndexRange & qRange, parameters.getQueryRanges(queryNumber)) {
 
+		// process all targets at once or, if streamed, chunk-wise such that
+		// only the sequences of the current target chunk are kept in memory
+		do {
+			predictTargetChunk( parameters, reportedInteractions, queryAcc, queryES, topK
 #if INTARNA_MULITHREADING
-									#pragma omp critical(intarna_omp_logOutput)
+					, queryAccLock, threadAborted, exceptionPtrDuringOmp, exceptionInfoDuringOmp
 #endif
-									{ VLOG(1) <<"predicting interactions for"
-											<<" target "<<targetAcc->getSequence().getId()
-											<<" (range " <<tRange<<")"
-											<<" and"
-											<<" query "<<queryAcc.at(queryNumber)->getSequence().getId()
-											<<" (range " <<qRange<<")"
-											<<"..."; }
-
-									predictor->predict(	  tRange
-														, queryAcc.at(queryNumber)->getReversedIndexRange(qRange)
-														, parameters.getOutputConstraint()
-														);
-
-								} // target ranges
-								} // query ranges
-
-#if INTARNA_MULITHREADING
-								#pragma omp atomic update
-#endif
-								reportedInteractions += output->reported();
-
-								// garbage collection
-								 INTARNA_CLEANUP(predictor);
-								 INTARNA_CLEANUP(output);
-								 INTARNA_CLEANUP(energy);
-
+					);
 #if INTARNA_MULITHREADING
-							////////////////////// exception handling ///////////////////////////
-							} catch (std::exception & e) {
-								// ensure exception handling for first failed thread only
-								#pragma omp critical(intarna_omp_exception)
-								{
-									if (!threadAborted) {
-										// store exception information
-										exceptionPtrDuringOmp = std::make_exception_ptr(e);
-										exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber <<" #query " <<queryNumber <<" : "<<e.what();
-										// trigger abortion of all threads
-										threadAborted = true;
-										#pragma omp flush (threadAborted)
-									}
-								} // omp critical(intarna_omp_exception)
-							} catch (...) {
-								// ensure exception handling for first failed thread only
-								#pragma omp critical(intarna_omp_exception)
-								{
-									if (!threadAborted) {
-										// store exception information
-										exceptionPtrDuringOmp = std::current_exception();
-										exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber <<" #query " <<queryNumber;
-										// trigger abortion of all threads
-										threadAborted = true;
-										#pragma omp flush (threadAborted)
-									}
-								} // omp critical(intarna_omp_exception)
-							}
-						} // if not threadAborted
+			// stop processing of further chunks
+			if (threadAborted) {
+				break;
+			}
 #endif
-					} // for queries
-
-					// write accessibility to file if needed
-					parameters.writeTargetAccessibility( *targetAcc );
-
-					// garbage collection
-					 INTARNA_CLEANUP(targetAcc);
+		} while ( parameters.parseNextTargetChunk() );
 
 #if INTARNA_MULITHREADING
-				////////////////////// exception handling ///////////////////////////
-				} catch (std::exception & e) {
-					// ensure exception handling for first failed thread only
-					#pragma omp critical(intarna_omp_exception)
-					{
-						if (!threadAborted) {
-							// store exception information
-							exceptionPtrDuringOmp = std::make_exception_ptr(e);
-							exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber <<" : "<<e.what();
-							// trigger abortion of all threads
-							threadAborted = true;
-							#pragma omp flush (threadAborted)
-						}
-					} // omp critical(intarna_omp_exception)
-				} catch (...) {
-					// ensure exception handling for first failed thread only
-					#pragma omp critical(intarna_omp_exception)
-					{
-						if (!threadAborted) {
-							// store exception information
-							exceptionPtrDuringOmp = std::current_exception();
-							exceptionInfoDuringOmp <<" #thread "<<omp_get_thread_num() <<" #target "<<targetNumber;
-							// trigger abortion of all threads
-							threadAborted = true;
-							#pragma omp flush (threadAborted)
-						}
-					} // omp critical(intarna_omp_exception)
-				}
-			} // if not threadAborted
+		for (size_t q=0; q<queryAccLock.size(); q++) {
+			omp_destroy_lock( &(queryAccLock[q]) );
+		}
 #endif
-		} // for targets
 
 		// garbage collection
 		for (size_t queryNumber=0; queryNumber < queryAcc.size(); queryNumber++) {
+			 INTARNA_CLEANUP(queryES[queryNumber]);
+			// skip queries not computed due to abortion
+			if (queryAcc[queryNumber] == NULL) {
+				continue;
+			}
 			// this is a hack to cleanup the original accessibility object
 			Accessibility* queryAccOrig = &(const_cast<Accessibility&>(queryAcc[queryNumber]->getAccessibilityOrigin()) );
 			// write accessibility to file if needed
@@ -281,6 +549,12 @@ int main(int argc, char **argv){
 		}
 #endif
 
+		// write the global top-K output sorted by energy
+		if (topK != NULL) {
+			topK->write( parameters.getOutputStream(), parameters.getOutputSeparator() );
+			 INTARNA_CLEANUP(topK);
+		}
+
 	////////////////////// exception handling ///////////////////////////
 	} catch (std::exception & e) {
 		LOG(WARNING) <<"Exception raised : " <<e.what() <<"\n\n"
@@ -0,0 +1,121 @@
+#include "IntaRNA/general.h"
+
+#include <iostream>
+#include <fstream>
+#include <exception>
+
+#include <boost/program_options.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "IntaRNA/OutputHandlerBinary.h"
+#include "IntaRNA/OutputHandlerCsv.h"
+
+// initialize logging for binary
+INITIALIZE_EASYLOGGINGPP
+
+using namespace IntaRNA;
+
+/////////////////////////////////////////////////////////////////////
+/**
+ * Converts the binary output of IntaRNA (--outMode=B) into CSV format
+ * as produced by --outMode=C.
+ */
+int main(int argc, char **argv){
+
+	try {
+
+		// set overall logging style
+		el::Loggers::reconfigureAllLoggers(el::ConfigurationType::Format, std::string("# %level : %msg"));
+		el::Loggers::reconfigureAllLoggers(el::ConfigurationType::ToFile, std::string("false"));
+		el::Loggers::addFlag(el::LoggingFlag::DisableApplicationAbortOnFatalLog);
+
+		using namespace boost::program_options;
+
+		std::string inName, outName, outCsvCols, outCsvSep;
+
+		options_description opts("\nIntaRNAbin2csv converts binary IntaRNA output (--outMode=B) into CSV format.\n\nThe following program arguments are supported");
+		opts.add_options()
+			("in,i"
+				, value<std::string>(&inName)->default_value("STDIN")
+				, "binary IntaRNA output file to convert or STDIN to read from standard input")
+			("out,o"
+				, value<std::string>(&outName)->default_value("STDOUT")
+				, "CSV file to write or STDOUT/STDERR to write to the respective output stream")
+			("outCsvCols"
+				, value<std::string>(&outCsvCols)->default_value("id1,start1,end1,id2,start2,end2,subseqDP,hybridDP,E")
+				, std::string("comma separated list of CSV column IDs to print, see IntaRNA --outCsvCols. An empty argument prints all possible columns from the following list: "
+						+ boost::replace_all_copy(OutputHandlerCsv::list2string(OutputHandlerCsv::string2list("")), ",", ", ")+".").c_str())
+			("outCsvSep"
+				, value<std::string>(&outCsvSep)->default_value(";")
+				, "the column separator to be used in the CSV output")
+			("noHeader", "do not print the CSV header line")
+			("version", "print version")
+			("help,h", "show this help page")
+			;
+
+		variables_map vm;
+		try {
+			store( parse_command_line(argc, argv, opts), vm );
+			notify( vm );
+		} catch (error& e) {
+			LOG(ERROR) <<e.what() << " : run with '--help' for allowed arguments";
+			return 1;
+		}
+
+		if (vm.count("help")) {
+			std::cout <<opts <<"\n";
+			return 0;
+		}
+		if (vm.count("version")) {
+			std::cout <<INTARNA_PACKAGE_STRING << "\n";
+			return 0;
+		}
+
+		// get columns to print
+		OutputHandlerCsv::ColTypeList colOrder;
+		try {
+			colOrder = OutputHandlerCsv::string2list( outCsvCols );
+		} catch (std::exception & e) {
+			LOG(ERROR) <<e.what();
+			return 1;
+		}
+
+		// open input
+		std::ifstream inFile;
+		std::istream * in = & std::cin;
+		if (!boost::iequals(inName,"STDIN")) {
+			inFile.open( inName.c_str(), std::ios_base::in | std::ios_base::binary );
+			if (!inFile.is_open()) {
+				LOG(ERROR) <<"could not open input file --in='"<<inName<<"' for reading";
+				return 1;
+			}
+			in = & inFile;
+		}
+
+		// open output
+		std::ostream * out = newOutputStream( outName );
+		if (out == NULL) {
+			LOG(ERROR) <<"could not open output file --out='"<<outName<<"' for writing";
+			return 1;
+		}
+
+		// convert
+		try {
+			OutputHandlerBinary::writeCsv( *in, *out, colOrder, outCsvSep, vm.count("noHeader") == 0 );
+		} catch (std::exception & e) {
+			deleteOutputStream( out );
+			LOG(ERROR) <<e.what();
+			return 1;
+		}
+		deleteOutputStream( out );
+
+	} catch (std::exception & e) {
+		LOG(WARNING) <<"Exception raised : " <<e.what() <<"\n\n"
+			<<"  ==> Please report to the IntaRNA development team! Thanks!\n";
+		return -1;
+	}
+
+	// all went fine
+	return 0;
+}
+
@@ -0,0 +1,64 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include <cstdio>
+
+#include <boost/filesystem.hpp>
+
+#include "IntaRNA/AccessibilityFromCache.h"
+#include "IntaRNA/AccessibilityBasePair.h"
+
+using namespace IntaRNA;
+
+
+TEST_CASE( "AccessibilityFromCache", "[AccessibilityFromCache]" ) {
+
+	RnaSequence rna("test", "GGUCCACGUCCAAUCGAUCG");
+
+	const std::string cacheDir = boost::filesystem::temp_directory_path().string();
+	const std::string key = "seq="+rna.asString()+";test";
+	const std::string cacheFile = AccessibilityFromCache::getCacheFileName( cacheDir, key );
+
+	SECTION("cache file name") {
+		// same key same name
+		REQUIRE( AccessibilityFromCache::getCacheFileName( cacheDir, key ) == cacheFile );
+		// different key different name
+		REQUIRE( AccessibilityFromCache::getCacheFileName( cacheDir, key+"2" ) != cacheFile );
+	}
+
+	SECTION("write and map cache") {
+
+		const size_t maxLength = 8;
+		AccessibilityBasePair acc( rna, maxLength, NULL );
+
+		AccessibilityFromCache::writeCache( acc, cacheFile, key );
+
+		// check validity
+		REQUIRE( AccessibilityFromCache::isValidCache( cacheFile, key, rna.size(), acc.getMaxLength() ) );
+		REQUIRE_FALSE( AccessibilityFromCache::isValidCache( cacheFile, key+"2", rna.size(), acc.getMaxLength() ) );
+		REQUIRE_FALSE( AccessibilityFromCache::isValidCache( cacheFile, key, rna.size()+1, acc.getMaxLength() ) );
+		REQUIRE_FALSE( AccessibilityFromCache::isValidCache( cacheFile, key, rna.size(), acc.getMaxLength()+1 ) );
+		REQUIRE_FALSE( AccessibilityFromCache::isValidCache( cacheFile+".none", key, rna.size(), acc.getMaxLength() ) );
+
+		{
+			AccessibilityFromCache accCache( rna, maxLength, NULL, cacheFile, key );
+
+			REQUIRE( accCache.getMaxLength() == acc.getMaxLength() );
+
+			// check identical ED values within maximal length
+			for (size_t i=0; i<rna.size(); i++) {
+			for (size_t j=i; j<std::min(rna.size(),i+acc.getMaxLength()); j++) {
+				REQUIRE( accCache.getED(i,j) == acc.getED(i,j) );
+			}
+			}
+		}
+
+		// wrong key
+		REQUIRE_THROWS( AccessibilityFromCache( rna, maxLength, NULL, cacheFile, key+"2" ) );
+
+		std::remove( cacheFile.c_str() );
+	}
+
+}
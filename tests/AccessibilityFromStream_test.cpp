@@ -9,6 +9,13 @@ using namespace IntaRNA;
 
 const std::string seq = "uaugacugacuggcgcgcguacugacguga";
 
+//! tolerance of ED values in kcal/mol due to the energy resolution
+#if INTARNA_INTEGER_ENERGY
+const double edTolerance = 0.005;
+#else
+const double edTolerance = 0.0;
+#endif
+
 const std::string accString =
 "#unpaired probabilities\n"
 " #i$	l=1	2	3	4	5	6	7	8	9	10	\n"
@@ -65,10 +72,10 @@ TEST_CASE( "AccessibilityFromStream", "[AccessibilityFromStream]" ) {
 //		std::cerr <<"ED data:\n" <<acc;
 
 		// check elements
-		REQUIRE( std::exp( - acc.getED(29, 29) ) > 0.998 );
-		REQUIRE( std::exp( - acc.getED(29, 29) ) < 0.999 );
-		REQUIRE( std::exp( - acc.getED(20, 29) ) > 0.0006 );
-		REQUIRE( std::exp( - acc.getED(20, 29) ) < 0.0007 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(29, 29)) + edTolerance ) > 0.998 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(29, 29)) - edTolerance ) < 0.999 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(20, 29)) + edTolerance ) > 0.0006 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(20, 29)) - edTolerance ) < 0.0007 );
 	}
 
 	SECTION("Pu_RNAplfold output reparsed") {
@@ -80,10 +87,10 @@ TEST_CASE( "AccessibilityFromStream", "[AccessibilityFromStream]" ) {
 		AccessibilityFromStream acc( rna, 10, NULL, accStream, AccessibilityFromStream::Pu_RNAplfold_Text, 1.0 );
 
 		// check elements
-		REQUIRE( std::exp( - acc.getED(29, 29) ) > 0.998 );
-		REQUIRE( std::exp( - acc.getED(29, 29) ) < 0.999 );
-		REQUIRE( std::exp( - acc.getED(20, 29) ) > 0.0006 );
-		REQUIRE( std::exp( - acc.getED(20, 29) ) < 0.0007 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(29, 29)) + edTolerance ) > 0.998 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(29, 29)) - edTolerance ) < 0.999 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(20, 29)) + edTolerance ) > 0.0006 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(20, 29)) - edTolerance ) < 0.0007 );
 
 		std::stringstream accStream2;
 		acc.writeRNAplfold_Pu_text( accStream2, 1.0 );
@@ -92,10 +99,10 @@ TEST_CASE( "AccessibilityFromStream", "[AccessibilityFromStream]" ) {
 		AccessibilityFromStream acc2( rna, 10, NULL, accStream2, AccessibilityFromStream::Pu_RNAplfold_Text, 1.0 );
 
 		// check elements
-		REQUIRE( std::exp( - acc2.getED(29, 29) ) > 0.998 );
-		REQUIRE( std::exp( - acc2.getED(29, 29) ) < 0.999 );
-		REQUIRE( std::exp( - acc2.getED(20, 29) ) > 0.0006 );
-		REQUIRE( std::exp( - acc2.getED(20, 29) ) < 0.0007 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc2.getED(29, 29)) + edTolerance ) > 0.998 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc2.getED(29, 29)) - edTolerance ) < 0.999 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc2.getED(20, 29)) + edTolerance ) > 0.0006 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc2.getED(20, 29)) - edTolerance ) < 0.0007 );
 
 	}
 
@@ -108,10 +115,10 @@ TEST_CASE( "AccessibilityFromStream", "[AccessibilityFromStream]" ) {
 		AccessibilityFromStream acc( rna, 10, NULL, accStream, AccessibilityFromStream::Pu_RNAplfold_Text, 1.0 );
 
 		// check elements
-		REQUIRE( std::exp( - acc.getED(29, 29) ) > 0.998 );
-		REQUIRE( std::exp( - acc.getED(29, 29) ) < 0.999 );
-		REQUIRE( std::exp( - acc.getED(20, 29) ) > 0.0006 );
-		REQUIRE( std::exp( - acc.getED(20, 29) ) < 0.0007 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(29, 29)) + edTolerance ) > 0.998 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(29, 29)) - edTolerance ) < 0.999 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(20, 29)) + edTolerance ) > 0.0006 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc.getED(20, 29)) - edTolerance ) < 0.0007 );
 
 		std::stringstream accStream2;
 		acc.writeRNAplfold_ED_text( accStream2 );
@@ -120,10 +127,10 @@ TEST_CASE( "AccessibilityFromStream", "[AccessibilityFromStream]" ) {
 		AccessibilityFromStream acc2( rna, 10, NULL, accStream2, AccessibilityFromStream::ED_RNAplfold_Text, 1.0 );
 
 		// check elements
-		REQUIRE( std::exp( - acc2.getED(29, 29) ) > 0.998 );
-		REQUIRE( std::exp( - acc2.getED(29, 29) ) < 0.999 );
-		REQUIRE( std::exp( - acc2.getED(20, 29) ) > 0.0006 );
-		REQUIRE( std::exp( - acc2.getED(20, 29) ) < 0.0007 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc2.getED(29, 29)) + edTolerance ) > 0.998 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc2.getED(29, 29)) - edTolerance ) < 0.999 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc2.getED(20, 29)) + edTolerance ) > 0.0006 );
+		REQUIRE( std::exp( - E_2_Ekcal(acc2.getED(20, 29)) - edTolerance ) < 0.0007 );
 
 	}
 
@@ -0,0 +1,117 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include <vector>
+
+#include "IntaRNA/AccessibilityVrna.h"
+#include "IntaRNA/VrnaHandler.h"
+
+#if INTARNA_MULITHREADING
+	#include <omp.h>
+#endif
+
+using namespace IntaRNA;
+
+
+TEST_CASE( "AccessibilityVrna", "[AccessibilityVrna]" ) {
+
+	// setup sequences of different length
+	std::vector< RnaSequence > rnas;
+	rnas.push_back( RnaSequence("s1", "GGUCCACGUCCAAUCGAUCGAUCGUAGCUAGCUAGCUAGCUGAUCGAUGC") );
+	rnas.push_back( RnaSequence("s2", "AUGCUAGCUAGCUAGCGGCGCGAUAUAUCGCGCGAUCGAUCGACUAGCUAGCAUCGAUCG") );
+	rnas.push_back( RnaSequence("s3", "CCCCGGGGAAAAUUUUCCCCGGGGAAAAUUUUCGAUCGAUGCUAGCUAGC") );
+	rnas.push_back( RnaSequence("s4", "UUAGCUAGCGAUCGAUCGAUGCUAGCUAGCUAGCGCGGCGCAUAUAUGCGAUCGAUCGAUGCAUCG") );
+
+	VrnaHandler vrnaHandler;
+
+	const size_t maxLength = 20;
+	const size_t plFoldW = 40;
+
+	// serial computation as reference
+	std::vector< AccessibilityVrna * > accSerial( rnas.size(), NULL );
+	for (size_t s=0; s<rnas.size(); s++) {
+		accSerial[s] = new AccessibilityVrna( rnas.at(s), maxLength, NULL, vrnaHandler, plFoldW );
+	}
+
+	SECTION("concurrent computation") {
+
+		int maxThreads = 1;
+#if INTARNA_MULITHREADING
+		maxThreads = omp_get_max_threads();
+#endif
+
+		// compute all accessibilities for increasing number of threads
+		for (int threads = 1; threads <= maxThreads; threads *= 2) {
+
+			std::vector< AccessibilityVrna * > accParallel( rnas.size(), NULL );
+#if INTARNA_MULITHREADING
+			#pragma omp parallel for schedule(dynamic) num_threads(threads)
+#endif
+			for (int s=0; s<(int)rnas.size(); s++) {
+				accParallel[s] = new AccessibilityVrna( rnas.at(s), maxLength, NULL, vrnaHandler, plFoldW );
+			}
+
+			// check identical ED values
+			for (size_t s=0; s<rnas.size(); s++) {
+				for (size_t i=0; i<rnas.at(s).size(); i++) {
+				for (size_t j=i; j<std::min(rnas.at(s).size(),i+maxLength); j++) {
+					REQUIRE( accParallel.at(s)->getED(i,j) == accSerial.at(s)->getED(i,j) );
+				}
+				}
+				 INTARNA_CLEANUP(accParallel[s]);
+			}
+		}
+	}
+
+	// cleanup
+	for (size_t s=0; s<accSerial.size(); s++) {
+		 INTARNA_CLEANUP(accSerial[s]);
+	}
+
+}
+
+
+TEST_CASE( "AccessibilityVrna reference values", "[AccessibilityVrna]" ) {
+
+	VrnaHandler vrnaHandler;
+
+	// tolerance in kcal/mol (covers rounding of integer energies)
+	const Ekcal_type tolerance = 0.01;
+
+	SECTION("no base pair possible : all ED values are 0") {
+		// A and C nucleotides only : no canonical base pairs
+		RnaSequence rna("noPairs", "ACACCAACACAACCACACAA");
+		AccessibilityVrna acc( rna, 0, NULL, vrnaHandler, 40 );
+		for (size_t i=0; i<rna.size(); i++) {
+		for (size_t j=i; j<rna.size(); j++) {
+			REQUIRE( std::abs( E_2_Ekcal(acc.getED(i,j)) ) < tolerance );
+		}
+		}
+	}
+
+	SECTION("stable hairpin : plausible ED values") {
+		// G-C stem of length 8 with unpairable AAAA loop
+		RnaSequence rna("hairpin", "GGGGGGGGAAAACCCCCCCC");
+		AccessibilityVrna acc( rna, 0, NULL, vrnaHandler, 40 );
+		// the loop can not pair and is always accessible
+		REQUIRE( std::abs( E_2_Ekcal(acc.getED(8,11)) ) < tolerance );
+		// opening the stem is expensive
+		REQUIRE( E_2_Ekcal(acc.getED(0,7)) > 5 );
+		REQUIRE( E_2_Ekcal(acc.getED(12,19)) > 5 );
+		// ED values are non-negative and do not decrease for enclosing regions
+		for (size_t i=0; i<rna.size(); i++) {
+		for (size_t j=i; j<rna.size(); j++) {
+			REQUIRE( E_2_Ekcal(acc.getED(i,j)) > -tolerance );
+			if (j+1 < rna.size()) {
+				REQUIRE( E_2_Ekcal(acc.getED(i,j)) < E_2_Ekcal(acc.getED(i,j+1)) + tolerance );
+			}
+			if (i > 0) {
+				REQUIRE( E_2_Ekcal(acc.getED(i,j)) < E_2_Ekcal(acc.getED(i-1,j)) + tolerance );
+			}
+		}
+		}
+	}
+
+}
@@ -0,0 +1,63 @@
+
+#include "catch.hpp"
+#include "TestRandom.h"
+
+#undef NDEBUG
+
+#include "IntaRNA/ComplementarityMask.h"
+
+#include <string>
+#include <vector>
+
+using namespace IntaRNA;
+
+TEST_CASE( "ComplementarityMask", "[ComplementarityMask]" ) {
+
+	// random sequences including ambiguous nucleotides
+	TestRandom rnd( 23 );
+	std::string s1, s2;
+	for (size_t i=0; i<200; i++) {
+		const char c1 = rnd.nextChar( "ACGUN" );
+		if (i < 30) s1.push_back( c1 );
+		s2.push_back( rnd.nextChar( "ACGUN" ) );
+	}
+	RnaSequence r1("r1",s1);
+	RnaSequence r2("r2",s2);
+
+	ComplementarityMask mask( r1, r2 );
+
+	SECTION("sizes") {
+		REQUIRE( mask.size1() == r1.size() );
+		REQUIRE( mask.size2() == r2.size() );
+		REQUIRE( ComplementarityMask::getBlockNumber(0) == 0 );
+		REQUIRE( ComplementarityMask::getBlockNumber(1) == 1 );
+		REQUIRE( ComplementarityMask::getBlockNumber(64) == 1 );
+		REQUIRE( ComplementarityMask::getBlockNumber(65) == 2 );
+	}
+
+	SECTION("single complementarity checks") {
+		for (size_t i1=0; i1<r1.size(); i1++) {
+		for (size_t i2=0; i2<r2.size(); i2++) {
+			REQUIRE( mask.areComplementary(i1,i2) == RnaSequence::areComplementary(r1,r2,i1,i2) );
+		}
+		}
+	}
+
+	SECTION("row extraction") {
+		// ranges within a block, on block borders and spanning multiple blocks
+		const size_t ranges[][2] = { {0,199}, {0,63}, {0,64}, {5,17}, {60,70}, {63,191}, {64,127}, {130,199}, {199,199} };
+		for (size_t r=0; r<9; r++) {
+			const size_t i2min = ranges[r][0], i2max = ranges[r][1];
+			// fill with set bits to check the unset tail
+			std::vector< ComplementarityMask::Block > row( ComplementarityMask::getBlockNumber(i2max-i2min+1), ~((ComplementarityMask::Block)0) );
+			for (size_t i1=0; i1<r1.size(); i1++) {
+				mask.getRow( i1, i2min, i2max, &(row[0]) );
+				for (size_t k=0; k<row.size()*ComplementarityMask::BLOCK_BITS; k++) {
+					const bool bit = (row[k/ComplementarityMask::BLOCK_BITS] >> (k%ComplementarityMask::BLOCK_BITS)) & 1;
+					REQUIRE( bit == (i2min+k <= i2max && RnaSequence::areComplementary(r1,r2,i1,i2min+k)) );
+				}
+			}
+		}
+	}
+
+}
@@ -0,0 +1,99 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/FastaFileMapped.h"
+
+#include <cstdio>
+#include <fstream>
+
+#include <boost/filesystem.hpp>
+
+using namespace IntaRNA;
+
+TEST_CASE( "FastaFileMapped", "[FastaFileMapped]" ) {
+
+	const std::string fileName = ( boost::filesystem::temp_directory_path()
+			/ boost::filesystem::unique_path("FastaFileMapped_test_%%%%-%%%%.fa") ).string();
+	const std::string indexName = fileName+".fai";
+
+	// write test file
+	{
+		std::ofstream out( fileName.c_str() );
+		out <<">s1 first sequence\n"
+			<<"ACGUA\n"
+			<<"CGUAC\n"
+			<<"GU\n"
+			<<"\n"
+			<<">s2\n"
+			<<"  acgu \t\n"
+			<<"ACG\n"
+			<<"\tUUUU\n"
+			<<">s3\n"
+			<<"NNACG";
+	}
+
+	SECTION("scanned index") {
+		std::remove( indexName.c_str() );
+		FastaFileMapped fasta( fileName );
+		REQUIRE_FALSE( fasta.isIndexFromFile() );
+		REQUIRE( fasta.size() == 3 );
+		REQUIRE( fasta.getName(0) == "s1" );
+		REQUIRE( fasta.getId(0) == "s1 first sequence" );
+		REQUIRE( fasta.getIndex("s2") == 1 );
+		REQUIRE( fasta.getIndex("s1 first sequence") == fasta.size() );
+		REQUIRE( fasta.getLength(0) == 12 );
+		REQUIRE( fasta.getLength(1) == 11 );
+		// regular line layout
+		REQUIRE( fasta.getSequence(0).asString() == "ACGUACGUACGU" );
+		REQUIRE( fasta.getSequence(0).getId() == "s1 first sequence" );
+		// irregular line layout
+		REQUIRE( fasta.getSequence(1).asString() == "ACGUACGUUUU" );
+		// no trailing newline
+		REQUIRE( fasta.getSequence(2).asString() == "NNACG" );
+		REQUIRE_THROWS( fasta.getSequence(3) );
+	}
+
+	SECTION("index file") {
+		{
+			std::ofstream out( indexName.c_str() );
+			out <<"s3\t5\t62\t5\t6\n"
+				<<"s1\t12\t19\t5\t6\n";
+		}
+		FastaFileMapped fasta( fileName );
+		REQUIRE( fasta.isIndexFromFile() );
+		REQUIRE( fasta.size() == 2 );
+		REQUIRE( fasta.getIndex("s1") == 1 );
+		REQUIRE( fasta.getSequence(1).asString() == "ACGUACGUACGU" );
+		REQUIRE( fasta.getSequence(1).getId() == "s1 first sequence" );
+		REQUIRE( fasta.getSequence(0).asString() == "NNACG" );
+		// ignore index
+		REQUIRE( FastaFileMapped( fileName, false ).size() == 3 );
+
+		// index not matching the file
+		{
+			std::ofstream out( indexName.c_str() );
+			out <<"s1\t12\t18\t5\t6\n";
+		}
+		REQUIRE_THROWS( FastaFileMapped( fileName.c_str() ) );
+		std::remove( indexName.c_str() );
+	}
+
+	SECTION("enclosed whitespaces") {
+		const std::string spaceName = fileName+".space.fa";
+		{
+			std::ofstream out( spaceName.c_str() );
+			out <<">s1\n"
+				<<"ACG UA\n";
+		}
+		REQUIRE_THROWS( FastaFileMapped( spaceName.c_str() ) );
+		std::remove( spaceName.c_str() );
+	}
+
+	SECTION("missing file") {
+		REQUIRE_THROWS( FastaFileMapped( fileName+".missing.fa" ) );
+	}
+
+	std::remove( fileName.c_str() );
+}
@@ -179,5 +179,56 @@ TEST_CASE( "IndexRangeList", "[IndexRangeList]" ) {
 
 	}
 
+	SECTION("check dense lookup") {
+
+		// create list
+		rangeList.insert(IndexRange(4,8));
+		rangeList.insert(IndexRange(1,2));
+		rangeList.insert(IndexRange(10,10));
+		rangeList.insert(IndexRange(11,13));
+
+		IndexRangeList dense(rangeList);
+		REQUIRE_FALSE( dense.hasDenseLookup() );
+		dense.enableDenseLookup();
+		REQUIRE( dense.hasDenseLookup() );
+		REQUIRE( dense == rangeList );
+
+		// compare with binary search based checks
+		for (size_t i=0; i<16; i++) {
+			REQUIRE( dense.covers(i) == rangeList.covers(i) );
+			for (size_t j=i; j<16; j++) {
+				REQUIRE( dense.covers(i,j) == rangeList.covers(i,j) );
+			}
+		}
+		REQUIRE_FALSE( dense.covers(10,11) );
+		REQUIRE( dense.covers(11,13) );
+
+		// updates
+		dense.insert(IndexRange(15,20));
+		REQUIRE( dense.covers(20) );
+		REQUIRE( dense.covers(16,19) );
+		REQUIRE_FALSE( dense.covers(21) );
+		dense.erase( dense.begin() );
+		REQUIRE_FALSE( dense.covers(1) );
+		REQUIRE( dense.covers(4) );
+
+		// shift and reverse
+		REQUIRE( dense.shift(-1,30).hasDenseLookup() );
+		REQUIRE( dense.shift(-1,30).covers(19) );
+		REQUIRE_FALSE( dense.shift(-1,30).covers(20) );
+		dense.reverse(21);
+		REQUIRE( toString(dense) == "0-5,7-9,10-10,12-16" );
+		REQUIRE( dense.covers(0,5) );
+		REQUIRE_FALSE( dense.covers(6) );
+		REQUIRE( dense.covers(16) );
+		REQUIRE_FALSE( dense.covers(17) );
+
+		// reset
+		dense.clear();
+		REQUIRE_FALSE( dense.covers(0) );
+		REQUIRE( dense.hasDenseLookup() );
+
+	}
+
 }
 
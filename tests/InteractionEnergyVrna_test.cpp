@@ -0,0 +1,58 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/InteractionEnergyVrna.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/VrnaHandler.h"
+
+using namespace IntaRNA;
+
+TEST_CASE( "InteractionEnergyVrna", "[InteractionEnergyVrna]" ) {
+
+	RnaSequence rna1("test1","GGUCCACGUCCAAUCGAUCGAUCGUAGCUAGCUAGCUAGCNGAUCGAUGC");
+	RnaSequence rna2("test2","AUGCUAGCUAGCUAGCGGCGCGAUAUAUCGCGCGAUCGAUCGACUAGC");
+
+	AccessibilityDisabled acc1(rna1,0,NULL);
+	AccessibilityDisabled acc2(rna2,0,NULL);
+	ReverseAccessibility rAcc2(acc2);
+
+	VrnaHandler vrnaHandler;
+
+	const size_t maxLoop1 = 7, maxLoop2 = 5;
+	InteractionEnergyVrna energy( acc1, rAcc2, vrnaHandler, maxLoop1, maxLoop2 );
+
+	SECTION("loop energies identical to E_IntLoop()") {
+
+		vrna_md_t model = vrnaHandler.getModel();
+		vrna_param_t * params = vrna_params( &model );
+
+		const RnaSequence::CodeSeq_type & s1 = rna1.asCodes();
+		const RnaSequence::CodeSeq_type & s2 = rAcc2.getSequence().asCodes();
+
+		size_t validLoops = 0;
+		for (size_t i1=0; i1<rna1.size(); i1++) {
+		for (size_t j1=i1+1; j1<std::min(rna1.size(),i1+maxLoop1+2); j1++) {
+		for (size_t i2=0; i2<rna2.size(); i2++) {
+		for (size_t j2=i2+1; j2<std::min(rna2.size(),i2+maxLoop2+2); j2++) {
+			const E_type loopE = energy.getE_interLeft(i1,j1,i2,j2);
+			// check only valid loops (E_INF otherwise)
+			if (!E_isINF(loopE)) {
+				validLoops++;
+				REQUIRE( loopE == Edcal_2_E( E_IntLoop( (int)j1-i1-1, (int)j2-i2-1
+								, BP_pair[s1[i1]][s2[i2]], BP_pair[s2[j2]][s1[j1]]
+								, s1[i1+1], s2[i2+1], s1[j1-1], s2[j2-1]
+								, params ) ) );
+			}
+		}
+		}
+		}
+		}
+		// ensure loops were checked
+		REQUIRE( validLoops > 0 );
+
+		free(params);
+	}
+
+}
@@ -0,0 +1,186 @@
+
+#include "catch.hpp"
+#include "TestRandom.h"
+
+#undef NDEBUG
+
+#include "IntaRNA/MatrixArena.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/ReverseAccessibility.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/PredictorMfe4d.h"
+#include "IntaRNA/OutputHandler.h"
+
+#include <boost/numeric/ublas/matrix.hpp>
+
+#include <iostream>
+#include <vector>
+#include <ctime>
+
+using namespace IntaRNA;
+
+/**
+ * Dummy output handler storing the energies of all reported interactions
+ */
+class EnergyStore : public OutputHandler {
+public:
+	std::vector<E_type> energies;
+	void add( const Interaction& i ) { energies.push_back( i.energy ); }
+	void add( const InteractionRange& ) {}
+};
+
+TEST_CASE( "MatrixArena", "[MatrixArena]" ) {
+
+	MatrixArena<int> arena(10);
+
+	SECTION("empty arena") {
+		REQUIRE( arena.getMatrixNumber() == 0 );
+		REQUIRE( arena.getSize() == 0 );
+		REQUIRE( arena.getCapacity() == 0 );
+	}
+
+	SECTION("allocation and access") {
+		MatrixArena<int>::Matrix * m1 = arena.allocate(2,3);
+		MatrixArena<int>::Matrix * m2 = arena.allocate(3,2);
+		// exceeds first block
+		MatrixArena<int>::Matrix * m3 = arena.allocate(4,4);
+		REQUIRE( arena.getMatrixNumber() == 3 );
+		REQUIRE( arena.getSize() == 6+6+16 );
+		REQUIRE( arena.getCapacity() >= arena.getSize() );
+		REQUIRE( m1->size1() == 2 );
+		REQUIRE( m1->size2() == 3 );
+		REQUIRE( m2->size1() == 3 );
+		REQUIRE( m2->size2() == 2 );
+		REQUIRE( m3->size1() == 4 );
+		REQUIRE( m3->size2() == 4 );
+
+		// fill all matrices
+		for (size_t i=0; i<m1->size1(); i++) for (size_t j=0; j<m1->size2(); j++) (*m1)(i,j) = 100+i*10+j;
+		for (size_t i=0; i<m2->size1(); i++) for (size_t j=0; j<m2->size2(); j++) (*m2)(i,j) = 200+i*10+j;
+		for (size_t i=0; i<m3->size1(); i++) for (size_t j=0; j<m3->size2(); j++) (*m3)(i,j) = 300+i*10+j;
+		// add further matrices
+		for (size_t k=0; k<50; k++) {
+			arena.allocate(k%5+1,3);
+		}
+		// check matrices are unaltered and not overlapping
+		for (size_t i=0; i<m1->size1(); i++) for (size_t j=0; j<m1->size2(); j++) REQUIRE( (*m1)(i,j) == (int)(100+i*10+j) );
+		for (size_t i=0; i<m2->size1(); i++) for (size_t j=0; j<m2->size2(); j++) REQUIRE( (*m2)(i,j) == (int)(200+i*10+j) );
+		for (size_t i=0; i<m3->size1(); i++) for (size_t j=0; j<m3->size2(); j++) REQUIRE( (*m3)(i,j) == (int)(300+i*10+j) );
+	}
+
+	SECTION("reuse after clear") {
+		MatrixArena<int>::Matrix * first = arena.allocate(1,3);
+		for (size_t k=1; k<50; k++) {
+			arena.allocate(k%5+1,3);
+		}
+		const size_t capacity = arena.getCapacity();
+		arena.clear();
+		REQUIRE( arena.getMatrixNumber() == 0 );
+		REQUIRE( arena.getSize() == 0 );
+		REQUIRE( arena.getCapacity() == capacity );
+		// same allocation sequence needs no further memory and reuses the objects
+		REQUIRE( arena.allocate(1,3) == first );
+		for (size_t k=1; k<50; k++) {
+			arena.allocate(k%5+1,3);
+		}
+		REQUIRE( arena.getCapacity() == capacity );
+	}
+
+}
+
+TEST_CASE( "MatrixArena within PredictorMfe4d", "[MatrixArena]" ) {
+
+	RnaSequence r1("r1","GGGAAACCCAGGUUCCAGAUUGG");
+	RnaSequence r2("r2","CCAAUCUGGAACCUGGGUUUCCC");
+	AccessibilityDisabled acc1(r1, 0, NULL);
+	AccessibilityDisabled acc2(r2, 0, NULL);
+	ReverseAccessibility racc( acc2 );
+	InteractionEnergyBasePair energy( acc1, racc );
+
+	OutputConstraint outConstraint( 3, OutputConstraint::OVERLAP_BOTH );
+
+	// reference from a fresh predictor
+	EnergyStore outRef;
+	{
+		PredictorMfe4d pred( energy, outRef, NULL );
+		pred.predict( IndexRange(0,RnaSequence::lastPos), IndexRange(0,RnaSequence::lastPos), outConstraint );
+	}
+	REQUIRE_FALSE( outRef.energies.empty() );
+
+	// repeated and differently sized predictions reusing the arena
+	EnergyStore out;
+	PredictorMfe4d pred( energy, out, NULL );
+	pred.predict( IndexRange(0,RnaSequence::lastPos), IndexRange(0,RnaSequence::lastPos), outConstraint );
+	pred.predict( IndexRange(2,12), IndexRange(3,15), outConstraint );
+	out.energies.clear();
+	pred.predict( IndexRange(0,RnaSequence::lastPos), IndexRange(0,RnaSequence::lastPos), outConstraint );
+	REQUIRE( out.energies == outRef.energies );
+}
+
+TEST_CASE( "MatrixArena runtime and memory", "[.][perf][MatrixArena]" ) {
+
+	// layout of the 4D matrix for 500x150 inputs with a maximal window width
+	const size_t n1 = 500, n2 = 150, maxW = 16, repeats = 3;
+	std::vector< std::pair<size_t,size_t> > dims;
+	TestRandom random( 13 );
+	for (size_t i1=0; i1<n1; i1++) {
+	for (size_t i2=0; i2<n2; i2++) {
+		// about 3/8 of all start position combinations are complementary
+		if ((random.next()/16) % 8 < 3) {
+			dims.push_back( std::make_pair( std::min(n1-i1,maxW), std::min(n2-i2,maxW) ) );
+		}
+	}
+	}
+
+	typedef boost::numeric::ublas::matrix<E_type> UblasMatrix;
+	size_t elements = 0;
+	for (size_t k=0; k<dims.size(); k++) {
+		elements += dims[k].first*dims[k].second;
+	}
+
+	// allocate, fill and free one ublas matrix per start position combination
+	E_type sumUblas = 0;
+	std::clock_t start = std::clock();
+	for (size_t r=0; r<repeats; r++) {
+		std::vector< UblasMatrix * > matrices( dims.size(), NULL );
+		for (size_t k=0; k<dims.size(); k++) {
+			matrices[k] = new UblasMatrix( dims[k].first, dims[k].second );
+			for (size_t w1=0; w1<dims[k].first; w1++) for (size_t w2=0; w2<dims[k].second; w2++) (*matrices[k])(w1,w2) = E_MAX;
+			(*matrices[k])(0,0) = (E_type)k;
+		}
+		for (size_t k=0; k<dims.size(); k++) {
+			sumUblas += (*matrices[k])(0,0);
+			delete matrices[k];
+		}
+	}
+	const double timeUblas = double(std::clock()-start) / CLOCKS_PER_SEC;
+
+	// same via arena reused among repeats
+	E_type sumArena = 0;
+	MatrixArena<E_type> arena;
+	start = std::clock();
+	for (size_t r=0; r<repeats; r++) {
+		arena.clear();
+		std::vector< MatrixArena<E_type>::Matrix * > matrices( dims.size(), NULL );
+		for (size_t k=0; k<dims.size(); k++) {
+			matrices[k] = arena.allocate( dims[k].first, dims[k].second );
+			for (size_t w1=0; w1<dims[k].first; w1++) for (size_t w2=0; w2<dims[k].second; w2++) (*matrices[k])(w1,w2) = E_MAX;
+			(*matrices[k])(0,0) = (E_type)k;
+		}
+		for (size_t k=0; k<dims.size(); k++) {
+			sumArena += (*matrices[k])(0,0);
+		}
+	}
+	const double timeArena = double(std::clock()-start) / CLOCKS_PER_SEC;
+
+	// memory estimate : data + matrix object (+ allocator bookkeeping for ublas)
+	const size_t memUblas = elements*sizeof(E_type) + dims.size()*(sizeof(UblasMatrix)+2*sizeof(size_t));
+	const size_t memArena = arena.getCapacity()*sizeof(E_type) + dims.size()*sizeof(MatrixArena<E_type>::Matrix);
+
+	std::cout <<"MatrixArena : "<<dims.size()<<" matrices with "<<elements<<" elements"
+			<<" : ublas "<<timeUblas<<"s "<<(memUblas/1024)<<"KiB"
+			<<", arena "<<timeArena<<"s "<<(memArena/1024)<<"KiB"<<std::endl;
+
+	REQUIRE( sumUblas == sumArena );
+	REQUIRE( arena.getMatrixNumber() == dims.size() );
+}
@@ -0,0 +1,162 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/OutputHandlerBinary.h"
+#include "IntaRNA/OutputHandlerCsv.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/AccessibilityFromStream.h"
+
+#include <sstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "OutputHandlerBinary", "[OutputHandlerBinary]" ) {
+
+	RnaSequence r1("r;1","AACCGGUU");
+	RnaSequence r2("r2","AACCGGUUAA");
+	AccessibilityDisabled acc1(r1,r1.size(),NULL);
+	AccessibilityDisabled acc2(r2,r2.size(),NULL);
+	ReverseAccessibility rAcc2(acc2);
+	InteractionEnergyBasePair energy( acc1, rAcc2 );
+
+	// interactions to report
+	std::vector< Interaction > interactions( 3, Interaction(r1,r2) );
+	interactions[0].basePairs.push_back( Interaction::BasePair(0,7) );
+	interactions[0].basePairs.push_back( Interaction::BasePair(1,6) );
+	interactions[0].basePairs.push_back( Interaction::BasePair(3,4) );
+	interactions[0].energy = Ekcal_2_E(-4.2);
+	interactions[0].setSeedRange( Interaction::BasePair(0,7), Interaction::BasePair(1,6), Ekcal_2_E(-1.5) );
+	interactions[1].basePairs.push_back( Interaction::BasePair(4,3) );
+	interactions[1].basePairs.push_back( Interaction::BasePair(5,2) );
+	interactions[1].energy = Ekcal_2_E(-2);
+	interactions[2].basePairs.push_back( Interaction::BasePair(2,5) );
+	interactions[2].energy = Ekcal_2_E(1.37);
+
+	// all columns
+	const OutputHandlerCsv::ColTypeList colOrder = OutputHandlerCsv::string2list("");
+
+	// CSV reference output
+	std::stringstream csvOut;
+	{
+		OutputHandlerCsv csv( csvOut, energy, colOrder, ";", true );
+		for (auto i = interactions.begin(); i != interactions.end(); i++) {
+			csv.add( *i );
+		}
+	}
+
+	SECTION("conversion reproduces CSV output") {
+		// use small blocks to test multiple blocks for one pair
+		for (size_t blockSize = 1; blockSize <= interactions.size()+1; blockSize++) {
+			std::stringstream binOut;
+			binOut <<OutputHandlerBinary::getFileHeader();
+			{
+				OutputHandlerBinary bin( binOut, energy, blockSize );
+				for (auto i = interactions.begin(); i != interactions.end(); i++) {
+					bin.add( *i );
+				}
+			}
+			std::stringstream convOut;
+			REQUIRE( OutputHandlerBinary::writeCsv( binOut, convOut, colOrder, ";", true ) == interactions.size() );
+			REQUIRE( convOut.str() == csvOut.str() );
+		}
+	}
+
+	SECTION("interleaved output of multiple handlers") {
+		std::stringstream binOut;
+		binOut <<OutputHandlerBinary::getFileHeader();
+		{
+			OutputHandlerBinary bin1( binOut, energy, 1 );
+			OutputHandlerBinary bin2( binOut, energy, 1 );
+			bin1.add( interactions[0] );
+			bin2.add( interactions[1] );
+			bin1.add( interactions[2] );
+		}
+		std::stringstream convOut;
+		REQUIRE( OutputHandlerBinary::writeCsv( binOut, convOut, colOrder, ";", false ) == 3 );
+		REQUIRE( convOut.str() == csvOut.str().substr( csvOut.str().find('\n')+1 ) );
+	}
+
+	SECTION("no interactions") {
+		std::stringstream binOut;
+		binOut <<OutputHandlerBinary::getFileHeader();
+		{
+			OutputHandlerBinary bin( binOut, energy );
+		}
+		REQUIRE( binOut.str() == OutputHandlerBinary::getFileHeader() );
+		std::stringstream convOut;
+		REQUIRE( OutputHandlerBinary::writeCsv( binOut, convOut, colOrder, ";", false ) == 0 );
+		REQUIRE( convOut.str().empty() );
+	}
+
+	SECTION("invalid input") {
+		std::stringstream binOut("no binary output");
+		std::stringstream convOut;
+		REQUIRE_THROWS( OutputHandlerBinary::writeCsv( binOut, convOut, colOrder ) );
+	}
+
+}
+
+TEST_CASE( "OutputHandlerBinary lossless energies", "[OutputHandlerBinary]" ) {
+
+	RnaSequence r1("r1","AACCGGUU");
+	RnaSequence r2("r2","AACCGGUUAA");
+
+	// fractional ED values for all windows of r1 (RNAplfold text format)
+	std::stringstream edStream;
+	edStream <<"#unpaired probabilities\n #i$\tl=1";
+	for (size_t l=2; l<=r1.size(); l++) { edStream <<'\t' <<l; }
+	edStream <<"\t\n";
+	for (size_t j=1; j<=r1.size(); j++) {
+		edStream <<j;
+		for (size_t l=1; l<=r1.size(); l++) {
+			if (l <= j) {
+				edStream <<'\t' <<(0.12345*l + 0.03719*j);
+			} else {
+				edStream <<"\tNA";
+			}
+		}
+		edStream <<"\t\n";
+	}
+	AccessibilityFromStream acc1( r1, r1.size(), NULL, edStream, AccessibilityFromStream::ED_RNAplfold_Text, 0.61632 );
+	AccessibilityDisabled acc2(r2,r2.size(),NULL);
+	ReverseAccessibility rAcc2(acc2);
+	InteractionEnergyBasePair energy( acc1, rAcc2 );
+
+	// interactions with energies that are no multiples of 0.01 kcal/mol
+	std::vector< Interaction > interactions( 2, Interaction(r1,r2) );
+	interactions[0].basePairs.push_back( Interaction::BasePair(0,7) );
+	interactions[0].basePairs.push_back( Interaction::BasePair(1,6) );
+	interactions[0].basePairs.push_back( Interaction::BasePair(3,4) );
+	interactions[0].energy = Ekcal_2_E(-4.2137);
+	interactions[0].setSeedRange( Interaction::BasePair(0,7), Interaction::BasePair(1,6), Ekcal_2_E(-1.5071) );
+	interactions[1].basePairs.push_back( Interaction::BasePair(2,5) );
+	interactions[1].energy = Ekcal_2_E(1.3749);
+
+	// all columns
+	const OutputHandlerCsv::ColTypeList colOrder = OutputHandlerCsv::string2list("");
+
+	// CSV reference output
+	std::stringstream csvOut;
+	{
+		OutputHandlerCsv csv( csvOut, energy, colOrder, ";", true );
+		for (auto i = interactions.begin(); i != interactions.end(); i++) {
+			csv.add( *i );
+		}
+	}
+
+	std::stringstream binOut;
+	binOut <<OutputHandlerBinary::getFileHeader();
+	{
+		OutputHandlerBinary bin( binOut, energy );
+		for (auto i = interactions.begin(); i != interactions.end(); i++) {
+			bin.add( *i );
+		}
+	}
+	std::stringstream convOut;
+	REQUIRE( OutputHandlerBinary::writeCsv( binOut, convOut, colOrder, ";", true ) == interactions.size() );
+	REQUIRE( convOut.str() == csvOut.str() );
+
+}
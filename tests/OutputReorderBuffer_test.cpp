@@ -0,0 +1,51 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/OutputReorderBuffer.h"
+
+#include <sstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "OutputReorderBuffer", "[OutputReorderBuffer]" ) {
+
+	std::stringstream out;
+
+	SECTION("window of zero") {
+		REQUIRE_THROWS( OutputReorderBuffer( out, 0 ) );
+	}
+
+	SECTION("ordered output") {
+		OutputReorderBuffer buffer( out, 3 );
+		REQUIRE( buffer.waitForSlot( 0 ) );
+		REQUIRE( buffer.waitForSlot( 2 ) );
+		buffer.add( 2, "c", 1 );
+		buffer.add( 1, "b", 1 );
+		REQUIRE( out.str().empty() );
+		buffer.add( 0, "a", 1 );
+		REQUIRE( out.str() == "abc" );
+		buffer.add( 3, "d", 1 );
+		REQUIRE( out.str() == "abcd" );
+	}
+
+	SECTION("separator output") {
+		OutputReorderBuffer buffer( out, 2 );
+		buffer.add( 1, "b", 1, "|" );
+		buffer.add( 0, "", 0, "|" );
+		buffer.add( 2, "", 0, "|" );
+		buffer.add( 3, "d", 2, "|" );
+		REQUIRE( out.str() == "b|d" );
+	}
+
+	SECTION("abort") {
+		OutputReorderBuffer buffer( out, 1 );
+		buffer.add( 1, "b", 1 );
+		buffer.abort();
+		REQUIRE_FALSE( buffer.waitForSlot( 5 ) );
+		buffer.add( 0, "a", 1 );
+		REQUIRE( out.str().empty() );
+	}
+
+}
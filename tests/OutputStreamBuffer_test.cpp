@@ -0,0 +1,45 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/OutputStreamBuffer.h"
+
+#include <sstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "OutputStreamBuffer", "[OutputStreamBuffer]" ) {
+
+	std::stringstream out;
+
+	SECTION("write on threshold") {
+		OutputStreamBuffer buffer( out, 6 );
+		buffer.getStream() <<"abc";
+		buffer.flushIfFull();
+		REQUIRE( out.str().empty() );
+		buffer.getStream() <<"def";
+		buffer.flushIfFull();
+		REQUIRE( out.str() == "abcdef" );
+		buffer.getStream() <<"g";
+		buffer.flushIfFull();
+		REQUIRE( out.str() == "abcdef" );
+	}
+
+	SECTION("write on destruction") {
+		OutputStreamBuffer * buffer = new OutputStreamBuffer( out );
+		buffer->getStream() <<1.5 <<';' <<2;
+		buffer->flushIfFull();
+		REQUIRE( out.str().empty() );
+		delete buffer;
+		REQUIRE( out.str() == "1.5;2" );
+	}
+
+	SECTION("direct write without threshold") {
+		OutputStreamBuffer buffer( out, 0 );
+		buffer.getStream() <<"abc";
+		buffer.flushIfFull();
+		REQUIRE( out.str() == "abc" );
+	}
+
+}
@@ -0,0 +1,57 @@
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/OutputTopK.h"
+#include "IntaRNA/OutputConstraint.h"
+
+#include <sstream>
+
+using namespace IntaRNA;
+
+TEST_CASE( "OutputTopK", "[OutputTopK]" ) {
+
+	SECTION("k = 0") {
+		REQUIRE_THROWS( OutputTopK(0) );
+	}
+
+	SECTION("keeps the k best outputs") {
+		OutputTopK topK(3);
+		REQUIRE( topK.size() == 0 );
+		REQUIRE( E_isINF(topK.getMaxE()) );
+
+		REQUIRE( topK.add( Ekcal_2_E(-1), "a\n" ) );
+		REQUIRE( topK.add( Ekcal_2_E(-5), "b\n" ) );
+		// not full yet : no bound
+		REQUIRE( E_isINF(topK.getMaxE()) );
+		REQUIRE( topK.add( Ekcal_2_E(-3), "c\n" ) );
+		REQUIRE( topK.size() == 3 );
+		REQUIRE( topK.getMaxE() == Ekcal_2_E(-1) );
+
+		// not better than the worst
+		REQUIRE_FALSE( topK.add( Ekcal_2_E(-1), "d\n" ) );
+		REQUIRE_FALSE( topK.add( Ekcal_2_E(2), "e\n" ) );
+		// replaces the worst
+		REQUIRE( topK.add( Ekcal_2_E(-4), "f\n" ) );
+		REQUIRE( topK.size() == 3 );
+		REQUIRE( topK.getMaxE() == Ekcal_2_E(-3) );
+		REQUIRE( *(topK.getMaxEbound()) == Ekcal_2_E(-3) );
+
+		// sorted output
+		std::stringstream out;
+		topK.write( out, "-\n" );
+		REQUIRE( out.str() == "b\n-\nf\n-\nc\n" );
+	}
+
+	SECTION("bound within output constraint") {
+		OutputTopK topK(1);
+		OutputConstraint outConstr( 1, OutputConstraint::OVERLAP_BOTH, Ekcal_2_E(-2), E_INF, topK.getMaxEbound() );
+		REQUIRE( outConstr.getMaxE() == Ekcal_2_E(-2) );
+		topK.add( Ekcal_2_E(-1), "a" );
+		REQUIRE( outConstr.getMaxE() == Ekcal_2_E(-2) );
+		topK.add( Ekcal_2_E(-7), "b" );
+		REQUIRE( outConstr.getMaxE() == Ekcal_2_E(-7) );
+	}
+
+}
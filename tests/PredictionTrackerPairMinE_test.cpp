@@ -0,0 +1,160 @@
+#include "catch.hpp"
+#include "TestRandom.h"
+
+#undef NDEBUG
+
+#include "IntaRNA/PredictionTrackerPairMinE.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/ReverseAccessibility.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+
+#include <sstream>
+#include <algorithm>
+
+using namespace IntaRNA;
+
+/**
+ * Provides access to the resolved pair data
+ */
+class PredictionTrackerPairMinETest : public PredictionTrackerPairMinE {
+public:
+	typedef PredictionTrackerPairMinE::E2dMatrix E2dMatrix;
+	PredictionTrackerPairMinETest( const InteractionEnergy & energy, std::ostream * out )
+		: PredictionTrackerPairMinE( energy, out )
+	{}
+	const E2dMatrix & getPairMinE() {
+		resolveBlockMinE();
+		return pairMinE;
+	}
+};
+
+TEST_CASE( "PredictionTrackerPairMinE", "[PredictionTrackerPairMinE]" ) {
+
+	// setup dummy data
+	RnaSequence r1("r1","AACCGUGACGGAUC");
+	RnaSequence r2("r2","AGUUCCGAUCGNNN");
+	AccessibilityDisabled acc1(r1, 0, NULL);
+	AccessibilityDisabled acc2(r2, 0, NULL);
+	ReverseAccessibility racc( acc2 );
+	InteractionEnergyBasePair energy( acc1, racc );
+
+	SECTION("empty output") {
+		std::stringstream out;
+		PredictionTrackerPairMinETest tracker( energy, &out );
+		const PredictionTrackerPairMinETest::E2dMatrix & minE = tracker.getPairMinE();
+		for (size_t k1=0; k1<r1.size(); k1++) {
+		for (size_t k2=0; k2<r2.size(); k2++) {
+			REQUIRE( E_isINF( minE(k1,k2) ) );
+		}
+		}
+	}
+
+	SECTION("block minima identical to covered pair update") {
+		std::stringstream out;
+		PredictionTrackerPairMinETest tracker( energy, &out );
+		// expected pair data
+		PredictionTrackerPairMinETest::E2dMatrix expected( r1.size(), r2.size(), E_INF );
+
+		// add ranges of all lengths
+		TestRandom random( 7 );
+		for (size_t u=0; u<200; u++) {
+			const size_t rnd = random.next();
+			const size_t i1 = rnd % r1.size();
+			const size_t j1 = i1 + (rnd/7) % (r1.size()-i1);
+			const size_t i2 = (rnd/131) % r2.size();
+			const size_t j2 = i2 + (rnd/1717) % (r2.size()-i2);
+			const E_type e = Edcal_2_E( (int)((rnd/3) % 1000) - 800 );
+			tracker.updateOptimumCalled( i1, j1, i2, j2, e );
+			for (size_t k1=i1; k1<=j1; k1++) {
+			for (size_t k2=i2; k2<=j2; k2++) {
+				expected(k1,k2) = std::min( expected(k1,k2), e );
+			}
+			}
+		}
+
+		// compare
+		const PredictionTrackerPairMinETest::E2dMatrix & minE = tracker.getPairMinE();
+		for (size_t k1=0; k1<r1.size(); k1++) {
+		for (size_t k2=0; k2<r2.size(); k2++) {
+			REQUIRE( minE(k1,k2) == expected(k1,k2) );
+		}
+		}
+	}
+
+	SECTION("ranges exceeding the maximal block lengths") {
+		// long sequences without length limits
+		TestRandom random( 11 );
+		RnaSequence rL1("rL1",random.nextSequence(70));
+		RnaSequence rL2("rL2",random.nextSequence(45));
+		AccessibilityDisabled accL1(rL1, 0, NULL);
+		AccessibilityDisabled accL2(rL2, 0, NULL);
+		ReverseAccessibility raccL( accL2 );
+		InteractionEnergyBasePair energyL( accL1, raccL );
+		std::stringstream out;
+		PredictionTrackerPairMinETest tracker( energyL, &out );
+		// expected pair data
+		PredictionTrackerPairMinETest::E2dMatrix expected( rL1.size(), rL2.size(), E_INF );
+
+		// add ranges of all lengths
+		for (size_t u=0; u<300; u++) {
+			const size_t rnd = random.next();
+			const size_t i1 = rnd % rL1.size();
+			const size_t j1 = i1 + (rnd/7) % (rL1.size()-i1);
+			const size_t i2 = (rnd/131) % rL2.size();
+			const size_t j2 = i2 + (rnd/1717) % (rL2.size()-i2);
+			const E_type e = Edcal_2_E( (int)((rnd/3) % 1000) - 800 );
+			tracker.updateOptimumCalled( i1, j1, i2, j2, e );
+			for (size_t k1=i1; k1<=j1; k1++) {
+			for (size_t k2=i2; k2<=j2; k2++) {
+				expected(k1,k2) = std::min( expected(k1,k2), e );
+			}
+			}
+		}
+
+		// compare
+		const PredictionTrackerPairMinETest::E2dMatrix & minE = tracker.getPairMinE();
+		for (size_t k1=0; k1<rL1.size(); k1++) {
+		for (size_t k2=0; k2<rL2.size(); k2++) {
+			REQUIRE( minE(k1,k2) == expected(k1,k2) );
+		}
+		}
+	}
+
+	SECTION("ranges exceeding the maximal interaction lengths") {
+		// limited interaction lengths reduce the number of block levels
+		AccessibilityDisabled accL1(r1, 5, NULL);
+		AccessibilityDisabled accL2(r2, 3, NULL);
+		ReverseAccessibility raccL( accL2 );
+		InteractionEnergyBasePair energyL( accL1, raccL );
+		std::stringstream out;
+		PredictionTrackerPairMinETest tracker( energyL, &out );
+		// expected pair data
+		PredictionTrackerPairMinETest::E2dMatrix expected( r1.size(), r2.size(), E_INF );
+
+		// add all ranges (within and beyond the maximal lengths)
+		for (size_t i1=0; i1<r1.size(); i1++) {
+		for (size_t j1=i1; j1<r1.size(); j1++) {
+		for (size_t i2=0; i2<r2.size(); i2++) {
+		for (size_t j2=i2; j2<r2.size(); j2++) {
+			const E_type e = Edcal_2_E( - (int)((i1*7+j1*3+i2*5+j2) % 97) );
+			tracker.updateOptimumCalled( i1, j1, i2, j2, e );
+			for (size_t k1=i1; k1<=j1; k1++) {
+			for (size_t k2=i2; k2<=j2; k2++) {
+				expected(k1,k2) = std::min( expected(k1,k2), e );
+			}
+			}
+		}
+		}
+		}
+		}
+
+		// compare
+		const PredictionTrackerPairMinETest::E2dMatrix & minE = tracker.getPairMinE();
+		for (size_t k1=0; k1<r1.size(); k1++) {
+		for (size_t k2=0; k2<r2.size(); k2++) {
+			REQUIRE( minE(k1,k2) == expected(k1,k2) );
+		}
+		}
+	}
+
+}
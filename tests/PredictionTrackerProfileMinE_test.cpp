@@ -1,5 +1,6 @@
 
 #include "catch.hpp"
+#include "TestRandom.h"
 
 #undef NDEBUG
 
@@ -7,8 +8,13 @@
 #include "IntaRNA/AccessibilityDisabled.h"
 #include "IntaRNA/ReverseAccessibility.h"
 #include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/PredictorMfe2dHeuristic.h"
+#include "IntaRNA/OutputHandler.h"
 
 #include <stdexcept>
+#include <sstream>
+#include <iostream>
+#include <ctime>
 
 using namespace IntaRNA;
 
@@ -47,7 +53,7 @@ TEST_CASE( "PredictionTrackerProfileMinE", "[PredictionTrackerProfileMinE]" ) {
 		// create
 		PredictionTrackerProfileMinE * tracker = new PredictionTrackerProfileMinE( energy, &s1out, &s2out, "X");
 		// add range
-		tracker->updateOptimumCalled( 0,1, 4,5, 2.0 );
+		tracker->updateOptimumCalled( 0,1, 4,5, Ekcal_2_E(2.0) );
 		// destroy to flush output
 		delete tracker; tracker = NULL;
 
@@ -67,8 +73,8 @@ TEST_CASE( "PredictionTrackerProfileMinE", "[PredictionTrackerProfileMinE]" ) {
 		// create
 		PredictionTrackerProfileMinE * tracker = new PredictionTrackerProfileMinE( energy, &s1out, &s2out, "X");
 		// add range
-		tracker->updateOptimumCalled( 0,1, 4,5, 2.0 );
-		tracker->updateOptimumCalled( 1,2, 5,6, 1.0 );
+		tracker->updateOptimumCalled( 0,1, 4,5, Ekcal_2_E(2.0) );
+		tracker->updateOptimumCalled( 1,2, 5,6, Ekcal_2_E(1.0) );
 		// destroy to flush output
 		delete tracker; tracker = NULL;
 
@@ -82,3 +88,97 @@ TEST_CASE( "PredictionTrackerProfileMinE", "[PredictionTrackerProfileMinE]" ) {
 
 
 }
+
+
+/**
+ * Provides access to the profile handling
+ */
+class PredictionTrackerProfileMinETest : public PredictionTrackerProfileMinE {
+public:
+	typedef PredictionTrackerProfileMinE::MinEProfile MinEProfile;
+	static void update( MinEProfile & profile, const size_t i, const size_t j, const E_type E ) {
+		updateProfile( profile, i, j, E );
+	}
+	static void resolve( MinEProfile & profile ) {
+		resolveProfile( profile );
+	}
+};
+
+/**
+ * Dummy output handler ignoring all interactions
+ */
+class OutputIgnore : public OutputHandler {
+public:
+	void add( const Interaction& ) {}
+	void add( const InteractionRange& ) {}
+};
+
+TEST_CASE( "PredictionTrackerProfileMinE range updates", "[PredictionTrackerProfileMinE]" ) {
+
+	SECTION("tree update identical to position-wise update") {
+		// check different sequence lengths (non-power-of-two)
+		for (size_t n=1; n<40; n+=3) {
+			PredictionTrackerProfileMinETest::MinEProfile profile( 2*n, E_INF ), expected( n, E_INF );
+			TestRandom random( n );
+			for (size_t u=0; u<50; u++) {
+				const size_t rnd = random.next();
+				const size_t i = rnd % n;
+				const size_t j = i + (rnd/7) % (n-i);
+				const E_type e = Edcal_2_E( (int)((rnd/3) % 1000) - 800 );
+				PredictionTrackerProfileMinETest::update( profile, i, j, e );
+				for (size_t k=i; k<=j; k++) {
+					expected[k] = std::min( expected[k], e );
+				}
+			}
+			PredictionTrackerProfileMinETest::resolve( profile );
+			for (size_t k=0; k<n; k++) {
+				REQUIRE( profile[n+k] == expected[k] );
+			}
+		}
+	}
+
+}
+
+
+TEST_CASE( "PredictionTrackerProfileMinE runtime", "[.][perf][PredictionTrackerProfileMinE]" ) {
+
+	// random sequences
+	std::string seq1, seq2;
+	TestRandom random( 13 );
+	for (size_t i=0; i<3000; i++) {
+		const size_t rnd = random.next();
+		seq1 += "ACGU"[(rnd/16) % 4];
+		if (i<150) {
+			seq2 += "ACGU"[(rnd/64) % 4];
+		}
+	}
+	RnaSequence r1("r1",seq1);
+	RnaSequence r2("r2",seq2);
+	AccessibilityDisabled acc1(r1, 0, NULL);
+	AccessibilityDisabled acc2(r2, 0, NULL);
+	ReverseAccessibility racc( acc2 );
+	InteractionEnergyBasePair energy( acc1, racc );
+	OutputIgnore out;
+
+	// prediction without profile tracking
+	std::clock_t start = std::clock();
+	{
+		PredictorMfe2dHeuristic pred( energy, out, NULL );
+		pred.predict();
+	}
+	const double timeNoTracking = double(std::clock()-start) / CLOCKS_PER_SEC;
+
+	// prediction with profile tracking for both sequences
+	std::stringstream s1out, s2out;
+	start = std::clock();
+	{
+		PredictorMfe2dHeuristic pred( energy, out, new PredictionTrackerProfileMinE( energy, &s1out, &s2out ) );
+		pred.predict();
+	}
+	const double timeTracking = double(std::clock()-start) / CLOCKS_PER_SEC;
+
+	std::cout <<"PredictionTrackerProfileMinE runtime : without tracking "<<timeNoTracking<<"s"
+			<<", with tracking "<<timeTracking<<"s"<<std::endl;
+	// profile tracking should not dominate the prediction
+	REQUIRE( timeTracking < 1.5*timeNoTracking );
+}
@@ -0,0 +1,232 @@
+
+#include "catch.hpp"
+#include "TestRandom.h"
+
+#undef NDEBUG
+
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/ReverseAccessibility.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+#include "IntaRNA/PredictorMfe4d.h"
+#include "IntaRNA/PredictorMfe4dSeed.h"
+#include "IntaRNA/PredictorMfe2dHeuristic.h"
+#include "IntaRNA/PredictorMfe2dHeuristicSeed.h"
+#include "IntaRNA/PredictorMfe2d.h"
+#include "IntaRNA/PredictorMfe2dSeed.h"
+#include "IntaRNA/OutputHandler.h"
+
+#include <string>
+#include <vector>
+
+using namespace IntaRNA;
+
+/**
+ * Dummy output handler storing the boundaries and energies of all reported
+ * interactions
+ */
+class BoundaryStore : public OutputHandler {
+public:
+	//! energy, left-most and right-most base pair of each reported interaction
+	std::vector< std::pair< E_type, std::pair< Interaction::BasePair, Interaction::BasePair > > > reported;
+	void add( const Interaction& i ) {
+		if (i.isEmpty()) return;
+		reported.push_back( std::make_pair( i.energy, std::make_pair( i.basePairs.front(), i.basePairs.back() ) ) );
+	}
+	void add( const InteractionRange& ) {}
+};
+
+/**
+ * PredictorMfe4d using an exhaustive matrix scan for each next best interaction
+ */
+class PredictorMfe4dScan : public PredictorMfe4d {
+public:
+	PredictorMfe4dScan( const InteractionEnergy & energy, OutputHandler & output )
+	 : PredictorMfe4d( energy, output, NULL ) {}
+protected:
+	void getNextBest( Interaction & curBest ) {
+		const E_type curBestE = curBest.energy;
+		curBest.energy = E_INF;
+		curBest.basePairs.resize(2);
+		for (size_t i1=hybridE.size1(); i1-- > 0;) {
+		for (size_t i2=hybridE.size2(); i2-- > 0;) {
+			if (hybridE(i1,i2) == NULL) continue;
+			const E2dMatrix & table = *hybridE(i1,i2);
+			for (size_t w1=0; w1<table.size1(); w1++) {
+			for (size_t w2=0; w2<table.size2(); w2++) {
+				if (reportedInteractions.first.overlaps(IndexRange(i1,i1+w1))
+					|| reportedInteractions.second.overlaps(IndexRange(i2,i2+w2)))
+				{
+					continue;
+				}
+				const E_type curE = energy.getE( i1, i1+w1, i2, i2+w2, table(w1,w2) );
+				if (curE < curBestE || curE >= curBest.energy) continue;
+				curBest.energy = curE;
+				curBest.basePairs[0] = energy.getBasePair( i1, i2 );
+				curBest.basePairs[1] = energy.getBasePair( i1+w1, i2+w2 );
+			}
+			}
+		}
+		}
+	}
+};
+
+/**
+ * PredictorMfe2dHeuristic using an exhaustive matrix scan for each next best
+ * interaction
+ */
+class PredictorMfe2dHeuristicScan : public PredictorMfe2dHeuristic {
+public:
+	PredictorMfe2dHeuristicScan( const InteractionEnergy & energy, OutputHandler & output )
+	 : PredictorMfe2dHeuristic( energy, output, NULL ) {}
+protected:
+	void getNextBest( Interaction & curBest ) {
+		const E_type curBestE = curBest.energy;
+		curBest.energy = E_INF;
+		curBest.basePairs.resize(2);
+		for (size_t i1=hybridE.size1(); i1-- > 0;) {
+		for (size_t i2=hybridE.size2(); i2-- > 0;) {
+			const BestInteraction & cell = hybridE(i1,i2);
+			if (E_isINF(cell.E)
+				|| reportedInteractions.first.overlaps(IndexRange(i1,cell.j1))
+				|| reportedInteractions.second.overlaps(IndexRange(i2,cell.j2)))
+			{
+				continue;
+			}
+			const E_type curE = energy.getE( i1, cell.j1, i2, cell.j2, cell.E );
+			if (curE < curBestE || curE >= curBest.energy) continue;
+			curBest.energy = curE;
+			curBest.basePairs[0] = energy.getBasePair( i1, i2 );
+			curBest.basePairs[1] = energy.getBasePair( cell.j1, cell.j2 );
+		}
+		}
+	}
+};
+
+/**
+ * Checks that reported interactions are sorted by energy and do not overlap
+ * according to the given constraint
+ */
+void
+checkNonOverlapping( const BoundaryStore & out, const OutputConstraint::ReportOverlap overlap )
+{
+	for (size_t a=0; a<out.reported.size(); a++) {
+		for (size_t b=a+1; b<out.reported.size(); b++) {
+			REQUIRE( out.reported.at(a).first <= out.reported.at(b).first );
+			const IndexRange a1( out.reported.at(a).second.first.first, out.reported.at(a).second.second.first );
+			const IndexRange b1( out.reported.at(b).second.first.first, out.reported.at(b).second.second.first );
+			// seq2 indices are decreasing
+			const IndexRange a2( out.reported.at(a).second.second.second, out.reported.at(a).second.first.second );
+			const IndexRange b2( out.reported.at(b).second.second.second, out.reported.at(b).second.first.second );
+			const bool overlap1 = !(a1.to < b1.from || b1.to < a1.from);
+			const bool overlap2 = !(a2.to < b2.from || b2.to < a2.from);
+			switch (overlap) {
+			case OutputConstraint::OVERLAP_SEQ1 : REQUIRE_FALSE( overlap2 ); break;
+			case OutputConstraint::OVERLAP_SEQ2 : REQUIRE_FALSE( overlap1 ); break;
+			case OutputConstraint::OVERLAP_NONE : REQUIRE_FALSE( overlap1 ); REQUIRE_FALSE( overlap2 ); break;
+			default : break;
+			}
+		}
+	}
+}
+
+TEST_CASE( "PredictorMfe", "[PredictorMfe]" ) {
+
+	// random sequences
+	TestRandom rnd( 1 );
+	std::string s1, s2;
+	for (size_t i=0; i<40; i++) {
+		s1.push_back( rnd.nextChar( "ACGU" ) );
+		s2.push_back( rnd.nextChar( "ACGU" ) );
+	}
+	RnaSequence r1("r1",s1);
+	RnaSequence r2("r2",s2);
+	AccessibilityDisabled acc1(r1, 15, NULL);
+	AccessibilityDisabled acc2(r2, 15, NULL);
+	ReverseAccessibility racc( acc2 );
+	InteractionEnergyBasePair energy( acc1, racc, 3, 3 );
+
+	SeedConstraint sc( 3, 1, 1, 1, 0, E_INF, IndexRangeList(), IndexRangeList() );
+
+	const OutputConstraint::ReportOverlap overlaps[] = { OutputConstraint::OVERLAP_NONE, OutputConstraint::OVERLAP_SEQ1, OutputConstraint::OVERLAP_SEQ2 };
+
+	for (size_t o=0; o<3; o++) {
+		OutputConstraint outConstraint( 30, overlaps[o] );
+
+		SECTION("next best via candidate heap equals matrix scan : 4d "+toString(o)) {
+			BoundaryStore out, outScan;
+			PredictorMfe4d pred( energy, out, NULL );
+			PredictorMfe4dScan predScan( energy, outScan );
+			// repeated prediction to check the reset of the candidates
+			pred.predict( IndexRange(2,30), IndexRange(5,35), outConstraint );
+			out.reported.clear();
+			pred.predict( IndexRange(0,RnaSequence::lastPos), IndexRange(0,RnaSequence::lastPos), outConstraint );
+			predScan.predict( IndexRange(0,RnaSequence::lastPos), IndexRange(0,RnaSequence::lastPos), outConstraint );
+			REQUIRE( out.reported.size() > 1 );
+			REQUIRE( out.reported == outScan.reported );
+			checkNonOverlapping( out, overlaps[o] );
+		}
+
+		SECTION("next best via candidate heap equals matrix scan : 2d heuristic "+toString(o)) {
+			BoundaryStore out, outScan;
+			PredictorMfe2dHeuristic pred( energy, out, NULL );
+			PredictorMfe2dHeuristicScan predScan( energy, outScan );
+			pred.predict( IndexRange(0,RnaSequence::lastPos), IndexRange(0,RnaSequence::lastPos), outConstraint );
+			predScan.predict( IndexRange(0,RnaSequence::lastPos), IndexRange(0,RnaSequence::lastPos), outConstraint );
+			REQUIRE( out.reported.size() > 1 );
+			REQUIRE( out.reported == outScan.reported );
+			checkNonOverlapping( out, overlaps[o] );
+		}
+
+		SECTION("non-overlapping seed interactions "+toString(o)) {
+			BoundaryStore out4d, out2d;
+			PredictorMfe4dSeed pred4d( energy, out4d, NULL, sc );
+			PredictorMfe2dHeuristicSeed pred2d( energy, out2d, NULL, sc );
+			pred4d.predict( IndexRange(0,RnaSequence::lastPos), IndexRange(0,RnaSequence::lastPos), outConstraint );
+			pred2d.predict( IndexRange(0,RnaSequence::lastPos), IndexRange(0,RnaSequence::lastPos), outConstraint );
+			REQUIRE_FALSE( out4d.reported.empty() );
+			REQUIRE_FALSE( out2d.reported.empty() );
+			checkNonOverlapping( out4d, overlaps[o] );
+			checkNonOverlapping( out2d, overlaps[o] );
+		}
+	}
+
+}
+
+TEST_CASE( "PredictorMfe threads", "[PredictorMfe]" ) {
+
+	// random sequences
+	TestRandom rnd( 5 );
+	RnaSequence r1("r1",rnd.nextSequence(60));
+	RnaSequence r2("r2",rnd.nextSequence(50));
+	AccessibilityDisabled acc1(r1, 0, NULL);
+	AccessibilityDisabled acc2(r2, 0, NULL);
+	ReverseAccessibility racc( acc2 );
+	InteractionEnergyBasePair energy( acc1, racc, 3, 3 );
+
+	SeedConstraint sc( 3, 1, 1, 1, 0, E_INF, IndexRangeList(), IndexRangeList() );
+	OutputConstraint outConstraint( 20, OutputConstraint::OVERLAP_BOTH );
+
+	// the results of predictors using multiple threads
+	// have to be identical to the single-threaded results
+	for (size_t p=0; p<4; p++) {
+	SECTION("results independent of the thread number : predictor "+toString(p)) {
+		BoundaryStore out[2];
+		const size_t threads[] = { 1, 4 };
+		for (size_t t=0; t<2; t++) {
+			Predictor * pred = NULL;
+			switch (p) {
+			case 0 : pred = new PredictorMfe2d( energy, out[t], NULL ); break;
+			case 1 : pred = new PredictorMfe2dSeed( energy, out[t], NULL, sc ); break;
+			case 2 : pred = new PredictorMfe2dHeuristic( energy, out[t], NULL ); break;
+			case 3 : pred = new PredictorMfe2dHeuristicSeed( energy, out[t], NULL, sc ); break;
+			}
+			pred->setThreads( threads[t] );
+			pred->predict( IndexRange(0,RnaSequence::lastPos), IndexRange(0,RnaSequence::lastPos), outConstraint );
+			delete pred;
+		}
+		REQUIRE_FALSE( out[0].reported.empty() );
+		REQUIRE( out[0].reported == out[1].reported );
+	}
+	}
+
+}
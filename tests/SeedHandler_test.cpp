@@ -0,0 +1,146 @@
+
+#include "catch.hpp"
+#include "TestRandom.h"
+
+#undef NDEBUG
+
+#include "IntaRNA/SeedHandler.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/ReverseAccessibility.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+
+#include <string>
+#include <cstdlib>
+
+using namespace IntaRNA;
+
+/**
+ * Exhaustive (memory-free) computation of the minimal hybridization energy of
+ * all seeds with left-most base pair (i1,i2) and right-most base pair
+ * (i1+bpIn+1+u1,i2+bpIn+1+u2) with bpIn+2 base pairs
+ */
+E_type
+getSeedE_exhaustive( const InteractionEnergy & energy, const SeedConstraint & sc
+		, const size_t i1, const size_t i2, const size_t bpIn, const size_t u1, const size_t u2 )
+{
+	const size_t j1 = i1+bpIn+1+u1, j2 = i2+bpIn+1+u2;
+	if (j1 >= energy.size1() || j2 >= energy.size2() || !energy.areComplementary(j1,j2)) {
+		return E_INF;
+	}
+	if (bpIn == 0) {
+		return energy.getE_interLeft(i1,j1,i2,j2);
+	}
+	E_type minE = E_INF;
+	for (size_t u1p=0; u1p<=std::min(u1,energy.getMaxInternalLoopSize1()); u1p++) {
+	for (size_t u2p=0; u2p<=std::min(u2,energy.getMaxInternalLoopSize2()); u2p++) {
+		const size_t k1 = i1+u1p+1, k2 = i2+u2p+1;
+		if (!energy.areComplementary(k1,k2)) {
+			continue;
+		}
+		const E_type restE = getSeedE_exhaustive( energy, sc, k1, k2, bpIn-1, u1-u1p, u2-u2p );
+		if (E_isNotINF(restE)) {
+			minE = std::min( minE, energy.getE_interLeft(i1,k1,i2,k2) + restE );
+		}
+	}
+	}
+	return minE;
+}
+
+TEST_CASE( "SeedHandler", "[SeedHandler]" ) {
+
+	// random sequences
+	TestRandom rnd( 17 );
+	std::string s1, s2;
+	// seq2 spans multiple blocks of the seed masks
+	for (size_t i=0; i<150; i++) {
+		const char c1 = rnd.nextChar( "ACGU" );
+		if (i < 45) s1.push_back( c1 );
+		s2.push_back( rnd.nextChar( "ACGU" ) );
+	}
+	RnaSequence r1("r1",s1);
+	RnaSequence r2("r2",s2);
+	AccessibilityDisabled acc1(r1, 0, NULL);
+	AccessibilityDisabled acc2(r2, 0, NULL);
+	ReverseAccessibility racc( acc2 );
+	InteractionEnergyBasePair energy( acc1, racc, 2, 2 );
+
+	// seed constraints to test : bp, maxUnpairedOverall, maxUnpaired1, maxUnpaired2
+	const size_t constraints[][4] = { {3,0,0,0}, {4,2,1,1}, {5,3,2,2}, {4,2,2,0}, {3,3,0,3} };
+
+	for (size_t c=0; c<5; c++) {
+		SeedConstraint sc( constraints[c][0], constraints[c][1], constraints[c][2], constraints[c][3]
+					, 0, E_INF, IndexRangeList(), IndexRangeList() );
+		SeedHandler sh( energy, sc );
+
+		// full and restricted index ranges
+		const size_t ranges[][4] = { {0,energy.size1()-1,0,energy.size2()-1}, {5,30,3,25}, {2,40,60,140} };
+		for (size_t r=0; r<3; r++) {
+			const size_t i1min = ranges[r][0], i1max = ranges[r][1], i2min = ranges[r][2], i2max = ranges[r][3];
+			const size_t seedNumber = sh.fillSeed( i1min, i1max, i2min, i2max );
+
+			size_t seedCount = 0;
+			for (size_t i1=i1min; i1<=i1max; i1++) {
+			for (size_t i2=i2min; i2<=i2max; i2++) {
+
+				// exhaustive reference : mfe seed at (i1,i2) within ranges
+				const size_t bpIn = sc.getBasePairs()-2;
+				E_type bestE = E_INF, bestSeedE = E_INF;
+				size_t bestU1 = 0, bestU2 = 0;
+				if (energy.areComplementary(i1,i2)) {
+					for (size_t u1=0; u1<=sc.getMaxUnpaired1(); u1++) {
+					for (size_t u2=0; u2<=sc.getMaxUnpaired2() && u1+u2<=sc.getMaxUnpairedOverall(); u2++) {
+						const size_t j1 = i1+bpIn+1+u1, j2 = i2+bpIn+1+u2;
+						if (j1 > i1max || j2 > i2max) {
+							continue;
+						}
+						const E_type seedE = getSeedE_exhaustive( energy, sc, i1, i2, bpIn, u1, u2 );
+						if (E_isINF(seedE)) {
+							continue;
+						}
+						const E_type curE = energy.getE( i1, j1, i2, j2, seedE ) + energy.getE_init();
+						if (curE < bestE) {
+							bestE = curE;
+							bestSeedE = seedE;
+							bestU1 = u1;
+							bestU2 = u2;
+						}
+					}
+					}
+				}
+				if (E_isNotINF(bestE) && bestE > sc.getMaxE()) {
+					bestSeedE = E_INF;
+				}
+
+				// compare
+				REQUIRE( sh.getSeedE(i1,i2) == bestSeedE );
+				if (E_isINF(bestSeedE)) {
+					REQUIRE( sh.getSeedLength1(i1,i2) == 0 );
+					REQUIRE( sh.getSeedLength2(i1,i2) == 0 );
+					continue;
+				}
+				seedCount++;
+				REQUIRE( sh.getSeedLength1(i1,i2) == bpIn+2+bestU1 );
+				REQUIRE( sh.getSeedLength2(i1,i2) == bpIn+2+bestU2 );
+
+				// traceback : inner base pairs have to reproduce the seed energy
+				Interaction interaction( r1, r2 );
+				sh.traceBackSeed( interaction, i1, i2 );
+				REQUIRE( interaction.basePairs.size() == sc.getBasePairs()-2 );
+				size_t l1 = i1, l2 = i2;
+				E_type traceE = 0;
+				for (size_t b=0; b<=interaction.basePairs.size(); b++) {
+					const size_t k1 = b < interaction.basePairs.size() ? energy.getIndex1(interaction.basePairs.at(b)) : i1+sh.getSeedLength1(i1,i2)-1;
+					const size_t k2 = b < interaction.basePairs.size() ? energy.getIndex2(interaction.basePairs.at(b)) : i2+sh.getSeedLength2(i1,i2)-1;
+					REQUIRE( k1 > l1 );
+					REQUIRE( k2 > l2 );
+					traceE += energy.getE_interLeft(l1,k1,l2,k2);
+					l1 = k1;
+					l2 = k2;
+				}
+				REQUIRE( E_equal( traceE, bestSeedE ) );
+			}
+			}
+			REQUIRE( seedCount == seedNumber );
+		}
+	}
+}
@@ -0,0 +1,136 @@
+
+#include "catch.hpp"
+#include "TestRandom.h"
+
+#undef NDEBUG
+
+#include "IntaRNA/SeedKmerIndex.h"
+#include "IntaRNA/SeedHandler.h"
+#include "IntaRNA/AccessibilityDisabled.h"
+#include "IntaRNA/ReverseAccessibility.h"
+#include "IntaRNA/InteractionEnergyBasePair.h"
+
+#include <string>
+#include <vector>
+#include <algorithm>
+
+using namespace IntaRNA;
+
+TEST_CASE( "SeedKmerIndex", "[SeedKmerIndex]" ) {
+
+	SECTION("helix length") {
+		// no unpaired : full seed
+		REQUIRE( SeedKmerIndex::getHelixLength( 7, 0, 0, 0 ) == 7 );
+		REQUIRE( SeedKmerIndex::getHelixLength( 2, 0, 0, 0 ) == 2 );
+		// one loop splits the stackings
+		REQUIRE( SeedKmerIndex::getHelixLength( 7, 1, 1, 1 ) == 4 );
+		REQUIRE( SeedKmerIndex::getHelixLength( 6, 1, 1, 1 ) == 3 );
+		// number of loops bounded by per-sequence maxima
+		REQUIRE( SeedKmerIndex::getHelixLength( 7, 5, 1, 0 ) == 4 );
+		REQUIRE( SeedKmerIndex::getHelixLength( 7, 2, 2, 2 ) == 3 );
+		// number of loops bounded by seed length
+		REQUIRE( SeedKmerIndex::getHelixLength( 3, 5, 5, 5 ) == 1 );
+	}
+
+	TestRandom rnd( 7 );
+	std::vector< RnaSequence > targets;
+	targets.push_back( RnaSequence("t1", rnd.nextSequence( 150, "ACGU" ) ) );
+	targets.push_back( RnaSequence("t2", rnd.nextSequence( 3, "ACGU" ) ) );
+	targets.push_back( RnaSequence("t3", rnd.nextSequence( 200, "ACGUACGUACGUN" ) ) );
+	RnaSequence query("q", rnd.nextSequence( 40, "ACGUACGUACGUN" ));
+
+	SECTION("hits versus exhaustive search") {
+		for (size_t k=1; k<=6; k++) {
+			SeedKmerIndex index( targets, k );
+			REQUIRE( index.getK() == k );
+			REQUIRE( index.size() == targets.size() );
+
+			const IndexRangeList queryRanges[] = { IndexRangeList(), IndexRangeList("3-20,25-30") };
+			for (size_t r=0; r<2; r++) {
+				std::vector< std::vector<size_t> > hits;
+				index.getHits( query, queryRanges[r], hits );
+				REQUIRE( hits.size() == targets.size() );
+				for (size_t t=0; t<targets.size(); t++) {
+					std::vector<size_t> hitsExpected;
+					for (size_t i=0; i+k <= targets.at(t).size(); i++) {
+						bool isHit = false;
+						for (size_t j=0; !isHit && j+k <= query.size(); j++) {
+							if (!queryRanges[r].empty() && !queryRanges[r].covers(j,j+k-1)) {
+								continue;
+							}
+							isHit = true;
+							for (size_t x=0; isHit && x<k; x++) {
+								isHit = RnaSequence::areComplementary( targets.at(t), query, i+x, j+k-1-x );
+							}
+						}
+						if (isHit) {
+							hitsExpected.push_back(i);
+						}
+					}
+					REQUIRE( hits.at(t) == hitsExpected );
+				}
+			}
+		}
+	}
+
+	SECTION("windows") {
+		SeedKmerIndex index( targets, 3 );
+		std::vector< std::vector<size_t> > hits;
+		index.getHits( query, IndexRangeList(), hits );
+		std::vector< IndexRangeList > windows;
+		const size_t flank = 5;
+		index.getWindows( query, IndexRangeList(), flank, windows );
+		REQUIRE( windows.size() == targets.size() );
+		for (size_t t=0; t<targets.size(); t++) {
+			REQUIRE( windows.at(t).empty() == hits.at(t).empty() );
+			// each extended hit is covered
+			for (size_t h=0; h<hits.at(t).size(); h++) {
+				const size_t from = hits.at(t).at(h) > flank ? hits.at(t).at(h)-flank : 0;
+				const size_t to = std::min( targets.at(t).size()-1, hits.at(t).at(h)+3-1+flank );
+				REQUIRE( windows.at(t).covers( from, to ) );
+			}
+			// windows are separated and contain hits only
+			for (IndexRangeList::const_iterator w = windows.at(t).begin(); w != windows.at(t).end(); w++) {
+				REQUIRE( w->to < targets.at(t).size() );
+				if (w != windows.at(t).begin()) {
+					REQUIRE( (w-1)->to+1 < w->from );
+				}
+			}
+		}
+	}
+
+	SECTION("all seeds are covered by hits") {
+		const RnaSequence & target = targets.at(0);
+		AccessibilityDisabled acc1(target, 0, NULL);
+		AccessibilityDisabled acc2(query, 0, NULL);
+		ReverseAccessibility racc( acc2 );
+		InteractionEnergyBasePair energy( acc1, racc, 3, 3 );
+
+		// seed constraints to test : bp, maxUnpairedOverall, maxUnpaired1, maxUnpaired2
+		const size_t constraints[][4] = { {4,0,0,0}, {5,1,1,1}, {6,2,2,2}, {5,2,0,2} };
+		for (size_t c=0; c<4; c++) {
+			SeedConstraint sc( constraints[c][0], constraints[c][1], constraints[c][2], constraints[c][3]
+						, 0, E_INF, IndexRangeList(), IndexRangeList() );
+			const size_t k = SeedKmerIndex::getHelixLength( sc.getBasePairs(), sc.getMaxUnpairedOverall(), sc.getMaxUnpaired1(), sc.getMaxUnpaired2() );
+			SeedKmerIndex index( std::vector<RnaSequence>(1,target), k );
+			std::vector< std::vector<size_t> > hits;
+			index.getHits( query, IndexRangeList(), hits );
+
+			SeedHandler sh( energy, sc );
+			REQUIRE( sh.fillSeed( 0, energy.size1()-1, 0, energy.size2()-1 ) > 0 );
+			for (size_t i1=0; i1<energy.size1(); i1++) {
+			for (size_t i2=0; i2<energy.size2(); i2++) {
+				if (E_isINF( sh.getSeedE(i1,i2) )) {
+					continue;
+				}
+				// a hit has to be within the seed's target region
+				const size_t j1 = i1+sh.getSeedLength1(i1,i2)-1;
+				std::vector<size_t>::const_iterator h = std::lower_bound( hits.at(0).begin(), hits.at(0).end(), i1 );
+				REQUIRE( h != hits.at(0).end() );
+				REQUIRE( *h+k-1 <= j1 );
+			}
+			}
+		}
+	}
+
+}
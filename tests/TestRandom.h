@@ -0,0 +1,70 @@
+#ifndef INTARNA_TESTS_TESTRANDOM_H_
+#define INTARNA_TESTS_TESTRANDOM_H_
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Deterministic pseudo random number generator (linear congruential
+ * generator) to create reproducible test data independently of the
+ * std::rand() implementation of the platform.
+ */
+class TestRandom {
+
+public:
+
+	/**
+	 * Construction
+	 * @param seed the initial state of the generator
+	 */
+	TestRandom( const size_t seed )
+	 : state(seed)
+	{}
+
+	/**
+	 * Provides the next pseudo random number
+	 * @return the next number within [0,2^31)
+	 */
+	size_t
+	next()
+	{
+		state = (state * 1103515245 + 12345) % 2147483648;
+		return state;
+	}
+
+	/**
+	 * Provides the next pseudo random character of the given alphabet
+	 * @param alphabet the characters to choose from (non-empty)
+	 * @return the next character
+	 */
+	char
+	nextChar( const std::string & alphabet )
+	{
+		return alphabet.at( (next()/16) % alphabet.size() );
+	}
+
+	/**
+	 * Provides a pseudo random sequence of the given alphabet
+	 * @param length the length of the sequence
+	 * @param alphabet the characters to choose from (non-empty)
+	 * @return the sequence
+	 */
+	std::string
+	nextSequence( const size_t length, const std::string & alphabet = "ACGU" )
+	{
+		std::string seq;
+		seq.reserve( length );
+		for (size_t i=0; i<length; i++) {
+			seq.push_back( nextChar( alphabet ) );
+		}
+		return seq;
+	}
+
+protected:
+
+	//! the current state of the generator
+	size_t state;
+
+};
+
+#endif /* INTARNA_TESTS_TESTRANDOM_H_ */
@@ -0,0 +1,64 @@
+
+
+#include "catch.hpp"
+
+#undef NDEBUG
+
+#include "IntaRNA/VectorizedEnergyMin.h"
+
+#include <vector>
+
+using namespace IntaRNA;
+
+TEST_CASE( "VectorizedEnergyMin", "[VectorizedEnergyMin]" ) {
+
+	// energy arrays with E_INF entries
+	const size_t n = 21;
+	std::vector<E_type> e1(n), e2(n);
+	for (size_t k=0; k<n; k++) {
+		e1[k] = (k % 5 == 1) ? E_INF : Edcal_2_E( 37*((int)(k*k) % 23) - 400 );
+		e2[k] = (k % 7 == 3) ? E_INF : Edcal_2_E( 53*((int)(k*3) % 11) - 200 );
+	}
+
+	// implementations to test
+	std::vector<VectorizedEnergyMin::InstructionSet> sets;
+	sets.push_back( VectorizedEnergyMin::SCALAR );
+	sets.push_back( VectorizedEnergyMin::SSE41 );
+	sets.push_back( VectorizedEnergyMin::AVX2 );
+
+	SECTION("scalar always supported") {
+		REQUIRE( VectorizedEnergyMin::isSupported( VectorizedEnergyMin::SCALAR ) );
+		REQUIRE( VectorizedEnergyMin::isSupported( VectorizedEnergyMin::getInstructionSet() ) );
+	}
+
+	SECTION("all implementations identical to sequential minimization") {
+		for (size_t s=0; s<sets.size(); s++) {
+			if (!VectorizedEnergyMin::isSupported(sets.at(s))) {
+				continue;
+			}
+			// check all prefix lengths to cover remainder handling
+			for (size_t len=0; len<=n; len++) {
+				E_type minE = Edcal_2_E( 100 );
+				for (size_t k=0; k<len; k++) {
+					if (E_isNotINF(e1[k]) && E_isNotINF(e2[k])) {
+						minE = std::min( minE, e1[k]+e2[k] );
+					}
+				}
+				REQUIRE( VectorizedEnergyMin::getMinSum( sets.at(s), &(e1[0]), &(e2[0]), len, Edcal_2_E( 100 ) ) == minE );
+				REQUIRE( VectorizedEnergyMin::getMinSum( &(e1[0]), &(e2[0]), len, Edcal_2_E( 100 ) ) == minE );
+			}
+		}
+	}
+
+	SECTION("sums involving E_INF are detected as E_INF") {
+		std::vector<E_type> inf(n,E_INF);
+		for (size_t s=0; s<sets.size(); s++) {
+			if (!VectorizedEnergyMin::isSupported(sets.at(s))) {
+				continue;
+			}
+			REQUIRE( E_isINF( VectorizedEnergyMin::getMinSum( sets.at(s), &(inf[0]), &(inf[0]), n, E_INF ) ) );
+			REQUIRE( E_isINF( VectorizedEnergyMin::getMinSum( sets.at(s), &(inf[0]), &(e2[0]), n, E_INF ) ) );
+		}
+	}
+
+}